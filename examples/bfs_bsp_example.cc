@@ -0,0 +1,84 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+
+#include "config.h"
+#include "gar/engine/bsp_engine.h"
+#include "gar/graph_info.h"
+
+int main(int argc, char* argv[]) {
+  // read file and construct graph info
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+
+  // load the out-going and incoming edges into the engine
+  std::string label = "person", edge_label = "knows";
+  auto maybe_engine = GAR_NAMESPACE::engine::BSPEngine::Make(
+      graph_info, label, edge_label, label);
+  assert(!maybe_engine.has_error());
+  auto engine = maybe_engine.value();
+  GAR_NAMESPACE::IdType num_vertices = engine->GetVertexNum();
+  std::cout << "num_vertices: " << num_vertices << std::endl;
+
+  // run bfs algorithm, pushing from a sparse frontier and pulling into the
+  // unvisited vertices once the frontier is dense
+  GAR_NAMESPACE::IdType root = 0;
+  GAR_NAMESPACE::engine::VertexState<int32_t> distance(num_vertices, -1);
+  distance.Set(root, 0);
+  distance.SetNext(root, 0);
+  GAR_NAMESPACE::engine::Frontier frontier(num_vertices);
+  frontier.Add(root);
+  for (int iter = 0; !frontier.Empty(); iter++) {
+    GAR_NAMESPACE::engine::Frontier next(num_vertices);
+    auto status = engine->EdgeMap(
+        frontier,
+        [&](GAR_NAMESPACE::IdType src, GAR_NAMESPACE::IdType dst) {
+          return distance.CompareAndSetNext(dst, -1, iter + 1);
+        },
+        [&](GAR_NAMESPACE::IdType dst) { return distance.GetNext(dst) == -1; },
+        &next);
+    assert(status.ok());
+    status = engine->ForEachVertex([&](GAR_NAMESPACE::IdType vid) {
+      distance.Set(vid, distance.GetNext(vid));
+    });
+    assert(status.ok());
+    std::cout << "iter " << iter << ": " << next.Size() << " vertices."
+              << std::endl;
+    frontier = std::move(next);
+  }
+  auto values = distance.GetValues();
+  for (GAR_NAMESPACE::IdType i = 0; i < num_vertices; i++) {
+    std::cout << i << ", distance: " << values[i] << std::endl;
+  }
+
+  // extend the original vertex info and write results to gar using writer
+  GAR_NAMESPACE::Property bfs = {
+      "bfs-bsp", GAR_NAMESPACE::DataType(GAR_NAMESPACE::Type::INT32), false};
+  std::vector<GAR_NAMESPACE::Property> property_vector = {bfs};
+  GAR_NAMESPACE::PropertyGroup group(property_vector,
+                                     GAR_NAMESPACE::FileType::PARQUET);
+  auto maybe_vertex_info = graph_info.GetVertexInfo(label);
+  assert(maybe_vertex_info.status().ok());
+  auto maybe_extend_info = maybe_vertex_info.value().Extend(group);
+  assert(maybe_extend_info.status().ok());
+  auto extend_info = maybe_extend_info.value();
+  assert(extend_info.IsValidated());
+  assert(extend_info.Save("/tmp/person-new-bfs-bsp.vertex.yml").ok());
+  assert(GAR_NAMESPACE::engine::WriteVertexProperty(extend_info, group, "/tmp/",
+                                                    values)
+             .ok());
+}
@@ -54,6 +54,8 @@ int main(int argc, char* argv[]) {
   for (GAR_NAMESPACE::IdType i = 0; i < num_vertices; i++)
     distance[i] = (i == root ? 0 : -1);
   auto it_begin = edges.begin(), it_end = edges.end();
+  // read the next chunks ahead while scanning the current one
+  it_begin.SetPrefetchDepth(2);
   for (int iter = 0;; iter++) {
     GAR_NAMESPACE::IdType count = 0;
     for (auto it = it_begin; it != it_end; ++it) {
@@ -18,6 +18,7 @@ limitations under the License.
 #include "arrow/filesystem/api.h"
 
 #include "config.h"
+#include "gar/csr.h"
 #include "gar/graph.h"
 #include "gar/graph_info.h"
 #include "gar/reader/arrow_chunk_reader.h"
@@ -54,23 +55,32 @@ int main(int argc, char* argv[]) {
   const int max_iters = 10;
   std::vector<double> pr_curr(num_vertices);
   std::vector<double> pr_next(num_vertices);
-  std::vector<GAR_NAMESPACE::IdType> out_degree(num_vertices);
   for (GAR_NAMESPACE::IdType i = 0; i < num_vertices; i++) {
     pr_curr[i] = 1 / static_cast<double>(num_vertices);
     pr_next[i] = 0;
-    out_degree[i] = 0;
-  }
-  auto it_begin = edges.begin(), it_end = edges.end();
-  for (auto it = it_begin; it != it_end; ++it) {
-    GAR_NAMESPACE::IdType src = it.source();
-    out_degree[src]++;
   }
+  // the out-degrees are read from the offset chunks, without scanning edges
+  auto maybe_out_degree = GAR_NAMESPACE::GetOutDegrees(graph_info, src_label,
+                                                       edge_label, dst_label);
+  assert(!maybe_out_degree.has_error());
+  const int64_t* out_degree =
+      std::static_pointer_cast<arrow::Int64Array>(maybe_out_degree.value())
+          ->raw_values();
+  // scan the topology chunk by chunk instead of edge by edge, reading the
+  // next chunks ahead while scanning the current one
+  const GAR_NAMESPACE::IdType prefetch_depth = 2;
   for (int iter = 0; iter < max_iters; iter++) {
     std::cout << "iter " << iter << std::endl;
-    for (auto it = it_begin; it != it_end; ++it) {
-      GAR_NAMESPACE::IdType src = it.source(), dst = it.destination();
-      pr_next[dst] += pr_curr[src] / out_degree[src];
-    }
+    auto status = edges.ForEachChunk(
+        [&](const GAR_NAMESPACE::AdjListSpan& span) {
+          for (int64_t i = 0; i < span.size; i++) {
+            GAR_NAMESPACE::IdType src = span.src[i], dst = span.dst[i];
+            pr_next[dst] += pr_curr[src] / out_degree[src];
+          }
+          return GAR_NAMESPACE::Status::OK();
+        },
+        prefetch_depth);
+    assert(status.ok());
     for (GAR_NAMESPACE::IdType i = 0; i < num_vertices; i++) {
       pr_next[i] = damping * pr_next[i] +
                    (1 - damping) * (1 / static_cast<double>(num_vertices));
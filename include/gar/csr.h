@@ -0,0 +1,294 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef GAR_CSR_H_
+#define GAR_CSR_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gar/graph_info.h"
+#include "gar/utils/adj_list_type.h"
+#include "gar/utils/result.h"
+#include "gar/utils/utils.h"
+
+// forward declarations
+namespace arrow {
+class Array;
+class Buffer;
+}  // namespace arrow
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+/** The options of LoadCSR(). */
+struct CSROptions {
+  /** The number of threads to decode the chunks, 0 means all the cores. */
+  int num_threads = 0;
+  /** Store the neighbor ids as 32-bit integers if the vertex number allows. */
+  bool compact_ids = true;
+  /**
+   * The path of the file to map the arrays to, empty means to keep them in
+   * memory. The file is created or overwritten.
+   */
+  std::string mmap_path;
+};
+
+/**
+ * @brief The in-memory topology of an ordered adj list, as a CSR for the
+ *   ordered_by_source adj list or a CSC for the ordered_by_dest adj list.
+ *
+ * The edges of the vertex v are at the positions [offsets[v], offsets[v + 1])
+ * of the neighbor array, which holds the destination ids of the CSR or the
+ * source ids of the CSC. The CSR is immutable and can be shared by threads.
+ */
+class CSR {
+ public:
+  /**
+   * @brief The iterator for traversing the edges of a CSR, with the same
+   *   traversal methods as EdgeIter.
+   */
+  class Iterator {
+   public:
+    /**
+     * Initialize the iterator.
+     *
+     * @param csr The CSR to traverse.
+     * @param offset The position of the current edge.
+     */
+    Iterator(const CSR* csr, IdType offset) noexcept;
+
+    /** Get the source vertex id for the current edge. */
+    IdType source() const noexcept {
+      return csr_->by_source_ ? vertex_ : csr_->GetNeighbor(offset_);
+    }
+
+    /** Get the destination vertex id for the current edge. */
+    IdType destination() const noexcept {
+      return csr_->by_source_ ? csr_->GetNeighbor(offset_) : vertex_;
+    }
+
+    /** Get the position of the current edge. */
+    IdType offset() const noexcept { return offset_; }
+
+    /** The prefix increment operator. */
+    Iterator& operator++() noexcept {
+      ++offset_;
+      while (vertex_ < csr_->vertex_num_ &&
+             csr_->offsets_[vertex_ + 1] <= offset_) {
+        ++vertex_;
+      }
+      return *this;
+    }
+
+    /** The postfix increment operator. */
+    Iterator operator++(int) noexcept {
+      Iterator ret(*this);
+      this->operator++();
+      return ret;
+    }
+
+    /** The equality operator. */
+    bool operator==(const Iterator& rhs) const noexcept {
+      return offset_ == rhs.offset_;
+    }
+
+    /** The inequality operator. */
+    bool operator!=(const Iterator& rhs) const noexcept {
+      return offset_ != rhs.offset_;
+    }
+
+    /** Whether the iterator is past the last edge. */
+    bool is_end() const noexcept { return offset_ >= csr_->edge_num_; }
+
+    /**
+     * @brief Move to the first edge at or after from with the source id.
+     *
+     * @return If such an edge exists.
+     */
+    bool first_src(const Iterator& from, IdType id) noexcept {
+      return first(from, id, csr_->by_source_);
+    }
+
+    /**
+     * @brief Move to the first edge at or after from with the destination id.
+     *
+     * @return If such an edge exists.
+     */
+    bool first_dst(const Iterator& from, IdType id) noexcept {
+      return first(from, id, !csr_->by_source_);
+    }
+
+    /**
+     * @brief Move to the next edge with the same source id.
+     *
+     * @return If such an edge exists.
+     */
+    bool next_src() noexcept { return next(csr_->by_source_); }
+
+    /**
+     * @brief Move to the next edge with the same destination id.
+     *
+     * @return If such an edge exists.
+     */
+    bool next_dst() noexcept { return next(!csr_->by_source_); }
+
+   private:
+    // move to the first edge at or after from whose endpoint is id, the
+    // endpoint is the vertex of the offsets if aligned, or else the neighbor
+    bool first(const Iterator& from, IdType id, bool aligned) noexcept;
+
+    // move to the next edge with the same endpoint as the current edge
+    bool next(bool aligned) noexcept;
+
+    // point the iterator to the position and the vertex of its edges
+    void moveTo(IdType offset) noexcept;
+
+    const CSR* csr_;
+    IdType offset_;
+    // the vertex whose edges contain offset_, the source of the CSR or the
+    // destination of the CSC
+    IdType vertex_;
+  };
+
+  /**
+   * @brief Initialize the CSR.
+   *
+   * @param data The buffer of the vertex_num + 1 int64 offsets followed by
+   * the edge_num neighbor ids.
+   * @param vertex_num The number of vertices.
+   * @param edge_num The number of edges.
+   * @param compact Whether the neighbor ids are 32-bit integers.
+   * @param adj_list_type The type of the adj list, ordered_by_source or
+   * ordered_by_dest.
+   */
+  CSR(std::shared_ptr<arrow::Buffer> data, IdType vertex_num, IdType edge_num,
+      bool compact, AdjListType adj_list_type) noexcept;
+
+  /** Get the number of vertices. */
+  IdType GetVertexNum() const noexcept { return vertex_num_; }
+
+  /** Get the number of edges. */
+  IdType GetEdgeNum() const noexcept { return edge_num_; }
+
+  /** Get the type of the adj list the CSR is loaded from. */
+  AdjListType GetAdjListType() const noexcept {
+    return by_source_ ? AdjListType::ordered_by_source
+                      : AdjListType::ordered_by_dest;
+  }
+
+  /** Whether the neighbor ids are stored as 32-bit integers. */
+  bool IsCompact() const noexcept { return compact_; }
+
+  /** Get the vertex_num + 1 offsets of the edges of the vertices. */
+  const int64_t* GetOffsets() const noexcept { return offsets_; }
+
+  /** Get the 64-bit neighbor ids, nullptr if IsCompact() is true. */
+  const int64_t* GetNeighbors() const noexcept {
+    return compact_ ? nullptr : neighbors64_;
+  }
+
+  /** Get the 32-bit neighbor ids, nullptr if IsCompact() is false. */
+  const int32_t* GetCompactNeighbors() const noexcept {
+    return compact_ ? neighbors32_ : nullptr;
+  }
+
+  /** Get the number of edges of a vertex. */
+  IdType GetDegree(IdType vid) const noexcept {
+    return offsets_[vid + 1] - offsets_[vid];
+  }
+
+  /** Get the neighbor id of the edge at a position. */
+  IdType GetNeighbor(IdType offset) const noexcept {
+    return compact_ ? neighbors32_[offset] : neighbors64_[offset];
+  }
+
+  /** The iterator pointing to the first edge. */
+  Iterator begin() const noexcept { return Iterator(this, 0); }
+
+  /** The iterator pointing to the past-the-end edge. */
+  Iterator end() const noexcept { return Iterator(this, edge_num_); }
+
+ private:
+  std::shared_ptr<arrow::Buffer> data_;
+  IdType vertex_num_;
+  IdType edge_num_;
+  bool compact_;
+  bool by_source_;
+  const int64_t* offsets_;
+  const int32_t* neighbors32_;
+  const int64_t* neighbors64_;
+};
+
+/**
+ * @brief Load the topology of an ordered adj list into memory as a CSR.
+ *
+ * The offsets are read from the offset chunks and the neighbor ids from the
+ * adj list chunks, only the neighbor column of which is decoded. The chunks
+ * are decoded in parallel and written in place into a single buffer, in
+ * memory or in a memory-mapped file.
+ *
+ * @param graph_info The GraphInfo for the graph.
+ * @param src_label The source vertex label.
+ * @param edge_label The edge label.
+ * @param dst_label The destination vertex label.
+ * @param adj_list_type The adj list type, ordered_by_source for a CSR or
+ * ordered_by_dest for a CSC.
+ * @param options The options of the loading.
+ * @return The CSR or error.
+ */
+Result<std::shared_ptr<CSR>> LoadCSR(const GraphInfo& graph_info,
+                                     const std::string& src_label,
+                                     const std::string& edge_label,
+                                     const std::string& dst_label,
+                                     AdjListType adj_list_type,
+                                     const CSROptions& options = {}) noexcept;
+
+/**
+ * @brief Get the out-degrees of the source vertices of an edge type from the
+ *   offset chunks of its ordered_by_source adj list, without reading the
+ *   edges. The offset chunks are read in parallel.
+ *
+ * @param graph_info The GraphInfo for the graph.
+ * @param src_label The source vertex label.
+ * @param edge_label The edge label.
+ * @param dst_label The destination vertex label.
+ * @param num_threads The number of threads, 0 means all the cores.
+ * @return The int64 array of the degrees indexed by the vertex id, or error.
+ */
+Result<std::shared_ptr<arrow::Array>> GetOutDegrees(
+    const GraphInfo& graph_info, const std::string& src_label,
+    const std::string& edge_label, const std::string& dst_label,
+    int num_threads = 0) noexcept;
+
+/**
+ * @brief Get the in-degrees of the destination vertices of an edge type from
+ *   the offset chunks of its ordered_by_dest adj list, without reading the
+ *   edges. The offset chunks are read in parallel.
+ *
+ * @param graph_info The GraphInfo for the graph.
+ * @param src_label The source vertex label.
+ * @param edge_label The edge label.
+ * @param dst_label The destination vertex label.
+ * @param num_threads The number of threads, 0 means all the cores.
+ * @return The int64 array of the degrees indexed by the vertex id, or error.
+ */
+Result<std::shared_ptr<arrow::Array>> GetInDegrees(
+    const GraphInfo& graph_info, const std::string& src_label,
+    const std::string& edge_label, const std::string& dst_label,
+    int num_threads = 0) noexcept;
+
+}  // namespace GAR_NAMESPACE_INTERNAL
+#endif  // GAR_CSR_H_
@@ -0,0 +1,65 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef GAR_ENGINE_BFS_H_
+#define GAR_ENGINE_BFS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "gar/engine/bsp_engine.h"
+#include "gar/utils/result.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+namespace engine {
+
+/** The options of BFS(). */
+struct BFSOptions {
+  /**
+   * Switch from top-down to bottom-up steps when the out-going edges of the
+   * frontier are more than 1/alpha of the incoming edges of the unvisited
+   * vertices.
+   */
+  double alpha = 15;
+  /**
+   * Switch from bottom-up back to top-down steps when the frontier shrinks
+   * below 1/beta of the vertices.
+   */
+  double beta = 18;
+};
+
+/**
+ * @brief Run a direction-optimizing breadth-first search from a vertex.
+ *
+ * A step is top-down, pushing from the frontier along the out-going edges,
+ * while the frontier is small, and bottom-up, where each unvisited vertex
+ * pulls along its incoming edges until it finds a parent in the frontier,
+ * while the frontier is large. An engine with only one of the adj lists runs
+ * all the steps in its direction.
+ *
+ * @param engine The engine of the edges.
+ * @param root The id of the root vertex.
+ * @param options The options of the search.
+ * @return The distances from the root indexed by the vertex id, -1 for the
+ * unreachable vertices, or error if the root is out of range.
+ */
+Result<std::vector<int32_t>> BFS(const BSPEngine& engine, IdType root,
+                                 const BFSOptions& options = {}) noexcept;
+
+}  // namespace engine
+
+}  // namespace GAR_NAMESPACE_INTERNAL
+#endif  // GAR_ENGINE_BFS_H_
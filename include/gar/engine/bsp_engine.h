@@ -0,0 +1,547 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef GAR_ENGINE_BSP_ENGINE_H_
+#define GAR_ENGINE_BSP_ENGINE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gar/csr.h"
+#include "gar/graph_info.h"
+#include "gar/utils/result.h"
+#include "gar/utils/status.h"
+#include "gar/utils/utils.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+namespace engine {
+
+/**
+ * @brief A set of active vertices of a superstep.
+ *
+ * The membership is kept in a bitmap, and the ids are also kept in a list
+ * while the frontier is sparse, so that a push step visits only the active
+ * vertices. A dense frontier drops the list and is scanned by vertex chunk.
+ */
+class Frontier {
+ public:
+  /**
+   * @brief Initialize an empty sparse frontier.
+   *
+   * @param vertex_num The number of vertices.
+   */
+  explicit Frontier(IdType vertex_num)
+      : vertex_num_(vertex_num),
+        size_(0),
+        dense_(false),
+        bits_(new std::atomic<uint64_t>[(vertex_num + 63) / 64]()) {}
+
+  Frontier(Frontier&&) = default;
+  Frontier& operator=(Frontier&&) = default;
+
+  /** Get a dense frontier of all the vertices. */
+  static Frontier Full(IdType vertex_num) {
+    Frontier frontier(vertex_num);
+    for (IdType i = 0; i < vertex_num / 64; ++i) {
+      frontier.bits_[i].store(~uint64_t(0), std::memory_order_relaxed);
+    }
+    if (vertex_num % 64 != 0) {
+      frontier.bits_[vertex_num / 64].store(
+          (uint64_t(1) << (vertex_num % 64)) - 1, std::memory_order_relaxed);
+    }
+    frontier.size_ = vertex_num;
+    frontier.dense_ = true;
+    return frontier;
+  }
+
+  /** Get the number of vertices of the graph. */
+  IdType GetVertexNum() const noexcept { return vertex_num_; }
+
+  /** Get the number of active vertices. */
+  IdType Size() const noexcept { return size_; }
+
+  /** Whether there is no active vertex. */
+  bool Empty() const noexcept { return size_ == 0; }
+
+  /** Whether the frontier is dense, without the list of the ids. */
+  bool IsDense() const noexcept { return dense_; }
+
+  /** Whether a vertex is active. */
+  bool Contains(IdType vid) const noexcept {
+    return (bits_[vid >> 6].load(std::memory_order_relaxed) >> (vid & 63)) & 1;
+  }
+
+  /**
+   * @brief Activate a vertex, not thread-safe.
+   *
+   * @return Whether the vertex was not active.
+   */
+  bool Add(IdType vid) {
+    if (!set(vid)) {
+      return false;
+    }
+    ++size_;
+    if (!dense_) {
+      vertices_.push_back(vid);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Get the ids of the active vertices of a sparse frontier, in the
+   *   order they are activated.
+   */
+  const std::vector<IdType>& GetVertices() const noexcept { return vertices_; }
+
+  /** Drop the list of the ids. */
+  void ToDense() {
+    dense_ = true;
+    std::vector<IdType>().swap(vertices_);
+  }
+
+  /** Collect the list of the ids from the bitmap, in ascending order. */
+  void ToSparse() {
+    if (!dense_) {
+      return;
+    }
+    vertices_.reserve(size_);
+    for (IdType i = 0; i < vertex_num_; ++i) {
+      if (Contains(i)) {
+        vertices_.push_back(i);
+      }
+    }
+    dense_ = false;
+  }
+
+ private:
+  // set the bit of the vertex, thread-safe, return whether it was unset
+  bool set(IdType vid) noexcept {
+    uint64_t mask = uint64_t(1) << (vid & 63);
+    return !(bits_[vid >> 6].fetch_or(mask, std::memory_order_relaxed) & mask);
+  }
+
+  // count the vertices activated by the workers, whose bits are set, and keep
+  // their ids unless there are more than 1/20 of the vertices
+  void merge(std::vector<std::vector<IdType>>&& activated) {
+    for (const auto& ids : activated) {
+      size_ += static_cast<IdType>(ids.size());
+    }
+    if (size_ * 20 > vertex_num_) {
+      dense_ = true;
+      return;
+    }
+    vertices_.reserve(size_);
+    for (const auto& ids : activated) {
+      vertices_.insert(vertices_.end(), ids.begin(), ids.end());
+    }
+  }
+
+  IdType vertex_num_;
+  IdType size_;
+  bool dense_;
+  std::unique_ptr<std::atomic<uint64_t>[]> bits_;
+  std::vector<IdType> vertices_;
+
+  friend class BSPEngine;
+};
+
+/**
+ * @brief The double-buffered values of the vertices, read from the current
+ *   buffer and written to the next one during a superstep.
+ *
+ * The updates of the next buffer are atomic, so a push step may update the
+ * same vertex from several threads.
+ *
+ * @tparam T The type of the values, a trivially copyable type.
+ */
+template <typename T>
+class VertexState {
+ public:
+  /**
+   * @brief Initialize the state with a value for both buffers.
+   *
+   * @param vertex_num The number of vertices.
+   * @param value The initial value.
+   */
+  VertexState(IdType vertex_num, T value)
+      : vertex_num_(vertex_num),
+        cur_(new std::atomic<T>[vertex_num]),
+        next_(new std::atomic<T>[vertex_num]) {
+    for (IdType i = 0; i < vertex_num; ++i) {
+      cur_[i].store(value, std::memory_order_relaxed);
+      next_[i].store(value, std::memory_order_relaxed);
+    }
+  }
+
+  /** Get the number of vertices. */
+  IdType GetVertexNum() const noexcept { return vertex_num_; }
+
+  /** Get the current value of a vertex. */
+  T Get(IdType vid) const noexcept {
+    return cur_[vid].load(std::memory_order_relaxed);
+  }
+
+  /** Set the current value of a vertex. */
+  void Set(IdType vid, T value) noexcept {
+    cur_[vid].store(value, std::memory_order_relaxed);
+  }
+
+  /** Get the next value of a vertex. */
+  T GetNext(IdType vid) const noexcept {
+    return next_[vid].load(std::memory_order_relaxed);
+  }
+
+  /** Set the next value of a vertex. */
+  void SetNext(IdType vid, T value) noexcept {
+    next_[vid].store(value, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Set the next value of a vertex if it equals the expected one.
+   *
+   * @return Whether the value is set.
+   */
+  bool CompareAndSetNext(IdType vid, T expected, T value) noexcept {
+    return next_[vid].compare_exchange_strong(expected, value,
+                                              std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Lower the next value of a vertex to the value if it is less.
+   *
+   * @return Whether the value is lowered.
+   */
+  bool MinNext(IdType vid, T value) noexcept {
+    T old = next_[vid].load(std::memory_order_relaxed);
+    while (value < old) {
+      if (next_[vid].compare_exchange_weak(old, value,
+                                           std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Add the value to the next value of a vertex. */
+  void AddNext(IdType vid, T value) noexcept {
+    T old = next_[vid].load(std::memory_order_relaxed);
+    while (!next_[vid].compare_exchange_weak(old, old + value,
+                                             std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief Make the next values current at the end of a superstep, the next
+   *   buffer then holds the values of the previous superstep.
+   */
+  void Swap() noexcept { std::swap(cur_, next_); }
+
+  /** Get a copy of the current values. */
+  std::vector<T> GetValues() const {
+    std::vector<T> values(vertex_num_);
+    for (IdType i = 0; i < vertex_num_; ++i) {
+      values[i] = Get(i);
+    }
+    return values;
+  }
+
+ private:
+  IdType vertex_num_;
+  std::unique_ptr<std::atomic<T>[]> cur_;
+  std::unique_ptr<std::atomic<T>[]> next_;
+};
+
+/** The options of BSPEngine. */
+struct BSPOptions {
+  /** The number of worker threads, 0 means all the cores. */
+  int num_threads = 0;
+  /**
+   * Run a superstep of EdgeMap() by pulling when the active vertices and
+   * their out-going edges are more than this ratio of the edges.
+   */
+  double pull_ratio = 0.05;
+};
+
+/**
+ * @brief A vertex-centric engine of bulk synchronous supersteps over the edges
+ *   of an edge type whose source and destination vertices are the same.
+ *
+ * The engine loads the ordered_by_source adj list as a CSR to push along the
+ * out-going edges and the ordered_by_dest adj list as a CSC to pull along the
+ * incoming edges, whichever exist. The vertices are partitioned by vertex
+ * chunk and the partitions are processed by parallel workers.
+ */
+class BSPEngine {
+ public:
+  /**
+   * @brief Initialize the engine.
+   *
+   * @param out_edges The CSR of the out-going edges, nullptr if there is none.
+   * @param in_edges The CSC of the incoming edges, nullptr if there is none.
+   * @param vertex_num The number of vertices.
+   * @param vertex_chunk_size The size of the vertex chunks.
+   * @param options The options of the engine.
+   */
+  BSPEngine(std::shared_ptr<CSR> out_edges, std::shared_ptr<CSR> in_edges,
+            IdType vertex_num, IdType vertex_chunk_size,
+            const BSPOptions& options) noexcept
+      : out_edges_(std::move(out_edges)),
+        in_edges_(std::move(in_edges)),
+        vertex_num_(vertex_num),
+        vertex_chunk_size_(vertex_chunk_size),
+        options_(options) {}
+
+  /**
+   * @brief Load the adj lists of an edge type into an engine.
+   *
+   * @param graph_info The GraphInfo for the graph.
+   * @param src_label The source vertex label.
+   * @param edge_label The edge label.
+   * @param dst_label The destination vertex label, the same as src_label.
+   * @param options The options of the engine.
+   * @return The engine, or error if the labels differ or the edge type has no
+   * ordered adj list.
+   */
+  static Result<std::shared_ptr<BSPEngine>> Make(
+      const GraphInfo& graph_info, const std::string& src_label,
+      const std::string& edge_label, const std::string& dst_label,
+      const BSPOptions& options = {}) noexcept;
+
+  /** Get the number of vertices. */
+  IdType GetVertexNum() const noexcept { return vertex_num_; }
+
+  /** Get the CSR of the out-going edges, nullptr if it is not loaded. */
+  const std::shared_ptr<CSR>& GetOutEdges() const noexcept {
+    return out_edges_;
+  }
+
+  /** Get the CSC of the incoming edges, nullptr if it is not loaded. */
+  const std::shared_ptr<CSR>& GetInEdges() const noexcept { return in_edges_; }
+
+  /** Whether the engine can push along the out-going edges. */
+  bool CanPush() const noexcept { return out_edges_ != nullptr; }
+
+  /** Whether the engine can pull along the incoming edges. */
+  bool CanPull() const noexcept { return in_edges_ != nullptr; }
+
+  /**
+   * @brief Call func(vid) for each vertex in parallel.
+   *
+   * @param func The function to call, func(IdType vid).
+   * @return Status: ok or error.
+   */
+  template <typename Func>
+  Status ForEachVertex(Func&& func) const {
+    return forEachChunk([&](IdType begin, IdType end) {
+      for (IdType vid = begin; vid < end; ++vid) {
+        func(vid);
+      }
+    });
+  }
+
+  /**
+   * @brief Run a superstep along the out-going edges of the active vertices.
+   *
+   * For each out-going edge (src, dst) of an active vertex with cond(dst)
+   * true, func(src, dst) is called, and dst becomes active in the next
+   * frontier if it returns true. func may be called concurrently for the same
+   * destination and must update the state atomically.
+   *
+   * @param frontier The active vertices.
+   * @param func The function to update the destination, bool(src, dst).
+   * @param cond The function to check if the destination may be updated,
+   *   bool(dst).
+   * @param next The frontier to store the activated vertices.
+   * @return Status: ok or error.
+   */
+  template <typename Func, typename Cond>
+  Status Push(const Frontier& frontier, Func&& func, Cond&& cond,
+              Frontier* next) const {
+    if (!CanPush()) {
+      return Status::InvalidOperation(
+          "The engine has no ordered_by_source adj list to push along.");
+    }
+    Frontier result(vertex_num_);
+    const CSR& csr = *out_edges_;
+    auto push = [&](IdType src, std::vector<IdType>* activated) {
+      const int64_t* offsets = csr.GetOffsets();
+      for (IdType i = offsets[src]; i < offsets[src + 1]; ++i) {
+        IdType dst = csr.GetNeighbor(i);
+        if (cond(dst) && func(src, dst) && result.set(dst)) {
+          activated->push_back(dst);
+        }
+      }
+    };
+    std::vector<std::vector<IdType>> activated;
+    if (frontier.IsDense()) {
+      activated.resize(getChunkNum());
+      GAR_RETURN_NOT_OK(forEachChunk([&](IdType begin, IdType end) {
+        for (IdType src = begin; src < end; ++src) {
+          if (frontier.Contains(src)) {
+            push(src, &activated[begin / vertex_chunk_size_]);
+          }
+        }
+      }));
+    } else {
+      // the sparse frontier is split into tasks of the vertex chunk size
+      const auto& vertices = frontier.GetVertices();
+      IdType n = static_cast<IdType>(vertices.size());
+      activated.resize((n + vertex_chunk_size_ - 1) / vertex_chunk_size_);
+      GAR_RETURN_NOT_OK(util::ParallelFor(
+          static_cast<int64_t>(activated.size()), options_.num_threads,
+          [&](int64_t task) {
+            IdType end = std::min(n, (task + 1) * vertex_chunk_size_);
+            for (IdType i = task * vertex_chunk_size_; i < end; ++i) {
+              push(vertices[i], &activated[task]);
+            }
+            return Status::OK();
+          }));
+    }
+    result.merge(std::move(activated));
+    *next = std::move(result);
+    return Status::OK();
+  }
+
+  /**
+   * @brief Run a superstep along the incoming edges of the vertices.
+   *
+   * For each vertex dst with cond(dst) true, func(src, dst) is called for its
+   * incoming edges (src, dst) from active vertices until cond(dst) turns
+   * false, and dst becomes active in the next frontier if any call returns
+   * true. The vertices are updated by one thread each.
+   *
+   * @param frontier The active vertices.
+   * @param func The function to update the destination, bool(src, dst).
+   * @param cond The function to check if the destination may be updated,
+   *   bool(dst).
+   * @param next The frontier to store the activated vertices.
+   * @return Status: ok or error.
+   */
+  template <typename Func, typename Cond>
+  Status Pull(const Frontier& frontier, Func&& func, Cond&& cond,
+              Frontier* next) const {
+    if (!CanPull()) {
+      return Status::InvalidOperation(
+          "The engine has no ordered_by_dest adj list to pull along.");
+    }
+    Frontier result(vertex_num_);
+    const CSR& csc = *in_edges_;
+    std::vector<std::vector<IdType>> activated(getChunkNum());
+    GAR_RETURN_NOT_OK(forEachChunk([&](IdType begin, IdType end) {
+      const int64_t* offsets = csc.GetOffsets();
+      auto& chunk_activated = activated[begin / vertex_chunk_size_];
+      for (IdType dst = begin; dst < end; ++dst) {
+        bool active = false;
+        for (IdType i = offsets[dst]; i < offsets[dst + 1] && cond(dst); ++i) {
+          IdType src = csc.GetNeighbor(i);
+          if (frontier.Contains(src) && func(src, dst)) {
+            active = true;
+          }
+        }
+        if (active) {
+          result.set(dst);
+          chunk_activated.push_back(dst);
+        }
+      }
+    }));
+    result.merge(std::move(activated));
+    *next = std::move(result);
+    return Status::OK();
+  }
+
+  /**
+   * @brief Run a superstep along the edges from the active vertices, by
+   *   pushing while the frontier is sparse and by pulling once the frontier
+   *   and its out-going edges exceed BSPOptions::pull_ratio of the edges.
+   *
+   * func must be safe to call concurrently as in Push().
+   *
+   * @param frontier The active vertices.
+   * @param func The function to update the destination, bool(src, dst).
+   * @param cond The function to check if the destination may be updated,
+   *   bool(dst).
+   * @param next The frontier to store the activated vertices.
+   * @return Status: ok or error.
+   */
+  template <typename Func, typename Cond>
+  Status EdgeMap(const Frontier& frontier, Func&& func, Cond&& cond,
+                 Frontier* next) const {
+    if (!CanPull()) {
+      return Push(frontier, func, cond, next);
+    }
+    if (!CanPush() || frontier.IsDense()) {
+      return Pull(frontier, func, cond, next);
+    }
+    double work = static_cast<double>(frontier.Size());
+    for (IdType vid : frontier.GetVertices()) {
+      work += out_edges_->GetDegree(vid);
+    }
+    if (work > options_.pull_ratio * out_edges_->GetEdgeNum()) {
+      return Pull(frontier, func, cond, next);
+    }
+    return Push(frontier, func, cond, next);
+  }
+
+ private:
+  IdType getChunkNum() const noexcept {
+    return (vertex_num_ + vertex_chunk_size_ - 1) / vertex_chunk_size_;
+  }
+
+  // call func(begin, end) for the range of each vertex chunk in parallel
+  template <typename Func>
+  Status forEachChunk(Func&& func) const {
+    return util::ParallelFor(getChunkNum(), options_.num_threads,
+                             [&](int64_t chunk_index) {
+                               IdType begin = chunk_index * vertex_chunk_size_;
+                               IdType end = std::min(
+                                   vertex_num_, begin + vertex_chunk_size_);
+                               func(begin, end);
+                               return Status::OK();
+                             });
+  }
+
+  std::shared_ptr<CSR> out_edges_;
+  std::shared_ptr<CSR> in_edges_;
+  IdType vertex_num_;
+  IdType vertex_chunk_size_;
+  BSPOptions options_;
+};
+
+/**
+ * @brief Write the values of the vertices as a property with
+ *   VertexPropertyWriter, starting from the first vertex chunk.
+ *
+ * @param vertex_info The vertex info that contains the property group.
+ * @param property_group The property group of the only property to write.
+ * @param prefix The absolute prefix to write to.
+ * @param values The values indexed by the vertex id.
+ * @return Status: ok or error.
+ */
+template <typename T>
+Status WriteVertexProperty(const VertexInfo& vertex_info,
+                           const PropertyGroup& property_group,
+                           const std::string& prefix,
+                           const std::vector<T>& values) noexcept;
+
+}  // namespace engine
+
+}  // namespace GAR_NAMESPACE_INTERNAL
+#endif  // GAR_ENGINE_BSP_ENGINE_H_
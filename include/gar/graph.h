@@ -16,27 +16,146 @@ limitations under the License.
 #ifndef GAR_GRAPH_H_
 #define GAR_GRAPH_H_
 
-#include <any>
-#include <map>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
 #include "gar/reader/arrow_chunk_reader.h"
+#include "gar/reader/offset_index.h"
 #include "gar/utils/reader_utils.h"
 #include "gar/utils/utils.h"
 
 // forward declarations
 namespace arrow {
 class ChunkedArray;
+class Table;
+namespace compute {
+class Expression;
 }
+}  // namespace arrow
 
 namespace GAR_NAMESPACE_INTERNAL {
 
 /**
- * @brief Vertex contains information of certain vertex.
+ * @brief A typed handle of a vertex or edge property, resolved once from the
+ *   vertex or edge info so that the iterators read the property by position
+ *   instead of searching their readers by name, see VertexIter::get() and
+ *   EdgeIter::get().
+ *
+ * The position depends on the properties read by the iterators, a handle
+ * must be made with the same property names as the collection whose
+ * iterators use it, e.g. by VerticesCollection::GetPropertyHandle().
+ *
+ * @tparam T The type of the property values, int32_t, int64_t, float, double
+ *   or std::string.
+ */
+template <typename T>
+class PropertyHandle {
+ public:
+  /** Initialize an unresolved handle. */
+  PropertyHandle() = default;
+
+  /**
+   * @brief Make the handle of a vertex property.
+   *
+   * @param vertex_info The vertex info that describes the vertex type.
+   * @param property The name of the property.
+   * @param property_names The properties read by the iterators, empty means
+   * all the properties.
+   * @return The handle, or KeyError if the property is not read, or TypeError
+   *   if the property is not of type T.
+   */
+  static Result<PropertyHandle<T>> Make(
+      const VertexInfo& vertex_info, const std::string& property,
+      const std::vector<std::string>& property_names = {}) noexcept {
+    GAR_ASSIGN_OR_RAISE(auto type, vertex_info.GetPropertyType(property));
+    return make(vertex_info.GetPropertyGroups(), type, property,
+                property_names);
+  }
+
+  /**
+   * @brief Make the handle of an edge property.
+   *
+   * @param edge_info The edge info that describes the edge type.
+   * @param adj_list_type The type of the adj list iterated.
+   * @param property The name of the property.
+   * @param property_names The properties read by the iterators, empty means
+   * all the properties.
+   * @return The handle, or KeyError if the property is not read, or TypeError
+   *   if the property is not of type T.
+   */
+  static Result<PropertyHandle<T>> Make(
+      const EdgeInfo& edge_info, AdjListType adj_list_type,
+      const std::string& property,
+      const std::vector<std::string>& property_names = {}) noexcept {
+    GAR_ASSIGN_OR_RAISE(auto type, edge_info.GetPropertyType(property));
+    GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                        edge_info.GetPropertyGroups(adj_list_type));
+    return make(property_groups, type, property, property_names);
+  }
+
+  /** Get the name of the property. */
+  const std::string& name() const noexcept { return name_; }
+
+  /** Get the index of the reader of the property in the iterators. */
+  int reader_index() const noexcept { return position_.group_index; }
+
+  /** Get the index of the property in the chunk tables of its reader. */
+  int column_index() const noexcept { return position_.column_index; }
+
+  /** Get the index of the property among all the properties read. */
+  int slot() const noexcept { return position_.slot; }
+
+ private:
+  static Result<PropertyHandle<T>> make(
+      const std::vector<PropertyGroup>& property_groups, const DataType& type,
+      const std::string& property,
+      const std::vector<std::string>& property_names) {
+    if (type.id() != expectedType()) {
+      return Status::TypeError("The property " + property + " is of type " +
+                               type.ToTypeName() + ".");
+    }
+    PropertyHandle<T> handle;
+    handle.name_ = property;
+    GAR_ASSIGN_OR_RAISE(handle.position_,
+                        utils::GetPropertyPosition(property_groups, property,
+                                                   property_names));
+    return handle;
+  }
+
+  static constexpr Type expectedType() {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      return Type::INT32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      return Type::INT64;
+    } else if constexpr (std::is_same_v<T, float>) {
+      return Type::FLOAT;
+    } else if constexpr (std::is_same_v<T, double>) {
+      return Type::DOUBLE;
+    } else {
+      static_assert(std::is_same_v<T, std::string>,
+                    "The property type is not supported by PropertyHandle.");
+      return Type::STRING;
+    }
+  }
+
+  std::string name_;
+  utils::PropertyPosition position_;
+};
+
+/**
+ * @brief Vertex is a view of a vertex at the position of a VertexIter.
+ *
+ * The view does not copy the properties, it holds the chunks of the readers
+ * of the iterator sliced at the vertex, and the properties are looked up in
+ * them when they are accessed. The view shares the chunks with the readers,
+ * so that it stays valid after the iterator is moved or destroyed.
  */
 class Vertex {
  public:
@@ -44,11 +163,12 @@ class Vertex {
    * Initialize the Vertex.
    *
    * @param id The vertex id.
-   * @param readers A set of readers for reading the vertex properties.
+   * @param readers A set of readers for reading the vertex properties, seeked
+   * to the vertex.
    */
   explicit Vertex(
       IdType id,
-      std::vector<VertexPropertyArrowChunkReader>& readers);  // NOLINT
+      std::vector<VertexPropertyArrowChunkReader>& readers) noexcept;  // NOLINT
 
   /**
    * @brief Get the id of the vertex.
@@ -60,80 +180,82 @@ class Vertex {
   /**
    * @brief Get the property value of the vertex.
    *
+   * @tparam T The type of the value, bool, int32_t, int64_t, float, double,
+   * std::string, or std::string_view which refers to the chunk of the string
+   * property without copying it.
    * @param property The property name.
-   * @return Result: The property value or error.
+   * @return Result: The property value, or KeyError if the property is not
+   *   read, or TypeError if the property is not of type T, or the error of
+   *   reading the chunks.
    */
   template <typename T>
-  inline Result<T> property(const std::string& property) noexcept {
-    T ret;
-    if (properties_.find(property) == properties_.end()) {
-      return Status::KeyError("The property is not exist.");
-    }
-    try {
-      ret = std::any_cast<T>(properties_[property]);
-    } catch (const std::bad_any_cast& e) {
-      return Status::TypeError("The property type is not match.");
-    }
-    return ret;
-  }
+  Result<T> property(const std::string& property) const noexcept;
 
  private:
   IdType id_;
-  std::map<std::string, std::any> properties_;
+  // the chunks of the readers, sliced at the vertex
+  std::vector<std::shared_ptr<arrow::Table>> chunks_;
+  // the error of reading the chunks
+  Status status_;
 };
 
 /**
- * @brief Edge contains information of certain edge.
+ * @brief Edge is a view of an edge at the position of an EdgeIter.
+ *
+ * The view does not copy the endpoints or the properties, it holds the chunks
+ * of the readers of the iterator sliced at the edge, and the endpoints and
+ * the properties are looked up in them when they are accessed. The view
+ * shares the chunks with the readers, so that it stays valid after the
+ * iterator is moved or destroyed.
  */
 class Edge {
  public:
   /**
    * Initialize the Edge.
    *
-   * @param adj_list_reader The reader for reading the adjList.
-   * @param property_readers A set of readers for reading the edge properties.
+   * @param adj_list_reader The reader for reading the adjList, seeked to the
+   * edge.
+   * @param property_readers A set of readers for reading the edge properties,
+   * seeked to the edge.
    */
   explicit Edge(AdjListArrowChunkReader& adj_list_reader,  // NOLINT
                 std::vector<AdjListPropertyArrowChunkReader>&
-                    property_readers);  // NOLINT
+                    property_readers) noexcept;  // NOLINT
 
   /**
    * @brief Get source id of the edge.
    *
    * @return The id of the source vertex.
    */
-  inline IdType source() const noexcept { return src_id_; }
+  IdType source() const;
 
   /**
    * @brief Get destination id of the edge.
    *
    * @return The id of the destination vertex.
    */
-  inline IdType destination() const noexcept { return dst_id_; }
+  IdType destination() const;
 
   /**
    * @brief Get the property value of the edge.
    *
+   * @tparam T The type of the value, bool, int32_t, int64_t, float, double,
+   * std::string, or std::string_view which refers to the chunk of the string
+   * property without copying it.
    * @param property The property name.
-   * @return Result: The property value or error.
+   * @return Result: The property value, or KeyError if the property is not
+   *   read, or TypeError if the property is not of type T, or the error of
+   *   reading the chunks.
    */
   template <typename T>
-  inline Result<T> property(const std::string& property) noexcept {
-    T ret;
-    if (properties_.find(property) == properties_.end()) {
-      return Status::KeyError("The property is not exist.");
-    }
-    try {
-      ret = std::any_cast<T>(properties_[property]);
-    } catch (const std::bad_any_cast& e) {
-      return Status::TypeError("The property type is not match.");
-    }
-    return ret;
-  }
+  Result<T> property(const std::string& property) const noexcept;
 
  private:
-  IdType src_id_, dst_id_;
-  std::map<std::string, std::any> properties_;
+  // the chunks of the readers, sliced at the edge
+  std::shared_ptr<arrow::Table> adj_list_chunk_;
+  std::vector<std::shared_ptr<arrow::Table>> property_chunks_;
+  // the error of reading the chunks
+  Status status_;
 };
 
 /**
@@ -148,18 +270,33 @@ class VertexIter {
    * @param vertex_info The vertex info that describes the vertex type.
    * @param prefix The absolute prefix.
    * @param offset The current offset of the readers.
+   * @param property_names The properties to read, empty means all the
+   * properties. The property groups without any of them are not read.
    */
-  explicit VertexIter(const VertexInfo& vertex_info, const std::string& prefix,
-                      IdType offset) noexcept {
+  explicit VertexIter(
+      const VertexInfo& vertex_info, const std::string& prefix, IdType offset,
+      const std::vector<std::string>& property_names = {}) {
     for (const auto& pg : vertex_info.GetPropertyGroups()) {
-      readers_.emplace_back(vertex_info, pg, prefix);
+      if (property_names.empty()) {
+        readers_.emplace_back(vertex_info, pg, prefix);
+        continue;
+      }
+      auto selected = utils::GetSelectedProperties(pg, property_names);
+      if (!selected.empty()) {
+        readers_.emplace_back(vertex_info, pg, prefix);
+        // the selected properties are of the group, so the selection never
+        // fails, and a failure would be a bug
+        GAR_RAISE_ERROR_NOT_OK(readers_.back().SelectProperties(selected));
+      }
     }
     cur_offset_ = offset;
   }
 
   /** Copy constructor. */
   VertexIter(const VertexIter& other)
-      : readers_(other.readers_), cur_offset_(other.cur_offset_) {}
+      : readers_(other.readers_),
+        cur_offset_(other.cur_offset_),
+        cursors_(other.cursors_) {}
 
   /** Construct and return the vertex of the current offset. */
   Vertex operator*() noexcept {
@@ -172,6 +309,17 @@ class VertexIter {
   /** Get the vertex id of the current offset. */
   IdType id() { return cur_offset_; }
 
+  /**
+   * @brief Read ahead the next chunks of the readers in the background.
+   *
+   * @param depth The number of chunks to read ahead, 0 disables read-ahead.
+   */
+  void SetPrefetchDepth(IdType depth) noexcept {
+    for (auto& reader : readers_) {
+      reader.SetPrefetchDepth(depth);
+    }
+  }
+
   /** Get the value for a property of the current vertex. */
   template <typename T>
   Result<T> property(const std::string& property) noexcept {
@@ -192,6 +340,27 @@ class VertexIter {
     return Status::KeyError("The property is not exist.");
   }
 
+  /**
+   * @brief Get the value of a property of the current vertex through a
+   *   handle, the values are read in place from the current chunk of the
+   *   property without looking it up by name.
+   *
+   * @param handle The handle of the property, made with the property names of
+   * the collection of the iterator.
+   * @return Result: The property value or error.
+   */
+  template <typename T>
+  Result<T> get(const PropertyHandle<T>& handle) noexcept {
+    GAR_ASSIGN_OR_RAISE(auto cursor, getCursor(handle.slot()));
+    if (cur_offset_ < cursor->begin || cur_offset_ >= cursor->end) {
+      GAR_RETURN_NOT_OK(loadCursor(handle.reader_index(),
+                                   handle.column_index(), handle.name(),
+                                   cursor));
+    }
+    return util::ValueGetter<T>::Value(cursor->data,
+                                       cur_offset_ - cursor->begin);
+  }
+
   /** The prefix increment operator. */
   VertexIter& operator++() noexcept {
     ++cur_offset_;
@@ -216,8 +385,25 @@ class VertexIter {
   }
 
  private:
+  // get the cursor of the slot of a property handle
+  Result<util::ColumnCursor*> getCursor(int slot) noexcept {
+    if (slot < 0) {
+      return Status::InvalidOperation("The property handle is not resolved.");
+    }
+    if (static_cast<size_t>(slot) >= cursors_.size()) {
+      cursors_.resize(slot + 1);
+    }
+    return &cursors_[slot];
+  }
+
+  // point the cursor to the values of the property from the current vertex
+  Status loadCursor(int reader_index, int column_index,
+                    const std::string& name, util::ColumnCursor* cursor);
+
   std::vector<VertexPropertyArrowChunkReader> readers_;
   IdType cur_offset_;
+  // the values of the properties read through handles, indexed by slot
+  std::vector<util::ColumnCursor> cursors_;
 };
 
 /**
@@ -231,10 +417,15 @@ class VerticesCollection {
    *
    * @param vertex_info The vertex info that describes the vertex type.
    * @param prefix The absolute prefix.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
-  explicit VerticesCollection(const VertexInfo& vertex_info,
-                              const std::string& prefix)
-      : vertex_info_(vertex_info), prefix_(prefix) {
+  explicit VerticesCollection(
+      const VertexInfo& vertex_info, const std::string& prefix,
+      const std::vector<std::string>& property_names = {})
+      : vertex_info_(vertex_info),
+        prefix_(prefix),
+        property_names_(property_names) {
     // get the vertex num
     std::string base_dir;
     GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
@@ -247,22 +438,59 @@ class VerticesCollection {
   }
 
   /** The iterator pointing to the first vertex. */
-  VertexIter begin() noexcept { return VertexIter(vertex_info_, prefix_, 0); }
+  VertexIter begin() noexcept {
+    return VertexIter(vertex_info_, prefix_, 0, property_names_);
+  }
 
   /** The iterator pointing to the past-the-end element. */
   VertexIter end() noexcept {
-    return VertexIter(vertex_info_, prefix_, vertex_num_);
+    return VertexIter(vertex_info_, prefix_, vertex_num_, property_names_);
   }
 
   /** The iterator pointing to the vertex with specific id. */
-  VertexIter find(IdType id) { return VertexIter(vertex_info_, prefix_, id); }
+  VertexIter find(IdType id) {
+    return VertexIter(vertex_info_, prefix_, id, property_names_);
+  }
 
   /** Get the number of vertices in the collection. */
   size_t size() const noexcept { return vertex_num_; }
 
+  /**
+   * @brief Make the handle of a property for the iterators of the collection.
+   *
+   * @param property The name of the property.
+   * @return The handle or error.
+   */
+  template <typename T>
+  Result<PropertyHandle<T>> GetPropertyHandle(
+      const std::string& property) const noexcept {
+    return PropertyHandle<T>::Make(vertex_info_, property, property_names_);
+  }
+
+  /**
+   * @brief Scan the vertices whose properties satisfy a filter.
+   *
+   * If the filter only refers to the properties of one property group, the
+   * Parquet row groups whose column statistics prove that no vertex satisfies
+   * the filter are not read, so that a chunk is skipped if all its row groups
+   * are. The filter is evaluated vectorized on the rows read.
+   *
+   * @param filter The boolean arrow compute expression on the properties,
+   *    e.g. arrow::compute::greater(arrow::compute::field_ref("age"),
+   *    arrow::compute::literal(30)).
+   * @param property_names The properties to output for the matched vertices.
+   * @return Result: the table of the matched vertices, with their ids in the
+   *    column GeneralParams::kVertexIndexCol followed by the properties, or
+   *    error.
+   */
+  Result<std::shared_ptr<arrow::Table>> Filter(
+      const arrow::compute::Expression& filter,
+      const std::vector<std::string>& property_names = {}) noexcept;
+
  private:
   VertexInfo vertex_info_;
   std::string prefix_;
+  std::vector<std::string> property_names_;
   IdType vertex_num_;
 };
 
@@ -273,6 +501,181 @@ class VerticesCollection {
 template <AdjListType adj_list_type>
 class EdgesCollection;
 
+/**
+ * @brief The topology of the edges of an edge chunk, as contiguous arrays.
+ *
+ * The arrays are owned by the chunk table held by the span, they stay valid
+ * as long as the table is referenced.
+ */
+struct AdjListSpan {
+  /** The source vertex ids of the edges. */
+  const IdType* src = nullptr;
+  /** The destination vertex ids of the edges. */
+  const IdType* dst = nullptr;
+  /** The number of edges of the chunk. */
+  int64_t size = 0;
+  /** The index of the first edge of the chunk among the edges iterated. */
+  IdType offset = 0;
+  /** The index of the vertex chunk of the edge chunk. */
+  IdType vertex_chunk_index = 0;
+  /** The index of the edge chunk in its vertex chunk. */
+  IdType chunk_index = 0;
+  /** The chunk table that holds the arrays. */
+  std::shared_ptr<arrow::Table> table;
+};
+
+/**
+ * @brief The neighbors of a vertex in an ordered adj list, as a view over the
+ *   adj list chunks that hold them.
+ *
+ * The ids are not copied, the list refers to the neighbor column of each
+ * chunk the edges of the vertex span, one slice per contiguous range, and
+ * holds the chunk tables so that the ids stay valid as long as the list is
+ * referenced.
+ */
+class NeighborList {
+ public:
+  /** A contiguous range of the neighbor ids. */
+  struct Slice {
+    /** The first neighbor id of the range. */
+    const IdType* data;
+    /** The number of neighbor ids of the range. */
+    int64_t size;
+  };
+
+  /** The iterator for traversing the neighbor ids. */
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = IdType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const IdType*;
+    using reference = IdType;
+
+    /**
+     * Initialize the iterator.
+     *
+     * @param list The neighbor list.
+     * @param slice The index of the current slice.
+     * @param pos The position in the current slice.
+     */
+    Iterator(const NeighborList* list, size_t slice, int64_t pos) noexcept
+        : list_(list), slice_(slice), pos_(pos) {}
+
+    /** Get the current neighbor id. */
+    IdType operator*() const noexcept {
+      return list_->slices_[slice_].data[pos_];
+    }
+
+    /** The prefix increment operator. */
+    Iterator& operator++() noexcept {
+      if (++pos_ == list_->slices_[slice_].size) {
+        ++slice_;
+        pos_ = 0;
+      }
+      return *this;
+    }
+
+    /** The equality operator. */
+    bool operator==(const Iterator& rhs) const noexcept {
+      return slice_ == rhs.slice_ && pos_ == rhs.pos_;
+    }
+
+    /** The inequality operator. */
+    bool operator!=(const Iterator& rhs) const noexcept {
+      return !(*this == rhs);
+    }
+
+   private:
+    const NeighborList* list_;
+    size_t slice_;
+    int64_t pos_;
+  };
+
+  /** Get the number of neighbors. */
+  int64_t size() const noexcept { return size_; }
+
+  /** Whether the vertex has no neighbors. */
+  bool empty() const noexcept { return size_ == 0; }
+
+  /** Get the contiguous ranges of the neighbor ids, none of them is empty. */
+  const std::vector<Slice>& slices() const noexcept { return slices_; }
+
+  /** Get the neighbor id at a position, in O(number of slices). */
+  IdType operator[](int64_t index) const noexcept {
+    for (const auto& slice : slices_) {
+      if (index < slice.size) {
+        return slice.data[index];
+      }
+      index -= slice.size;
+    }
+    return -1;
+  }
+
+  /** The iterator pointing to the first neighbor. */
+  Iterator begin() const noexcept { return Iterator(this, 0, 0); }
+
+  /** The iterator pointing to the past-the-end neighbor. */
+  Iterator end() const noexcept { return Iterator(this, slices_.size(), 0); }
+
+ private:
+  // read the neighbors of a vertex with the reader of an ordered adj list,
+  // the reader keeps the last chunk, so the queries of close vertices share
+  // the chunk reads
+  static Result<NeighborList> load(AdjListArrowChunkReader* reader,
+                                   OffsetIndex* offset_index, IdType vid,
+                                   bool by_source) noexcept;
+
+  std::vector<Slice> slices_;
+  std::vector<std::shared_ptr<arrow::Table>> tables_;
+  int64_t size_ = 0;
+
+  friend class EdgesCollection<AdjListType::ordered_by_source>;
+  friend class EdgesCollection<AdjListType::ordered_by_dest>;
+};
+
+/**
+ * @brief The metadata of an adj list and its property groups, opened once and
+ *   shared by an EdgesCollection and all of its iterators, so that creating
+ *   or copying an iterator does no I/O. It is immutable after Make().
+ */
+struct EdgeCollectionMeta {
+  /** The edge info that describes the edge type. */
+  EdgeInfo edge_info;
+  /** The type of the adj list. */
+  AdjListType adj_list_type;
+  /** The file system of the graph. */
+  std::shared_ptr<FileSystem> fs;
+  /** The prefix path in the file system. */
+  std::string path_prefix;
+  /** The manifest of the adj list chunks. */
+  std::shared_ptr<ChunkManifest> adj_list_manifest;
+  /** The manifests of the property groups of the adj list type, in order. */
+  std::vector<std::shared_ptr<ChunkManifest>> property_manifests;
+  /** The converter for transforming the edge chunk indices. */
+  std::shared_ptr<util::IndexConverter> index_converter;
+  /** The offset index of an ordered adj list, nullptr if it is unordered. */
+  std::shared_ptr<OffsetIndex> offset_index;
+
+  /**
+   * @brief Open the metadata of an adj list.
+   *
+   * @param edge_info The edge info that describes the edge type.
+   * @param adj_list_type The type of adjList.
+   * @param prefix The absolute prefix.
+   * @param index_converter The converter of the adj list, nullptr means it is
+   * built from the chunk numbers of the adj list manifest.
+   * @param offset_index The offset index of an ordered adj list, nullptr
+   * means it is made with the adj list manifest.
+   * @return The metadata or error.
+   */
+  static Result<std::shared_ptr<EdgeCollectionMeta>> Make(
+      const EdgeInfo& edge_info, AdjListType adj_list_type,
+      const std::string& prefix,
+      std::shared_ptr<util::IndexConverter> index_converter = nullptr,
+      std::shared_ptr<OffsetIndex> offset_index = nullptr) noexcept;
+};
+
 /**
  * @brief The iterator for traversing a type of edges.
  *
@@ -293,47 +696,46 @@ class EdgeIter {
    * @param offset_of_chunk_end The end offset of the last chunk.
    * @param index_converter The converter for transforming the edge chunk
    * indices.
+   * @param offset_index The offset index of the ordered adj list, created by
+   * the iterator if it is nullptr.
+   * @param property_names The properties to read, empty means all the
+   * properties. The property groups without any of them are not read.
    */
   explicit EdgeIter(const EdgeInfo& edge_info, const std::string& prefix,
                     AdjListType adj_list_type, IdType global_chunk_index,
                     IdType offset, IdType chunk_begin, IdType chunk_end,
                     IdType offset_of_chunk_begin, IdType offset_of_chunk_end,
-                    std::shared_ptr<util::IndexConverter> index_converter)
-      : adj_list_reader_(
-            edge_info, adj_list_type, prefix,
-            index_converter->GlobalChunkIndexToIndexPair(global_chunk_index)
-                .first),
-        global_chunk_index_(global_chunk_index),
-        cur_offset_(offset),
-        chunk_size_(edge_info.GetChunkSize()),
-        src_chunk_size_(edge_info.GetSrcChunkSize()),
-        dst_chunk_size_(edge_info.GetDstChunkSize()),
-        num_row_of_chunk_(0),
-        chunk_begin_(chunk_begin),
-        chunk_end_(chunk_end),
-        offset_of_chunk_begin_(offset_of_chunk_begin),
-        offset_of_chunk_end_(offset_of_chunk_end),
-        adj_list_type_(adj_list_type),
-        index_converter_(index_converter) {
-    vertex_chunk_index_ =
-        index_converter->GlobalChunkIndexToIndexPair(global_chunk_index).first;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto& property_groups,
-                              edge_info.GetPropertyGroups(adj_list_type));
-    for (const auto& pg : property_groups) {
-      property_readers_.emplace_back(edge_info, pg, adj_list_type, prefix,
-                                     vertex_chunk_index_);
-    }
-    if (adj_list_type == AdjListType::ordered_by_source ||
-        adj_list_type == AdjListType::ordered_by_dest) {
-      offset_reader_ = std::make_shared<AdjListOffsetArrowChunkReader>(
-          edge_info, adj_list_type, prefix);
-    }
-  }
+                    std::shared_ptr<util::IndexConverter> index_converter,
+                    std::shared_ptr<OffsetIndex> offset_index = nullptr,
+                    const std::vector<std::string>& property_names = {})
+      : EdgeIter(openMeta(edge_info, prefix, adj_list_type,
+                          std::move(index_converter), std::move(offset_index)),
+                 global_chunk_index, offset, chunk_begin, chunk_end,
+                 offset_of_chunk_begin, offset_of_chunk_end, property_names) {}
+
+  /**
+   * Initialize the iterator with the shared metadata of the adj list, which
+   * does no I/O.
+   *
+   * @param meta The metadata of the adj list.
+   * @param global_chunk_index The global index of the current edge chunk.
+   * @param offset The current offset in the current edge chunk.
+   * @param chunk_begin The index of the first chunk.
+   * @param chunk_end The index of the last chunk.
+   * @param offset_of_chunk_begin The begin offset of the first chunk.
+   * @param offset_of_chunk_end The end offset of the last chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties. The property groups without any of them are not read.
+   */
+  EdgeIter(std::shared_ptr<const EdgeCollectionMeta> meta,
+           IdType global_chunk_index, IdType offset, IdType chunk_begin,
+           IdType chunk_end, IdType offset_of_chunk_begin,
+           IdType offset_of_chunk_end,
+           const std::vector<std::string>& property_names = {});
 
   /** Copy constructor. */
   EdgeIter(const EdgeIter& other)
       : adj_list_reader_(other.adj_list_reader_),
-        offset_reader_(other.offset_reader_),
         property_readers_(other.property_readers_),
         global_chunk_index_(other.global_chunk_index_),
         vertex_chunk_index_(other.vertex_chunk_index_),
@@ -347,7 +749,20 @@ class EdgeIter {
         offset_of_chunk_begin_(other.offset_of_chunk_begin_),
         offset_of_chunk_end_(other.offset_of_chunk_end_),
         adj_list_type_(other.adj_list_type_),
-        index_converter_(other.index_converter_) {}
+        meta_(other.meta_),
+        cursors_(other.cursors_) {}
+
+  /**
+   * @brief Read ahead the next chunks of the readers in the background.
+   *
+   * @param depth The number of chunks to read ahead, 0 disables read-ahead.
+   */
+  void SetPrefetchDepth(IdType depth) noexcept {
+    adj_list_reader_.SetPrefetchDepth(depth);
+    for (auto& reader : property_readers_) {
+      reader.SetPrefetchDepth(depth);
+    }
+  }
 
   /** Construct and return the edge of the current offset. */
   Edge operator*() {
@@ -384,6 +799,28 @@ class EdgeIter {
     return Status::KeyError("The property is not exist.");
   }
 
+  /**
+   * @brief Get the value of a property of the current edge through a handle,
+   *   the values are read in place from the current chunk of the property
+   *   without looking it up by name.
+   *
+   * @param handle The handle of the property, made with the adj list type and
+   * the property names of the collection of the iterator.
+   * @return Result: The property value or error.
+   */
+  template <typename T>
+  Result<T> get(const PropertyHandle<T>& handle) noexcept {
+    GAR_ASSIGN_OR_RAISE(auto cursor, getCursor(handle.slot()));
+    if (cursor->vertex_chunk_index != vertex_chunk_index_ ||
+        cur_offset_ < cursor->begin || cur_offset_ >= cursor->end) {
+      GAR_RETURN_NOT_OK(loadCursor(handle.reader_index(),
+                                   handle.column_index(), handle.name(),
+                                   cursor));
+    }
+    return util::ValueGetter<T>::Value(cursor->data,
+                                       cur_offset_ - cursor->begin);
+  }
+
   /** The prefix increment operator. */
   EdgeIter& operator++() {
     if (num_row_of_chunk_ == 0) {
@@ -432,9 +869,8 @@ class EdgeIter {
   }
 
   /** The copy assignment operator. */
-  EdgeIter operator=(const EdgeIter& other) {
+  EdgeIter& operator=(const EdgeIter& other) {
     adj_list_reader_ = other.adj_list_reader_;
-    offset_reader_ = other.offset_reader_;
     property_readers_ = other.property_readers_;
     global_chunk_index_ = other.global_chunk_index_;
     vertex_chunk_index_ = other.vertex_chunk_index_;
@@ -448,7 +884,8 @@ class EdgeIter {
     offset_of_chunk_begin_ = other.offset_of_chunk_begin_;
     offset_of_chunk_end_ = other.offset_of_chunk_end_;
     adj_list_type_ = other.adj_list_type_;
-    index_converter_ = other.index_converter_;
+    meta_ = other.meta_;
+    cursors_ = other.cursors_;
     return *this;
   }
 
@@ -496,9 +933,9 @@ class EdgeIter {
   void to_begin() {
     global_chunk_index_ = chunk_begin_;
     cur_offset_ = offset_of_chunk_begin_;
-    vertex_chunk_index_ =
-        index_converter_->GlobalChunkIndexToIndexPair(global_chunk_index_)
-            .first;
+    vertex_chunk_index_ = meta_->index_converter
+                              ->GlobalChunkIndexToIndexPair(global_chunk_index_)
+                              .first;
     refresh();
   }
 
@@ -523,6 +960,13 @@ class EdgeIter {
     }
     this->operator++();
     while (!is_end()) {
+      if (!chunkMayContain(id, true)) {
+        if (adj_list_type_ == AdjListType::unordered_by_source &&
+            vertex_chunk_index_ > pre_vertex_chunk_index)
+          return false;
+        skipChunk();
+        continue;
+      }
       if (this->source() == id) {
         return true;
       }
@@ -553,6 +997,13 @@ class EdgeIter {
     }
     this->operator++();
     while (!is_end()) {
+      if (!chunkMayContain(id, false)) {
+        if (adj_list_type_ == AdjListType::unordered_by_dest &&
+            vertex_chunk_index_ > pre_vertex_chunk_index)
+          return false;
+        skipChunk();
+        continue;
+      }
       if (this->destination() == id) {
         return true;
       }
@@ -588,6 +1039,60 @@ class EdgeIter {
   }
 
  private:
+  // get the cursor of the slot of a property handle
+  Result<util::ColumnCursor*> getCursor(int slot) noexcept {
+    if (slot < 0) {
+      return Status::InvalidOperation("The property handle is not resolved.");
+    }
+    if (static_cast<size_t>(slot) >= cursors_.size()) {
+      cursors_.resize(slot + 1);
+    }
+    return &cursors_[slot];
+  }
+
+  // point the cursor to the values of the property from the current edge
+  Status loadCursor(int reader_index, int column_index,
+                    const std::string& name, util::ColumnCursor* cursor);
+
+  // whether the current chunk may have an edge with the source id, or with
+  // the destination id if by_src is false, by the zone map of the chunk
+  bool chunkMayContain(IdType id, bool by_src) const noexcept;
+
+  // move to the first edge of the next chunk, or to the end
+  void skipChunk();
+
+  // call func with the span of each edge chunk from chunk_begin_ to
+  // chunk_end_, the iterator itself is not moved
+  Status forEachChunk(const std::function<Status(const AdjListSpan&)>& func,
+                      IdType prefetch_depth);
+
+  // call func with the span of each edge chunk from chunk_begin_ to
+  // chunk_end_ on num_threads threads, edge_nums are the numbers of edges of
+  // the vertex chunks
+  Status parallelForEachChunk(
+      const std::function<Status(const AdjListSpan&)>& func,
+      const std::vector<IdType>& edge_nums, int num_threads);
+
+  // call func with the span of each edge chunk in [begin, end) read by the
+  // reader, offset is the index of the first edge of the chunk begin
+  Status scanChunks(
+      AdjListArrowChunkReader* reader, IdType begin, IdType end, IdType offset,
+      const std::function<Status(const AdjListSpan&)>& func) const;
+
+  // the table of the edges of the edge chunks from chunk_begin_ to chunk_end_
+  // whose properties satisfy the filter, see EdgesCollection::Filter()
+  Result<std::shared_ptr<arrow::Table>> filter(
+      const arrow::compute::Expression& filter,
+      const std::vector<std::string>& property_names) const;
+
+  // open the metadata for an iterator created without a collection, with the
+  // index converter and the offset index if they are given
+  static std::shared_ptr<const EdgeCollectionMeta> openMeta(
+      const EdgeInfo& edge_info, const std::string& prefix,
+      AdjListType adj_list_type,
+      std::shared_ptr<util::IndexConverter> index_converter,
+      std::shared_ptr<OffsetIndex> offset_index);
+
   // Refresh the readers to point to the current position.
   void refresh() {
     adj_list_reader_.seek_chunk_index(vertex_chunk_index_);
@@ -601,7 +1106,6 @@ class EdgeIter {
 
  private:
   AdjListArrowChunkReader adj_list_reader_;
-  std::shared_ptr<AdjListOffsetArrowChunkReader> offset_reader_;
   std::vector<AdjListPropertyArrowChunkReader> property_readers_;
   IdType global_chunk_index_;
   IdType vertex_chunk_index_;
@@ -613,21 +1117,154 @@ class EdgeIter {
   IdType chunk_begin_, chunk_end_;
   IdType offset_of_chunk_begin_, offset_of_chunk_end_;
   AdjListType adj_list_type_;
-  std::shared_ptr<util::IndexConverter> index_converter_;
+  // the metadata of the adj list, shared by the collection and its iterators
+  std::shared_ptr<const EdgeCollectionMeta> meta_;
+  // the values of the properties read through handles, indexed by slot
+  std::vector<util::ColumnCursor> cursors_;
 
+  friend class EdgesCollectionBase;
   friend class EdgesCollection<AdjListType::ordered_by_source>;
   friend class EdgesCollection<AdjListType::ordered_by_dest>;
   friend class EdgesCollection<AdjListType::unordered_by_source>;
   friend class EdgesCollection<AdjListType::unordered_by_dest>;
 };
 
+/**
+ * @brief The part of EdgesCollection common to all the adj list types, the
+ *   range of edge chunks of the collection and the scans over them.
+ */
+class EdgesCollectionBase {
+ public:
+  /** The iterator pointing to the first edge. */
+  EdgeIter begin() {
+    if (begin_ == nullptr) {
+      EdgeIter iter(meta_, chunk_begin_, offset_of_chunk_begin_, chunk_begin_,
+                    chunk_end_, offset_of_chunk_begin_, offset_of_chunk_end_,
+                    property_names_);
+      begin_ = std::make_shared<EdgeIter>(iter);
+    }
+    return *begin_;
+  }
+
+  /** The iterator pointing to the past-the-end element. */
+  EdgeIter end() {
+    if (end_ == nullptr) {
+      EdgeIter iter(meta_, chunk_end_, offset_of_chunk_end_, chunk_begin_,
+                    chunk_end_, offset_of_chunk_begin_, offset_of_chunk_end_,
+                    property_names_);
+      end_ = std::make_shared<EdgeIter>(iter);
+    }
+    return *end_;
+  }
+
+  /**
+   * @brief Make the handle of an edge property for the iterators of the
+   *   collection.
+   *
+   * @param property The name of the property.
+   * @return The handle or error.
+   */
+  template <typename T>
+  Result<PropertyHandle<T>> GetPropertyHandle(
+      const std::string& property) const noexcept {
+    return PropertyHandle<T>::Make(edge_info_, meta_->adj_list_type, property,
+                                   property_names_);
+  }
+
+  /**
+   * @brief Call func with the topology of each edge chunk of the collection
+   *   in order, as contiguous arrays instead of per-edge accessors.
+   *
+   * @param func The function to call with the span of each edge chunk, the
+   * iteration stops at the first error it returns.
+   * @param prefetch_depth The number of next edge chunks to read ahead in the
+   * background while func runs, 0 disables read-ahead.
+   * @return Status: ok or the first error.
+   */
+  Status ForEachChunk(const std::function<Status(const AdjListSpan&)>& func,
+                      IdType prefetch_depth = 0) noexcept {
+    return begin().forEachChunk(func, prefetch_depth);
+  }
+
+  /**
+   * @brief Call func with the topology of each edge chunk of the collection
+   *   on multiple threads, see ParallelForEdges().
+   *
+   * @param func The function to call with the span of each edge chunk, it is
+   * called concurrently and must be thread-safe.
+   * @param num_threads The number of threads, 0 means the number of cores.
+   * @return Status: ok or the first error.
+   */
+  Status ParallelForEachChunk(
+      const std::function<Status(const AdjListSpan&)>& func,
+      int num_threads = 0) noexcept {
+    // the numbers of edges come from the shared manifest of the adj list
+    GAR_ASSIGN_OR_RAISE(auto edge_nums,
+                        utils::GetEdgeNums(edge_info_, meta_->fs,
+                                           meta_->path_prefix,
+                                           meta_->adj_list_type,
+                                           meta_->adj_list_manifest));
+    return begin().parallelForEachChunk(func, edge_nums, num_threads);
+  }
+
+  /**
+   * @brief Scan the edges whose properties satisfy a filter.
+   *
+   * The filter is evaluated vectorized on the property columns of each edge
+   * chunk, and the topology is read only for the chunks with matched edges
+   * and taken only for the matched rows. If the filter only refers to the
+   * properties of one property group, the Parquet row groups whose column
+   * statistics prove that no edge satisfies the filter are not read, so that
+   * a chunk is skipped if all its row groups are. The whole edge chunks of
+   * the collection are scanned, as with ForEachChunk().
+   *
+   * @param filter The boolean arrow compute expression on the properties,
+   *    e.g. arrow::compute::greater_equal(
+   *    arrow::compute::field_ref("creationDate"),
+   *    arrow::compute::literal("2012-01-01")).
+   * @param property_names The properties to output for the matched edges.
+   * @return Result: the table of the matched edges, with their source and
+   *    destination ids in the columns GeneralParams::kSrcIndexCol and
+   *    GeneralParams::kDstIndexCol followed by the properties, or error.
+   */
+  Result<std::shared_ptr<arrow::Table>> Filter(
+      const arrow::compute::Expression& filter,
+      const std::vector<std::string>& property_names = {}) noexcept {
+    return begin().filter(filter, property_names);
+  }
+
+ protected:
+  // open the metadata of the adj list, the range of chunks is set by the
+  // constructors of EdgesCollection
+  EdgesCollectionBase(const EdgeInfo& edge_info, const std::string& prefix,
+                      AdjListType adj_list_type,
+                      const std::vector<std::string>& property_names)
+      : edge_info_(edge_info),
+        prefix_(prefix),
+        property_names_(property_names) {
+    GAR_ASSIGN_OR_RAISE_ERROR(
+        meta_, EdgeCollectionMeta::Make(edge_info, adj_list_type, prefix));
+    index_converter_ = meta_->index_converter;
+  }
+
+  EdgeInfo edge_info_;
+  std::string prefix_;
+  std::vector<std::string> property_names_;
+  IdType chunk_begin_ = 0, chunk_end_ = 0;
+  IdType offset_of_chunk_begin_ = 0, offset_of_chunk_end_ = 0;
+  std::shared_ptr<const EdgeCollectionMeta> meta_;
+  std::shared_ptr<util::IndexConverter> index_converter_;
+  std::shared_ptr<EdgeIter> begin_, end_;
+};
+
 /**
  * @brief The implementation of EdgesCollection when the type of adjList is
  * AdjListType::ordered_by_source.
  *
  */
 template <>
-class EdgesCollection<AdjListType::ordered_by_source> {
+class EdgesCollection<AdjListType::ordered_by_source>
+    : public EdgesCollectionBase {
  public:
   static const AdjListType adj_list_type_;
 
@@ -636,29 +1273,14 @@ class EdgesCollection<AdjListType::ordered_by_source> {
    *
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
-  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix)
-      : edge_info_(edge_info), prefix_(prefix), chunk_begin_(0) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto vertex_chunk_num,
-                              fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_end_ = 0;
-    for (size_t i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      chunk_end_ += edge_chunk_nums[i];
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
+  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_end_ = index_converter_->GetChunkNum();
+    offset_index_ = meta_->offset_index;
   }
 
   /**
@@ -668,29 +1290,16 @@ class EdgesCollection<AdjListType::ordered_by_source> {
    * @param prefix The absolute prefix.
    * @param chunk_begin The global index of the begin chunk.
    * @param chunk_end The global index of the end chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType chunk_begin, IdType chunk_end)
-      : edge_info_(edge_info),
-        prefix_(prefix),
-        chunk_begin_(chunk_begin),
-        chunk_end_(chunk_end) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto vertex_chunk_num,
-                              fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    for (size_t i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
+                  IdType chunk_begin, IdType chunk_end,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_begin_ = chunk_begin;
+    chunk_end_ = chunk_end;
+    offset_index_ = meta_->offset_index;
     offset_of_chunk_begin_ =
         index_converter_->GlobalChunkIndexToIndexPair(chunk_begin).second *
         edge_info.GetChunkSize();
@@ -705,60 +1314,25 @@ class EdgesCollection<AdjListType::ordered_by_source> {
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
    * @param vertex_chunk_index The index of the vertex chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType vertex_chunk_index)
-      : edge_info_(edge_info), prefix_(prefix) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    IdType vertex_chunk_num = 0;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num, fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_begin_ = 0;
-    chunk_end_ = 0;
-    for (IdType i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      if (i < vertex_chunk_index) {
-        chunk_begin_ += edge_chunk_nums[i];
-      }
-      if (i == vertex_chunk_index) {
-        chunk_end_ = chunk_begin_ + edge_chunk_nums[i];
-      }
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
-  }
-
-  /** The iterator pointing to the first edge. */
-  EdgeIter begin() {
-    if (begin_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_begin_,
-                    offset_of_chunk_begin_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      begin_ = std::make_shared<EdgeIter>(iter);
-    }
-    return *begin_;
-  }
-
-  /** The iterator pointing to the past-the-end element. */
-  EdgeIter end() {
-    if (end_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_end_,
-                    offset_of_chunk_end_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      end_ = std::make_shared<EdgeIter>(iter);
+                  IdType vertex_chunk_index,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    if (vertex_chunk_index >= 0 &&
+        vertex_chunk_index < index_converter_->GetVertexChunkNum()) {
+      chunk_begin_ =
+          index_converter_->IndexPairToGlobalChunkIndex(vertex_chunk_index, 0);
+      chunk_end_ = index_converter_->IndexPairToGlobalChunkIndex(
+          vertex_chunk_index + 1, 0);
+    } else {
+      chunk_begin_ =
+          vertex_chunk_index < 0 ? 0 : index_converter_->GetChunkNum();
+      chunk_end_ = 0;
     }
-    return *end_;
+    offset_index_ = meta_->offset_index;
   }
 
   /**
@@ -770,8 +1344,7 @@ class EdgesCollection<AdjListType::ordered_by_source> {
    * @return The new constructed iterator.
    */
   EdgeIter find_src(IdType id, const EdgeIter& from) {
-    auto result = utils::GetAdjListOffsetOfVertex(edge_info_, prefix_,
-                                                  adj_list_type_, id);
+    auto result = offset_index_->GetOffsetRange(id);
     if (!result.status().ok()) {
       return this->end();
     }
@@ -788,25 +1361,22 @@ class EdgesCollection<AdjListType::ordered_by_source> {
         id / edge_info_.GetSrcChunkSize(),
         end_offset / edge_info_.GetChunkSize());
     if (begin_global_chunk_index > from.global_chunk_index_) {
-      return EdgeIter(edge_info_, prefix_, adj_list_type_,
-                      begin_global_chunk_index, begin_offset, chunk_begin_,
-                      chunk_end_, offset_of_chunk_begin_, offset_of_chunk_end_,
-                      index_converter_);
+      return EdgeIter(meta_, begin_global_chunk_index, begin_offset,
+                      chunk_begin_, chunk_end_, offset_of_chunk_begin_,
+                      offset_of_chunk_end_, property_names_);
     } else if (end_global_chunk_index < from.global_chunk_index_) {
       return this->end();
     } else {
       if (begin_offset > from.cur_offset_) {
-        return EdgeIter(edge_info_, prefix_, adj_list_type_,
-                        begin_global_chunk_index, begin_offset, chunk_begin_,
-                        chunk_end_, offset_of_chunk_begin_,
-                        offset_of_chunk_end_, index_converter_);
+        return EdgeIter(meta_, begin_global_chunk_index, begin_offset,
+                        chunk_begin_, chunk_end_, offset_of_chunk_begin_,
+                        offset_of_chunk_end_, property_names_);
       } else if (end_offset <= from.cur_offset_) {
         return this->end();
       } else {
-        return EdgeIter(edge_info_, prefix_, adj_list_type_,
-                        from.global_chunk_index_, from.cur_offset_,
+        return EdgeIter(meta_, from.global_chunk_index_, from.cur_offset_,
                         chunk_begin_, chunk_end_, offset_of_chunk_begin_,
-                        offset_of_chunk_end_, index_converter_);
+                        offset_of_chunk_end_, property_names_);
       }
     }
     return this->end();
@@ -822,24 +1392,51 @@ class EdgesCollection<AdjListType::ordered_by_source> {
    */
   EdgeIter find_dst(IdType id, const EdgeIter& from) {
     EdgeIter iter(from);
-    auto end = this->end();
-    while (iter != end) {
-      auto edge = *iter;
-      if (edge.destination() == id) {
-        break;
-      }
-      ++iter;
+    if (!iter.first_dst(from, id)) {
+      return this->end();
     }
     return iter;
   }
 
+  /**
+   * @brief Get the out-going neighbors of a vertex, as a view over the adj list
+   *   chunks without copying the ids.
+   *
+   * @param vid The vertex id.
+   * @return The neighbors, or KeyError if the id does not exist.
+   */
+  Result<NeighborList> Neighbors(IdType vid) noexcept {
+    if (neighbor_reader_ == nullptr) {
+      neighbor_reader_ = std::make_shared<AdjListArrowChunkReader>(
+          edge_info_, adj_list_type_, meta_->fs, meta_->path_prefix,
+          meta_->adj_list_manifest, offset_index_);
+    }
+    return NeighborList::load(neighbor_reader_.get(), offset_index_.get(), vid,
+                              true);
+  }
+
+  /**
+   * @brief Get the out-going neighbors of a list of vertices. The vertices are
+   *   expected to be sorted, so that each adj list chunk is read once.
+   *
+   * @param vids The vertex ids.
+   * @return The neighbors of each vertex in the order of vids, or error.
+   */
+  Result<std::vector<NeighborList>> Neighbors(
+      const std::vector<IdType>& vids) noexcept {
+    std::vector<NeighborList> lists;
+    lists.reserve(vids.size());
+    for (auto vid : vids) {
+      GAR_ASSIGN_OR_RAISE(auto list, Neighbors(vid));
+      lists.push_back(std::move(list));
+    }
+    return lists;
+  }
+
  private:
-  EdgeInfo edge_info_;
-  std::string prefix_;
-  IdType chunk_begin_, chunk_end_;
-  IdType offset_of_chunk_begin_, offset_of_chunk_end_;
-  std::shared_ptr<util::IndexConverter> index_converter_;
-  std::shared_ptr<EdgeIter> begin_, end_;
+  std::shared_ptr<OffsetIndex> offset_index_;
+  // the reader of the neighbor lists, created on the first query
+  std::shared_ptr<AdjListArrowChunkReader> neighbor_reader_;
 };
 
 /**
@@ -848,7 +1445,8 @@ class EdgesCollection<AdjListType::ordered_by_source> {
  *
  */
 template <>
-class EdgesCollection<AdjListType::ordered_by_dest> {
+class EdgesCollection<AdjListType::ordered_by_dest>
+    : public EdgesCollectionBase {
  public:
   static const AdjListType adj_list_type_;
 
@@ -857,29 +1455,14 @@ class EdgesCollection<AdjListType::ordered_by_dest> {
    *
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
-  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix)
-      : edge_info_(edge_info), prefix_(prefix), chunk_begin_(0) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto vertex_chunk_num,
-                              fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_end_ = 0;
-    for (size_t i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      chunk_end_ += edge_chunk_nums[i];
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
+  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_end_ = index_converter_->GetChunkNum();
+    offset_index_ = meta_->offset_index;
   }
 
   /**
@@ -889,29 +1472,16 @@ class EdgesCollection<AdjListType::ordered_by_dest> {
    * @param prefix The absolute prefix.
    * @param chunk_begin The global index of the begin chunk.
    * @param chunk_end The global index of the end chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType chunk_begin, IdType chunk_end)
-      : edge_info_(edge_info),
-        prefix_(prefix),
-        chunk_begin_(chunk_begin),
-        chunk_end_(chunk_end) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto vertex_chunk_num,
-                              fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    for (size_t i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
+                  IdType chunk_begin, IdType chunk_end,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_begin_ = chunk_begin;
+    chunk_end_ = chunk_end;
+    offset_index_ = meta_->offset_index;
     offset_of_chunk_begin_ =
         index_converter_->GlobalChunkIndexToIndexPair(chunk_begin).second *
         edge_info.GetChunkSize();
@@ -926,60 +1496,25 @@ class EdgesCollection<AdjListType::ordered_by_dest> {
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
    * @param vertex_chunk_index The index of the vertex chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType vertex_chunk_index)
-      : edge_info_(edge_info), prefix_(prefix) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    IdType vertex_chunk_num = 0;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num, fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_begin_ = 0;
-    chunk_end_ = 0;
-    for (IdType i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      if (i < vertex_chunk_index) {
-        chunk_begin_ += edge_chunk_nums[i];
-      }
-      if (i == vertex_chunk_index) {
-        chunk_end_ = chunk_begin_ + edge_chunk_nums[i];
-      }
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
-  }
-
-  /** The iterator pointing to the first edge. */
-  EdgeIter begin() {
-    if (begin_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_begin_,
-                    offset_of_chunk_begin_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      begin_ = std::make_shared<EdgeIter>(iter);
-    }
-    return *begin_;
-  }
-
-  /** The iterator pointing to the past-the-end element. */
-  EdgeIter end() {
-    if (end_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_end_,
-                    offset_of_chunk_end_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      end_ = std::make_shared<EdgeIter>(iter);
+                  IdType vertex_chunk_index,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    if (vertex_chunk_index >= 0 &&
+        vertex_chunk_index < index_converter_->GetVertexChunkNum()) {
+      chunk_begin_ =
+          index_converter_->IndexPairToGlobalChunkIndex(vertex_chunk_index, 0);
+      chunk_end_ = index_converter_->IndexPairToGlobalChunkIndex(
+          vertex_chunk_index + 1, 0);
+    } else {
+      chunk_begin_ =
+          vertex_chunk_index < 0 ? 0 : index_converter_->GetChunkNum();
+      chunk_end_ = 0;
     }
-    return *end_;
+    offset_index_ = meta_->offset_index;
   }
 
   /**
@@ -992,13 +1527,8 @@ class EdgesCollection<AdjListType::ordered_by_dest> {
    */
   EdgeIter find_src(IdType id, const EdgeIter& from) {
     EdgeIter iter(from);
-    auto end = this->end();
-    while (iter != end) {
-      auto edge = *iter;
-      if (edge.source() == id) {
-        break;
-      }
-      ++iter;
+    if (!iter.first_src(from, id)) {
+      return this->end();
     }
     return iter;
   }
@@ -1012,8 +1542,7 @@ class EdgesCollection<AdjListType::ordered_by_dest> {
    * @return The new constructed iterator.
    */
   EdgeIter find_dst(IdType id, const EdgeIter& from) {
-    auto result = utils::GetAdjListOffsetOfVertex(edge_info_, prefix_,
-                                                  adj_list_type_, id);
+    auto result = offset_index_->GetOffsetRange(id);
     if (!result.status().ok()) {
       return this->end();
     }
@@ -1030,37 +1559,66 @@ class EdgesCollection<AdjListType::ordered_by_dest> {
         id / edge_info_.GetDstChunkSize(),
         end_offset / edge_info_.GetChunkSize());
     if (begin_global_chunk_index > from.global_chunk_index_) {
-      return EdgeIter(edge_info_, prefix_, adj_list_type_,
-                      begin_global_chunk_index, begin_offset, chunk_begin_,
-                      chunk_end_, offset_of_chunk_begin_, offset_of_chunk_end_,
-                      index_converter_);
+      return EdgeIter(meta_, begin_global_chunk_index, begin_offset,
+                      chunk_begin_, chunk_end_, offset_of_chunk_begin_,
+                      offset_of_chunk_end_, property_names_);
     } else if (end_global_chunk_index < from.global_chunk_index_) {
       return this->end();
     } else {
       if (begin_offset >= from.cur_offset_) {
-        return EdgeIter(edge_info_, prefix_, adj_list_type_,
-                        begin_global_chunk_index, begin_offset, chunk_begin_,
-                        chunk_end_, offset_of_chunk_begin_,
-                        offset_of_chunk_end_, index_converter_);
+        return EdgeIter(meta_, begin_global_chunk_index, begin_offset,
+                        chunk_begin_, chunk_end_, offset_of_chunk_begin_,
+                        offset_of_chunk_end_, property_names_);
       } else if (end_offset <= from.cur_offset_) {
         return this->end();
       } else {
-        return EdgeIter(edge_info_, prefix_, adj_list_type_,
-                        from.global_chunk_index_, from.cur_offset_,
+        return EdgeIter(meta_, from.global_chunk_index_, from.cur_offset_,
                         chunk_begin_, chunk_end_, offset_of_chunk_begin_,
-                        offset_of_chunk_end_, index_converter_);
+                        offset_of_chunk_end_, property_names_);
       }
     }
     return this->end();
   }
 
+  /**
+   * @brief Get the incoming neighbors of a vertex, as a view over the adj list
+   *   chunks without copying the ids.
+   *
+   * @param vid The vertex id.
+   * @return The neighbors, or KeyError if the id does not exist.
+   */
+  Result<NeighborList> Neighbors(IdType vid) noexcept {
+    if (neighbor_reader_ == nullptr) {
+      neighbor_reader_ = std::make_shared<AdjListArrowChunkReader>(
+          edge_info_, adj_list_type_, meta_->fs, meta_->path_prefix,
+          meta_->adj_list_manifest, offset_index_);
+    }
+    return NeighborList::load(neighbor_reader_.get(), offset_index_.get(), vid,
+                              false);
+  }
+
+  /**
+   * @brief Get the incoming neighbors of a list of vertices. The vertices are
+   *   expected to be sorted, so that each adj list chunk is read once.
+   *
+   * @param vids The vertex ids.
+   * @return The neighbors of each vertex in the order of vids, or error.
+   */
+  Result<std::vector<NeighborList>> Neighbors(
+      const std::vector<IdType>& vids) noexcept {
+    std::vector<NeighborList> lists;
+    lists.reserve(vids.size());
+    for (auto vid : vids) {
+      GAR_ASSIGN_OR_RAISE(auto list, Neighbors(vid));
+      lists.push_back(std::move(list));
+    }
+    return lists;
+  }
+
  private:
-  EdgeInfo edge_info_;
-  std::string prefix_;
-  IdType chunk_begin_, chunk_end_;
-  IdType offset_of_chunk_begin_, offset_of_chunk_end_;
-  std::shared_ptr<util::IndexConverter> index_converter_;
-  std::shared_ptr<EdgeIter> begin_, end_;
+  std::shared_ptr<OffsetIndex> offset_index_;
+  // the reader of the neighbor lists, created on the first query
+  std::shared_ptr<AdjListArrowChunkReader> neighbor_reader_;
 };
 
 /**
@@ -1069,7 +1627,8 @@ class EdgesCollection<AdjListType::ordered_by_dest> {
  *
  */
 template <>
-class EdgesCollection<AdjListType::unordered_by_source> {
+class EdgesCollection<AdjListType::unordered_by_source>
+    : public EdgesCollectionBase {
  public:
   static const AdjListType adj_list_type_;
 
@@ -1078,29 +1637,13 @@ class EdgesCollection<AdjListType::unordered_by_source> {
    *
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
-  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix)
-      : edge_info_(edge_info), prefix_(prefix), chunk_begin_(0) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto vertex_chunk_num,
-                              fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_end_ = 0;
-    for (size_t i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      chunk_end_ += edge_chunk_nums[i];
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
+  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_end_ = index_converter_->GetChunkNum();
   }
 
   /**
@@ -1110,29 +1653,15 @@ class EdgesCollection<AdjListType::unordered_by_source> {
    * @param prefix The absolute prefix.
    * @param chunk_begin The global index of the begin chunk.
    * @param chunk_end The global index of the end chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType chunk_begin, IdType chunk_end)
-      : edge_info_(edge_info),
-        prefix_(prefix),
-        chunk_begin_(chunk_begin),
-        chunk_end_(chunk_end) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto vertex_chunk_num,
-                              fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    for (size_t i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
+                  IdType chunk_begin, IdType chunk_end,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_begin_ = chunk_begin;
+    chunk_end_ = chunk_end;
     offset_of_chunk_begin_ =
         index_converter_->GlobalChunkIndexToIndexPair(chunk_begin).second *
         edge_info.GetChunkSize();
@@ -1147,60 +1676,24 @@ class EdgesCollection<AdjListType::unordered_by_source> {
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
    * @param vertex_chunk_index The index of the vertex chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType vertex_chunk_index)
-      : edge_info_(edge_info), prefix_(prefix) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    IdType vertex_chunk_num = 0;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num, fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_begin_ = 0;
-    chunk_end_ = 0;
-    for (IdType i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      if (i < vertex_chunk_index) {
-        chunk_begin_ += edge_chunk_nums[i];
-      }
-      if (i == vertex_chunk_index) {
-        chunk_end_ = chunk_begin_ + edge_chunk_nums[i];
-      }
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
-  }
-
-  /** The iterator pointing to the first edge. */
-  EdgeIter begin() {
-    if (begin_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_begin_,
-                    offset_of_chunk_begin_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      begin_ = std::make_shared<EdgeIter>(iter);
-    }
-    return *begin_;
-  }
-
-  /** The iterator pointing to the past-the-end element. */
-  EdgeIter end() {
-    if (end_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_end_,
-                    offset_of_chunk_end_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      end_ = std::make_shared<EdgeIter>(iter);
+                  IdType vertex_chunk_index,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    if (vertex_chunk_index >= 0 &&
+        vertex_chunk_index < index_converter_->GetVertexChunkNum()) {
+      chunk_begin_ =
+          index_converter_->IndexPairToGlobalChunkIndex(vertex_chunk_index, 0);
+      chunk_end_ = index_converter_->IndexPairToGlobalChunkIndex(
+          vertex_chunk_index + 1, 0);
+    } else {
+      chunk_begin_ =
+          vertex_chunk_index < 0 ? 0 : index_converter_->GetChunkNum();
+      chunk_end_ = 0;
     }
-    return *end_;
   }
 
   /**
@@ -1213,13 +1706,8 @@ class EdgesCollection<AdjListType::unordered_by_source> {
    */
   EdgeIter find_src(IdType id, const EdgeIter& from) {
     EdgeIter iter(from);
-    auto end = this->end();
-    while (iter != end) {
-      auto edge = *iter;
-      if (edge.source() == id) {
-        break;
-      }
-      ++iter;
+    if (!iter.first_src(from, id)) {
+      return this->end();
     }
     return iter;
   }
@@ -1234,24 +1722,11 @@ class EdgesCollection<AdjListType::unordered_by_source> {
    */
   EdgeIter find_dst(IdType id, const EdgeIter& from) {
     EdgeIter iter(from);
-    auto end = this->end();
-    while (iter != end) {
-      auto edge = *iter;
-      if (edge.destination() == id) {
-        break;
-      }
-      ++iter;
+    if (!iter.first_dst(from, id)) {
+      return this->end();
     }
     return iter;
   }
-
- private:
-  EdgeInfo edge_info_;
-  std::string prefix_;
-  IdType chunk_begin_, chunk_end_;
-  IdType offset_of_chunk_begin_, offset_of_chunk_end_;
-  std::shared_ptr<util::IndexConverter> index_converter_;
-  std::shared_ptr<EdgeIter> begin_, end_;
 };
 
 /**
@@ -1260,7 +1735,8 @@ class EdgesCollection<AdjListType::unordered_by_source> {
  *
  */
 template <>
-class EdgesCollection<AdjListType::unordered_by_dest> {
+class EdgesCollection<AdjListType::unordered_by_dest>
+    : public EdgesCollectionBase {
  public:
   static const AdjListType adj_list_type_;
 
@@ -1269,29 +1745,13 @@ class EdgesCollection<AdjListType::unordered_by_dest> {
    *
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
-  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix)
-      : edge_info_(edge_info), prefix_(prefix), chunk_begin_(0) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    IdType vertex_chunk_num = 0;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num, fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_end_ = 0;
-    for (IdType i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      chunk_end_ += edge_chunk_nums[i];
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
+  EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_end_ = index_converter_->GetChunkNum();
   }
 
   /**
@@ -1301,29 +1761,15 @@ class EdgesCollection<AdjListType::unordered_by_dest> {
    * @param prefix The absolute prefix.
    * @param chunk_begin The global index of the begin chunk.
    * @param chunk_end The global index of the end chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType chunk_begin, IdType chunk_end)
-      : edge_info_(edge_info),
-        prefix_(prefix),
-        chunk_begin_(chunk_begin),
-        chunk_end_(chunk_end) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto vertex_chunk_num,
-                              fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    for (size_t i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
+                  IdType chunk_begin, IdType chunk_end,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    chunk_begin_ = chunk_begin;
+    chunk_end_ = chunk_end;
     offset_of_chunk_begin_ =
         index_converter_->GlobalChunkIndexToIndexPair(chunk_begin).second *
         edge_info.GetChunkSize();
@@ -1338,60 +1784,24 @@ class EdgesCollection<AdjListType::unordered_by_dest> {
    * @param edge_info The edge info that describes the edge type.
    * @param prefix The absolute prefix.
    * @param vertex_chunk_index The index of the vertex chunk.
+   * @param property_names The properties to read, empty means all the
+   * properties.
    */
   EdgesCollection(const EdgeInfo& edge_info, const std::string& prefix,
-                  IdType vertex_chunk_index)
-      : edge_info_(edge_info), prefix_(prefix) {
-    std::string base_dir;
-    GAR_ASSIGN_OR_RAISE_ERROR(auto fs,
-                              FileSystemFromUriOrPath(prefix, &base_dir));
-    GAR_ASSIGN_OR_RAISE_ERROR(auto dir_path,
-                              edge_info.GetAdjListPathPrefix(adj_list_type_));
-    base_dir += dir_path;
-    IdType vertex_chunk_num = 0;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num, fs->GetFileNumOfDir(base_dir));
-    std::vector<IdType> edge_chunk_nums(vertex_chunk_num, 0);
-    chunk_begin_ = 0;
-    chunk_end_ = 0;
-    for (IdType i = 0; i < vertex_chunk_num; ++i) {
-      std::string chunk_dir = base_dir + "/part" + std::to_string(i);
-      GAR_ASSIGN_OR_RAISE_ERROR(edge_chunk_nums[i],
-                                fs->GetFileNumOfDir(chunk_dir));
-      if (i < vertex_chunk_index) {
-        chunk_begin_ += edge_chunk_nums[i];
-      }
-      if (i == vertex_chunk_index) {
-        chunk_end_ = chunk_begin_ + edge_chunk_nums[i];
-      }
-    }
-    index_converter_ =
-        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
-    offset_of_chunk_begin_ = 0;
-    offset_of_chunk_end_ = 0;
-  }
-
-  /** The iterator pointing to the first edge. */
-  EdgeIter begin() {
-    if (begin_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_begin_,
-                    offset_of_chunk_begin_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      begin_ = std::make_shared<EdgeIter>(iter);
-    }
-    return *begin_;
-  }
-
-  /** The iterator pointing to the past-the-end element. */
-  EdgeIter end() {
-    if (end_ == nullptr) {
-      EdgeIter iter(edge_info_, prefix_, adj_list_type_, chunk_end_,
-                    offset_of_chunk_end_, chunk_begin_, chunk_end_,
-                    offset_of_chunk_begin_, offset_of_chunk_end_,
-                    index_converter_);
-      end_ = std::make_shared<EdgeIter>(iter);
+                  IdType vertex_chunk_index,
+                  const std::vector<std::string>& property_names = {})
+      : EdgesCollectionBase(edge_info, prefix, adj_list_type_, property_names) {
+    if (vertex_chunk_index >= 0 &&
+        vertex_chunk_index < index_converter_->GetVertexChunkNum()) {
+      chunk_begin_ =
+          index_converter_->IndexPairToGlobalChunkIndex(vertex_chunk_index, 0);
+      chunk_end_ = index_converter_->IndexPairToGlobalChunkIndex(
+          vertex_chunk_index + 1, 0);
+    } else {
+      chunk_begin_ =
+          vertex_chunk_index < 0 ? 0 : index_converter_->GetChunkNum();
+      chunk_end_ = 0;
     }
-    return *end_;
   }
 
   /**
@@ -1404,13 +1814,8 @@ class EdgesCollection<AdjListType::unordered_by_dest> {
    */
   EdgeIter find_src(IdType id, const EdgeIter& from) {
     EdgeIter iter(from);
-    auto end = this->end();
-    while (iter != end) {
-      auto edge = *iter;
-      if (edge.source() == id) {
-        break;
-      }
-      ++iter;
+    if (!iter.first_src(from, id)) {
+      return this->end();
     }
     return iter;
   }
@@ -1425,26 +1830,38 @@ class EdgesCollection<AdjListType::unordered_by_dest> {
    */
   EdgeIter find_dst(IdType id, const EdgeIter& from) {
     EdgeIter iter(from);
-    auto end = this->end();
-    while (iter != end) {
-      auto edge = *iter;
-      if (edge.destination() == id) {
-        break;
-      }
-      ++iter;
+    if (!iter.first_dst(from, id)) {
+      return this->end();
     }
     return iter;
   }
-
- private:
-  EdgeInfo edge_info_;
-  std::string prefix_;
-  IdType chunk_begin_, chunk_end_;
-  IdType offset_of_chunk_begin_, offset_of_chunk_end_;
-  std::shared_ptr<util::IndexConverter> index_converter_;
-  std::shared_ptr<EdgeIter> begin_, end_;
 };
 
+/**
+ * @brief Scan the edges of a collection in parallel, chunk by chunk.
+ *
+ * The edge chunks of the collection are split into ranges of about the same
+ * number of edges, a few per thread, and the threads take the ranges of the
+ * others once theirs are done. Each thread reads the chunks through its own
+ * reader, the spans it passes to func hold the offsets of their edges among
+ * all the edges of the collection, as with EdgesCollection::ForEachChunk(),
+ * but not in order.
+ *
+ * @param edges The edges collection.
+ * @param func The function to call with the span of each edge chunk, it is
+ * called concurrently and must be thread-safe. The scan stops at the first
+ * error it returns.
+ * @param num_threads The number of threads, 0 means the number of cores. The
+ * calling thread is one of them.
+ * @return Status: ok or the first error.
+ */
+template <AdjListType adj_list_type>
+Status ParallelForEdges(EdgesCollection<adj_list_type>& edges,
+                        const std::function<Status(const AdjListSpan&)>& func,
+                        int num_threads = 0) noexcept {
+  return edges.ParallelForEachChunk(func, num_threads);
+}
+
 typedef std::variant<EdgesCollection<AdjListType::ordered_by_source>,
                      EdgesCollection<AdjListType::ordered_by_dest>,
                      EdgesCollection<AdjListType::unordered_by_source>,
@@ -1456,13 +1873,45 @@ typedef std::variant<EdgesCollection<AdjListType::ordered_by_source>,
  *
  * @param graph_info The GraphInfo for the graph.
  * @param label The vertex label.
+ * @param property_names The properties to read, empty means all the
+ * properties.
  * @return The constructed collection or error.
  */
 static inline Result<VerticesCollection> ConstructVerticesCollection(
-    const GraphInfo& graph_info, const std::string& label) noexcept {
+    const GraphInfo& graph_info, const std::string& label,
+    const std::vector<std::string>& property_names = {}) noexcept {
   VertexInfo vertex_info;
   GAR_ASSIGN_OR_RAISE(vertex_info, graph_info.GetVertexInfo(label));
-  return VerticesCollection(vertex_info, graph_info.GetPrefix());
+  for (const auto& property_name : property_names) {
+    if (!vertex_info.ContainProperty(property_name)) {
+      return Status::KeyError("The property " + property_name +
+                              " is not in the vertex info.");
+    }
+  }
+  return VerticesCollection(vertex_info, graph_info.GetPrefix(),
+                            property_names);
+}
+
+/**
+ * @brief Check if the properties are in the property groups of the adj list.
+ *
+ * @param edge_info The edge info that describes the edge type.
+ * @param adj_list_type The adjList type.
+ * @param property_names The property names.
+ * @return Status: ok or KeyError.
+ */
+static inline Status CheckEdgeProperties(
+    const EdgeInfo& edge_info, AdjListType adj_list_type,
+    const std::vector<std::string>& property_names) noexcept {
+  for (const auto& property_name : property_names) {
+    if (!edge_info.GetPropertyGroup(property_name, adj_list_type)
+             .status()
+             .ok()) {
+      return Status::KeyError("The property " + property_name +
+                              " is not in the edge info.");
+    }
+  }
+  return Status::OK();
 }
 
 /**
@@ -1473,28 +1922,33 @@ static inline Result<VerticesCollection> ConstructVerticesCollection(
  * @param edge_label The edge label.
  * @param dst_label The destination vertex label.
  * @param adj_list_type The adjList type.
+ * @param property_names The properties to read, empty means all the
+ * properties.
  * @return The constructed collection or error.
  */
 static inline Result<Edges> ConstructEdgesCollection(
     const GraphInfo& graph_info, const std::string& src_label,
     const std::string& edge_label, const std::string& dst_label,
-    AdjListType adj_list_type) noexcept {
+    AdjListType adj_list_type,
+    const std::vector<std::string>& property_names = {}) noexcept {
   EdgeInfo edge_info;
   GAR_ASSIGN_OR_RAISE(edge_info,
                       graph_info.GetEdgeInfo(src_label, edge_label, dst_label));
+  GAR_RETURN_NOT_OK(
+      CheckEdgeProperties(edge_info, adj_list_type, property_names));
   switch (adj_list_type) {
   case AdjListType::ordered_by_source:
     return EdgesCollection<AdjListType::ordered_by_source>(
-        edge_info, graph_info.GetPrefix());
+        edge_info, graph_info.GetPrefix(), property_names);
   case AdjListType::ordered_by_dest:
     return EdgesCollection<AdjListType::ordered_by_dest>(
-        edge_info, graph_info.GetPrefix());
+        edge_info, graph_info.GetPrefix(), property_names);
   case AdjListType::unordered_by_source:
     return EdgesCollection<AdjListType::unordered_by_source>(
-        edge_info, graph_info.GetPrefix());
+        edge_info, graph_info.GetPrefix(), property_names);
   case AdjListType::unordered_by_dest:
     return EdgesCollection<AdjListType::unordered_by_dest>(
-        edge_info, graph_info.GetPrefix());
+        edge_info, graph_info.GetPrefix(), property_names);
   default:
     return Status::Invalid("Invalid adj list type");
   }
@@ -1511,29 +1965,38 @@ static inline Result<Edges> ConstructEdgesCollection(
  * @param adj_list_type The adjList type.
  * @param chunk_begin The global index of the begin chunk.
  * @param chunk_end The global index of the end chunk.
+ * @param property_names The properties to read, empty means all the
+ * properties.
  * @return The constructed collection or error.
  */
 static inline Result<Edges> ConstructEdgesCollection(
     const GraphInfo& graph_info, const std::string& src_label,
     const std::string& edge_label, const std::string& dst_label,
     AdjListType adj_list_type, const IdType chunk_begin,
-    const IdType chunk_end) noexcept {
+    const IdType chunk_end,
+    const std::vector<std::string>& property_names = {}) noexcept {
   EdgeInfo edge_info;
   GAR_ASSIGN_OR_RAISE(edge_info,
                       graph_info.GetEdgeInfo(src_label, edge_label, dst_label));
+  GAR_RETURN_NOT_OK(
+      CheckEdgeProperties(edge_info, adj_list_type, property_names));
   switch (adj_list_type) {
   case AdjListType::ordered_by_source:
     return EdgesCollection<AdjListType::ordered_by_source>(
-        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end);
+        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end,
+        property_names);
   case AdjListType::ordered_by_dest:
     return EdgesCollection<AdjListType::ordered_by_dest>(
-        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end);
+        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end,
+        property_names);
   case AdjListType::unordered_by_source:
     return EdgesCollection<AdjListType::unordered_by_source>(
-        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end);
+        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end,
+        property_names);
   case AdjListType::unordered_by_dest:
     return EdgesCollection<AdjListType::unordered_by_dest>(
-        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end);
+        edge_info, graph_info.GetPrefix(), chunk_begin, chunk_end,
+        property_names);
   default:
     return Status::Invalid("Invalid adj list type");
   }
@@ -1549,28 +2012,37 @@ static inline Result<Edges> ConstructEdgesCollection(
  * @param dst_label The destination vertex label.
  * @param adj_list_type The adjList type.
  * @param vertex_chunk_index The index of the vertex chunk.
+ * @param property_names The properties to read, empty means all the
+ * properties.
  * @return The constructed collection or error.
  */
 static inline Result<Edges> ConstructEdgesCollection(
     const GraphInfo& graph_info, const std::string& src_label,
     const std::string& edge_label, const std::string& dst_label,
-    AdjListType adj_list_type, IdType vertex_chunk_index) noexcept {
+    AdjListType adj_list_type, IdType vertex_chunk_index,
+    const std::vector<std::string>& property_names = {}) noexcept {
   EdgeInfo edge_info;
   GAR_ASSIGN_OR_RAISE(edge_info,
                       graph_info.GetEdgeInfo(src_label, edge_label, dst_label));
+  GAR_RETURN_NOT_OK(
+      CheckEdgeProperties(edge_info, adj_list_type, property_names));
   switch (adj_list_type) {
   case AdjListType::ordered_by_source:
     return EdgesCollection<AdjListType::ordered_by_source>(
-        edge_info, graph_info.GetPrefix(), vertex_chunk_index);
+        edge_info, graph_info.GetPrefix(), vertex_chunk_index,
+        property_names);
   case AdjListType::ordered_by_dest:
     return EdgesCollection<AdjListType::ordered_by_dest>(
-        edge_info, graph_info.GetPrefix(), vertex_chunk_index);
+        edge_info, graph_info.GetPrefix(), vertex_chunk_index,
+        property_names);
   case AdjListType::unordered_by_source:
     return EdgesCollection<AdjListType::unordered_by_source>(
-        edge_info, graph_info.GetPrefix(), vertex_chunk_index);
+        edge_info, graph_info.GetPrefix(), vertex_chunk_index,
+        property_names);
   case AdjListType::unordered_by_dest:
     return EdgesCollection<AdjListType::unordered_by_dest>(
-        edge_info, graph_info.GetPrefix(), vertex_chunk_index);
+        edge_info, graph_info.GetPrefix(), vertex_chunk_index,
+        property_names);
   default:
     return Status::Invalid("Invalid adj list type");
   }
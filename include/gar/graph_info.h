@@ -28,6 +28,7 @@ limitations under the License.
 #include "utils/status.h"
 #include "utils/utils.h"
 #include "utils/version_parser.h"
+#include "utils/writer_options.h"
 #include "utils/yaml.h"
 
 namespace GAR_NAMESPACE_INTERNAL {
@@ -77,10 +78,16 @@ class PropertyGroup {
    * @param file_type File type of property group chunk file
    * @param prefix prefix of property group chunk file. The default
    *        prefix is the concatenation of property names with '_' as separator
+   * @param writer_options The options of encoding the chunk files, the
+   *        defaults of the writers by default
    */
   explicit PropertyGroup(std::vector<Property> properties, FileType file_type,
-                         const std::string& prefix = "")
-      : properties_(properties), file_type_(file_type), prefix_(prefix) {
+                         const std::string& prefix = "",
+                         const WriterOptions& writer_options = {})
+      : properties_(properties),
+        file_type_(file_type),
+        prefix_(prefix),
+        writer_options_(writer_options) {
     if (prefix_.empty()) {
       std::vector<std::string> names;
       for (auto& property : properties_) {
@@ -131,16 +138,26 @@ class PropertyGroup {
    */
   inline const std::string& GetPrefix() const { return prefix_; }
 
+  /** Get the options of encoding the property group chunk files.
+   *
+   * @return The writer options of group.
+   */
+  inline const WriterOptions& GetWriterOptions() const {
+    return writer_options_;
+  }
+
  private:
   std::vector<Property> properties_;
   FileType file_type_;
   std::string prefix_;
+  WriterOptions writer_options_;
 };
 
 static bool operator==(const PropertyGroup& lhs, const PropertyGroup& rhs) {
   return (lhs.GetPrefix() == rhs.GetPrefix()) &&
          (lhs.GetFileType() == rhs.GetFileType()) &&
-         (lhs.GetProperties() == rhs.GetProperties());
+         (lhs.GetProperties() == rhs.GetProperties()) &&
+         (lhs.GetWriterOptions() == rhs.GetWriterOptions());
 }
 
 /**
@@ -533,11 +550,14 @@ class EdgeInfo {
    * chunk file.
    * @param prefix The prefix of the adjacency list topology chunk (optional,
    * default is empty).
+   * @param writer_options The options of encoding the topology and offset
+   * chunk files (optional, default is the defaults of the writers).
    * @return A Status object indicating success or an error if the adjacency
    * list type has already been added.
    */
   Status AddAdjList(const AdjListType& adj_list_type, FileType file_type,
-                    const std::string& prefix = "") {
+                    const std::string& prefix = "",
+                    const WriterOptions& writer_options = {}) {
     if (ContainAdjList(adj_list_type)) {
       return Status::InvalidOperation(
           "The adj list type has already existed in edge info.");
@@ -550,6 +570,7 @@ class EdgeInfo {
       adj_list2prefix_[adj_list_type] = prefix;
     }
     adj_list2file_type_[adj_list_type] = file_type;
+    adj_list2writer_options_[adj_list_type] = writer_options;
     adj_list2property_groups_[adj_list_type];  // init an empty property groups
     return Status::OK();
   }
@@ -701,6 +722,23 @@ class EdgeInfo {
     return adj_list2file_type_.at(adj_list_type);
   }
 
+  /**
+   * Get the options of encoding the topology and offset chunk files of the
+   * given adjacency list type.
+   *
+   * @param adj_list_type The adjacency list type.
+   * @return A Result object containing the writer options, or a Status object
+   * indicating an KeyError if the adjacency list type is not found in the edge
+   * info.
+   */
+  inline Result<const WriterOptions&> GetWriterOptions(
+      AdjListType adj_list_type) const noexcept {
+    if (!ContainAdjList(adj_list_type)) {
+      return Status::KeyError("The adj list type is not found in edge info.");
+    }
+    return adj_list2writer_options_.at(adj_list_type);
+  }
+
   /**
    * @brief Get the property groups for the given adjacency list type.
    *
@@ -898,15 +936,18 @@ class EdgeInfo {
    * chunk file.
    * @param prefix The prefix of the adjacency list topology chunk (optional,
    * default is empty).
+   * @param writer_options The options of encoding the topology and offset
+   * chunk files (optional, default is the defaults of the writers).
    * @return A Result object containing the new EdgeInfo object, or a Status
    * object indicating an error.
    */
-  const Result<EdgeInfo> ExtendAdjList(AdjListType adj_list_type,
-                                       FileType file_type,
-                                       const std::string& prefix = "") const
-      noexcept {
+  const Result<EdgeInfo> ExtendAdjList(
+      AdjListType adj_list_type, FileType file_type,
+      const std::string& prefix = "",
+      const WriterOptions& writer_options = {}) const noexcept {
     EdgeInfo new_info(*this);
-    GAR_RETURN_NOT_OK(new_info.AddAdjList(adj_list_type, file_type, prefix));
+    GAR_RETURN_NOT_OK(new_info.AddAdjList(adj_list_type, file_type, prefix,
+                                          writer_options));
     return new_info;
   }
 
@@ -982,6 +1023,7 @@ class EdgeInfo {
   std::map<std::string, std::map<AdjListType, size_t>> p2group_index_;
   std::map<AdjListType, std::string> adj_list2prefix_;
   std::map<AdjListType, FileType> adj_list2file_type_;
+  std::map<AdjListType, WriterOptions> adj_list2writer_options_;
   std::map<AdjListType, std::vector<PropertyGroup>> adj_list2property_groups_;
 };
 
@@ -22,6 +22,8 @@ limitations under the License.
 #include <vector>
 
 #include "gar/graph_info.h"
+#include "gar/reader/offset_index.h"
+#include "gar/utils/chunk_manifest.h"
 #include "gar/utils/data_type.h"
 #include "gar/utils/filesystem.h"
 #include "gar/utils/reader_utils.h"
@@ -78,8 +80,7 @@ class VertexPropertyArrowChunkReader {
     IdType pre_chunk_index = chunk_index_;
     chunk_index_ = id / vertex_info_.GetChunkSize();
     if (chunk_index_ != pre_chunk_index) {
-      // TODO(@acezen): use a cache to avoid reloading the same chunk, could use
-      //  a LRU cache.
+      // the chunk is kept in the global ChunkCache, seeking back is cheap
       chunk_table_.reset();
     }
     if (chunk_index_ >= chunk_num_) {
@@ -90,6 +91,9 @@ class VertexPropertyArrowChunkReader {
 
   /**
    * @brief Return the current arrow chunk table of chunk position indicator.
+   *
+   * If the chunk is not cached, the Parquet row groups before the one that
+   * contains the position indicator are not decoded.
    */
   Result<std::shared_ptr<arrow::Table>> GetChunk() noexcept;
 
@@ -120,6 +124,29 @@ class VertexPropertyArrowChunkReader {
    */
   IdType GetChunkNum() const noexcept { return chunk_num_; }
 
+  /**
+   * @brief Only read the given properties of the property group, the other
+   *    columns of the chunks are not decoded.
+   *
+   * @param property_names The names of the properties to read, empty means
+   *    all the properties of the property group.
+   * @return Status: ok or KeyError if a property is not in the property group.
+   */
+  Status SelectProperties(
+      const std::vector<std::string>& property_names) noexcept;
+
+  /**
+   * @brief Read ahead the next depth chunks after each chunk loaded, see
+   *   ChunkCache::Prefetch().
+   *
+   * @param depth The number of chunks to read ahead, 0 disables read-ahead.
+   */
+  void SetPrefetchDepth(IdType depth) noexcept { prefetch_depth_ = depth; }
+
+ private:
+  // read ahead the chunks after the current chunk
+  void prefetch() noexcept;
+
  private:
   VertexInfo vertex_info_;
   PropertyGroup property_group_;
@@ -129,6 +156,12 @@ class VertexPropertyArrowChunkReader {
   IdType chunk_num_;
   std::shared_ptr<arrow::Table> chunk_table_;
   std::shared_ptr<FileSystem> fs_;
+  // the selected columns, empty means all
+  std::vector<std::string> columns_;
+  IdType prefetch_depth_ = 0;
+  // the index of the first row of chunk_table_ in the chunk, the rows before
+  // it are not read
+  IdType chunk_table_offset_ = 0;
 };
 
 /**
@@ -159,11 +192,47 @@ class AdjListArrowChunkReader {
     GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
                               edge_info.GetAdjListPathPrefix(adj_list_type));
     base_dir_ = prefix_ + adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num_,
-                              fs_->GetFileNumOfDir(base_dir_));
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE_ERROR(manifest_, ChunkManifest::Make(fs_, base_dir_));
+    vertex_chunk_num_ = manifest_->GetVertexChunkNum();
+    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_,
+                              manifest_->GetChunkNum(vertex_chunk_index_));
+  }
+
+  /**
+   * @brief Initialize the AdjListArrowChunkReader with an opened file system
+   * and the manifest of the adj list, which does no I/O.
+   *
+   * @param edge_info The edge info that describes the edge type.
+   * @param adj_list_type The adj list type for the edge.
+   * @param fs The file system of the graph.
+   * @param path_prefix The prefix path in the file system.
+   * @param manifest The manifest of the adj list chunks.
+   * @param offset_index The offset index of the ordered adj list, created on
+   * the first seek by vertex id if it is nullptr.
+   * @param vertex_chunk_index The vertex chunk index, default is 0.
+   */
+  AdjListArrowChunkReader(const EdgeInfo& edge_info, AdjListType adj_list_type,
+                          std::shared_ptr<FileSystem> fs,
+                          const std::string& path_prefix,
+                          std::shared_ptr<ChunkManifest> manifest,
+                          std::shared_ptr<OffsetIndex> offset_index,
+                          IdType vertex_chunk_index = 0)
+      : edge_info_(edge_info),
+        adj_list_type_(adj_list_type),
+        prefix_(path_prefix),
+        vertex_chunk_index_(vertex_chunk_index),
+        chunk_index_(0),
+        seek_offset_(0),
+        chunk_table_(nullptr),
+        fs_(std::move(fs)),
+        manifest_(std::move(manifest)),
+        offset_index_(std::move(offset_index)) {
+    GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
+                              edge_info.GetAdjListPathPrefix(adj_list_type));
+    base_dir_ = prefix_ + adj_list_path_prefix;
+    vertex_chunk_num_ = manifest_->GetVertexChunkNum();
+    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_,
+                              manifest_->GetChunkNum(vertex_chunk_index_));
   }
 
   /**
@@ -180,7 +249,10 @@ class AdjListArrowChunkReader {
         vertex_chunk_num_(other.vertex_chunk_num_),
         chunk_num_(other.chunk_num_),
         base_dir_(other.base_dir_),
-        fs_(other.fs_) {}
+        fs_(other.fs_),
+        manifest_(other.manifest_),
+        offset_index_(other.offset_index_),
+        prefetch_depth_(other.prefetch_depth_) {}
 
   /**
    * @brief Sets chunk position indicator for reader by source vertex id.
@@ -218,6 +290,9 @@ class AdjListArrowChunkReader {
 
   /**
    * @brief Return the current chunk of chunk position indicator as arrow::Table
+   *
+   * If the chunk is not cached, the Parquet row groups before the one that
+   * contains the position indicator are not decoded.
    */
   Result<std::shared_ptr<arrow::Table>> GetChunk() noexcept;
 
@@ -242,9 +317,8 @@ class AdjListArrowChunkReader {
         return Status::OutOfRange();
       }
       chunk_index_ = 0;
-      std::string chunk_dir =
-          base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-      GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+      GAR_ASSIGN_OR_RAISE(chunk_num_,
+                          manifest_->GetChunkNum(vertex_chunk_index_));
     }
     seek_offset_ = chunk_index_ * edge_info_.GetChunkSize();
     chunk_table_.reset();
@@ -261,9 +335,8 @@ class AdjListArrowChunkReader {
   Status seek_chunk_index(IdType vertex_chunk_index, IdType chunk_index = 0) {
     if (vertex_chunk_index_ != vertex_chunk_index) {
       vertex_chunk_index_ = vertex_chunk_index;
-      std::string chunk_dir =
-          base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-      GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+      GAR_ASSIGN_OR_RAISE(chunk_num_,
+                          manifest_->GetChunkNum(vertex_chunk_index_));
       chunk_table_.reset();
     }
     if (chunk_index_ != chunk_index) {
@@ -274,6 +347,23 @@ class AdjListArrowChunkReader {
     return Status::OK();
   }
 
+  /**
+   * @brief Read ahead the next depth chunks after each chunk loaded, see
+   *   ChunkCache::Prefetch().
+   *
+   * @param depth The number of chunks to read ahead, 0 disables read-ahead.
+   */
+  void SetPrefetchDepth(IdType depth) noexcept { prefetch_depth_ = depth; }
+
+  /** Get the chunk manifest of the adj list. */
+  const std::shared_ptr<ChunkManifest>& GetManifest() const noexcept {
+    return manifest_;
+  }
+
+ private:
+  // read ahead the chunks after the current chunk
+  void prefetch() noexcept;
+
  private:
   EdgeInfo edge_info_;
   AdjListType adj_list_type_;
@@ -284,6 +374,16 @@ class AdjListArrowChunkReader {
   IdType vertex_chunk_num_, chunk_num_;
   std::string base_dir_;
   std::shared_ptr<FileSystem> fs_;
+  // the edge chunk numbers of the vertex chunks, shared by the copies of the
+  // reader
+  std::shared_ptr<ChunkManifest> manifest_;
+  // shared by the copies of the reader, created on the first seek by vertex id
+  // of an ordered adj list
+  std::shared_ptr<OffsetIndex> offset_index_;
+  IdType prefetch_depth_ = 0;
+  // the index of the first row of chunk_table_ in the chunk, the rows before
+  // it are not read
+  IdType chunk_table_offset_ = 0;
 };
 
 /**
@@ -372,6 +472,18 @@ class AdjListOffsetArrowChunkReader {
    */
   IdType GetChunkIndex() noexcept { return chunk_index_; }
 
+  /**
+   * @brief Read ahead the next depth chunks after each chunk loaded, see
+   *   ChunkCache::Prefetch().
+   *
+   * @param depth The number of chunks to read ahead, 0 disables read-ahead.
+   */
+  void SetPrefetchDepth(IdType depth) noexcept { prefetch_depth_ = depth; }
+
+ private:
+  // read ahead the chunks after the current chunk
+  void prefetch() noexcept;
+
  private:
   EdgeInfo edge_info_;
   AdjListType adj_list_type_;
@@ -383,6 +495,7 @@ class AdjListOffsetArrowChunkReader {
   IdType vertex_chunk_size_;
   std::string base_dir_;
   std::shared_ptr<FileSystem> fs_;
+  IdType prefetch_depth_ = 0;
 };
 
 /**
@@ -418,11 +531,52 @@ class AdjListPropertyArrowChunkReader {
         auto pg_path_prefix,
         edge_info.GetPropertyGroupPathPrefix(property_group, adj_list_type));
     base_dir_ = prefix_ + pg_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num_,
-                              fs_->GetFileNumOfDir(base_dir_));
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE_ERROR(manifest_, ChunkManifest::Make(fs_, base_dir_));
+    vertex_chunk_num_ = manifest_->GetVertexChunkNum();
+    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_,
+                              manifest_->GetChunkNum(vertex_chunk_index_));
+  }
+
+  /**
+   * @brief Initialize the AdjListPropertyArrowChunkReader with an opened file
+   * system and the manifest of the property group, which does no I/O.
+   *
+   * @param edge_info The edge info that describes the edge type.
+   * @param property_group The property group that describes the property group.
+   * @param adj_list_type The adj list type for the edges.
+   * @param fs The file system of the graph.
+   * @param path_prefix The prefix path in the file system.
+   * @param manifest The manifest of the property group chunks.
+   * @param offset_index The offset index of the ordered adj list, created on
+   * the first seek by vertex id if it is nullptr.
+   * @param vertex_chunk_index The vertex chunk index, default is 0.
+   */
+  AdjListPropertyArrowChunkReader(const EdgeInfo& edge_info,
+                                  const PropertyGroup& property_group,
+                                  AdjListType adj_list_type,
+                                  std::shared_ptr<FileSystem> fs,
+                                  const std::string& path_prefix,
+                                  std::shared_ptr<ChunkManifest> manifest,
+                                  std::shared_ptr<OffsetIndex> offset_index,
+                                  IdType vertex_chunk_index = 0)
+      : edge_info_(edge_info),
+        property_group_(property_group),
+        adj_list_type_(adj_list_type),
+        prefix_(path_prefix),
+        vertex_chunk_index_(vertex_chunk_index),
+        chunk_index_(0),
+        seek_offset_(0),
+        chunk_table_(nullptr),
+        fs_(std::move(fs)),
+        manifest_(std::move(manifest)),
+        offset_index_(std::move(offset_index)) {
+    GAR_ASSIGN_OR_RAISE_ERROR(
+        auto pg_path_prefix,
+        edge_info.GetPropertyGroupPathPrefix(property_group, adj_list_type));
+    base_dir_ = prefix_ + pg_path_prefix;
+    vertex_chunk_num_ = manifest_->GetVertexChunkNum();
+    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_,
+                              manifest_->GetChunkNum(vertex_chunk_index_));
   }
 
   /**
@@ -440,7 +594,11 @@ class AdjListPropertyArrowChunkReader {
         vertex_chunk_num_(other.vertex_chunk_num_),
         chunk_num_(other.chunk_num_),
         base_dir_(other.base_dir_),
-        fs_(other.fs_) {}
+        fs_(other.fs_),
+        manifest_(other.manifest_),
+        offset_index_(other.offset_index_),
+        columns_(other.columns_),
+        prefetch_depth_(other.prefetch_depth_) {}
 
   /**
    * @brief Sets chunk position indicator for reader by source vertex id.
@@ -479,6 +637,9 @@ class AdjListPropertyArrowChunkReader {
 
   /**
    * @brief Return the current chunk of chunk position indicator as arrow::Table
+   *
+   * If the chunk is not cached, the Parquet row groups before the one that
+   * contains the position indicator are not decoded.
    */
   Result<std::shared_ptr<arrow::Table>> GetChunk() noexcept;
 
@@ -498,9 +659,8 @@ class AdjListPropertyArrowChunkReader {
         return Status::OutOfRange();
       }
       chunk_index_ = 0;
-      std::string chunk_dir =
-          base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-      GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+      GAR_ASSIGN_OR_RAISE(chunk_num_,
+                          manifest_->GetChunkNum(vertex_chunk_index_));
     }
     seek_offset_ = chunk_index_ * edge_info_.GetChunkSize();
     chunk_table_.reset();
@@ -517,9 +677,8 @@ class AdjListPropertyArrowChunkReader {
   Status seek_chunk_index(IdType vertex_chunk_index, IdType chunk_index = 0) {
     if (vertex_chunk_index_ != vertex_chunk_index) {
       vertex_chunk_index_ = vertex_chunk_index;
-      std::string chunk_dir =
-          base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-      GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+      GAR_ASSIGN_OR_RAISE(chunk_num_,
+                          manifest_->GetChunkNum(vertex_chunk_index_));
       chunk_table_.reset();
     }
     if (chunk_index_ != chunk_index) {
@@ -530,6 +689,29 @@ class AdjListPropertyArrowChunkReader {
     return Status::OK();
   }
 
+  /**
+   * @brief Only read the given properties of the property group, the other
+   *    columns of the chunks are not decoded.
+   *
+   * @param property_names The names of the properties to read, empty means
+   *    all the properties of the property group.
+   * @return Status: ok or KeyError if a property is not in the property group.
+   */
+  Status SelectProperties(
+      const std::vector<std::string>& property_names) noexcept;
+
+  /**
+   * @brief Read ahead the next depth chunks after each chunk loaded, see
+   *   ChunkCache::Prefetch().
+   *
+   * @param depth The number of chunks to read ahead, 0 disables read-ahead.
+   */
+  void SetPrefetchDepth(IdType depth) noexcept { prefetch_depth_ = depth; }
+
+ private:
+  // read ahead the chunks after the current chunk
+  void prefetch() noexcept;
+
  private:
   EdgeInfo edge_info_;
   PropertyGroup property_group_;
@@ -541,6 +723,18 @@ class AdjListPropertyArrowChunkReader {
   IdType vertex_chunk_num_, chunk_num_;
   std::string base_dir_;
   std::shared_ptr<FileSystem> fs_;
+  // the edge chunk numbers of the vertex chunks, shared by the copies of the
+  // reader
+  std::shared_ptr<ChunkManifest> manifest_;
+  // shared by the copies of the reader, created on the first seek by vertex id
+  // of an ordered adj list
+  std::shared_ptr<OffsetIndex> offset_index_;
+  // the selected columns, empty means all
+  std::vector<std::string> columns_;
+  IdType prefetch_depth_ = 0;
+  // the index of the first row of chunk_table_ in the chunk, the rows before
+  // it are not read
+  IdType chunk_table_offset_ = 0;
 };
 
 /**
@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include "gar/graph_info.h"
+#include "gar/utils/chunk_manifest.h"
 #include "gar/utils/data_type.h"
 #include "gar/utils/filesystem.h"
 #include "gar/utils/reader_utils.h"
@@ -134,11 +135,10 @@ class AdjListChunkInfoReader {
     GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_path_prefix,
                               edge_info.GetAdjListPathPrefix(adj_list_type));
     base_dir_ = prefix_ + adj_list_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num_,
-                              fs_->GetFileNumOfDir(base_dir_));
-    std::string chunk_dir =
-        base_dir_ + "part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE_ERROR(manifest_, ChunkManifest::Make(fs_, base_dir_));
+    vertex_chunk_num_ = manifest_->GetVertexChunkNum();
+    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_,
+                              manifest_->GetChunkNum(vertex_chunk_index_));
   }
 
   /**
@@ -191,9 +191,8 @@ class AdjListChunkInfoReader {
         return Status::OutOfRange();
       }
       chunk_index_ = 0;
-      std::string chunk_dir =
-          base_dir_ + "part" + std::to_string(vertex_chunk_index_);
-      GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+      GAR_ASSIGN_OR_RAISE(chunk_num_,
+                          manifest_->GetChunkNum(vertex_chunk_index_));
     }
     return Status::OK();
   }
@@ -206,6 +205,7 @@ class AdjListChunkInfoReader {
   IdType vertex_chunk_num_, chunk_num_;
   std::string base_dir_;  // the chunk files base dir
   std::shared_ptr<FileSystem> fs_;
+  std::shared_ptr<ChunkManifest> manifest_;
 };
 
 /**
@@ -236,11 +236,10 @@ class AdjListPropertyChunkInfoReader {
         auto pg_path_prefix,
         edge_info.GetPropertyGroupPathPrefix(property_group, adj_list_type));
     base_dir_ = prefix_ + pg_path_prefix;
-    GAR_ASSIGN_OR_RAISE_ERROR(vertex_chunk_num_,
-                              fs_->GetFileNumOfDir(base_dir_));
-    std::string chunk_dir =
-        base_dir_ + "part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE_ERROR(manifest_, ChunkManifest::Make(fs_, base_dir_));
+    vertex_chunk_num_ = manifest_->GetVertexChunkNum();
+    GAR_ASSIGN_OR_RAISE_ERROR(chunk_num_,
+                              manifest_->GetChunkNum(vertex_chunk_index_));
   }
 
   /**
@@ -294,9 +293,8 @@ class AdjListPropertyChunkInfoReader {
         return Status::OutOfRange();
       }
       chunk_index_ = 0;
-      std::string chunk_dir =
-          base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-      GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+      GAR_ASSIGN_OR_RAISE(chunk_num_,
+                          manifest_->GetChunkNum(vertex_chunk_index_));
     }
     return Status::OK();
   }
@@ -310,6 +308,7 @@ class AdjListPropertyChunkInfoReader {
   IdType vertex_chunk_num_, chunk_num_;
   std::string base_dir_;  // the chunk files base dir
   std::shared_ptr<FileSystem> fs_;
+  std::shared_ptr<ChunkManifest> manifest_;
 };
 
 /**
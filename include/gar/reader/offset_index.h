@@ -0,0 +1,143 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef GAR_READER_OFFSET_INDEX_H_
+#define GAR_READER_OFFSET_INDEX_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gar/graph_info.h"
+#include "gar/utils/chunk_manifest.h"
+#include "gar/utils/filesystem.h"
+#include "gar/utils/result.h"
+#include "gar/utils/status.h"
+#include "gar/utils/utils.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+/**
+ * @brief The resident index of the adj list offsets of an ordered adj list.
+ *
+ * The offset chunks are loaded once, lazily on first access or eagerly by
+ * LoadAll(), and kept as contiguous int64 arrays, so that looking up the
+ * offset range of a vertex is O(1) after its offset chunk is loaded. The index
+ * is thread-safe and is meant to be shared by the readers and iterators of the
+ * same adj list.
+ */
+class OffsetIndex {
+ public:
+  using range_t = std::pair<IdType, IdType>;
+
+  /**
+   * @brief Create an OffsetIndex.
+   *
+   * @param edge_info The edge info that describes the edge type.
+   * @param adj_list_type The adj list type for the edges, must be
+   *    AdjListType::ordered_by_source or AdjListType::ordered_by_dest.
+   * @param prefix The absolute prefix.
+   * @return The offset index or error.
+   */
+  static Result<std::shared_ptr<OffsetIndex>> Make(
+      const EdgeInfo& edge_info, AdjListType adj_list_type,
+      const std::string& prefix) noexcept;
+
+  /**
+   * @brief Create an OffsetIndex with an opened file system.
+   *
+   * @param edge_info The edge info that describes the edge type.
+   * @param adj_list_type The adj list type for the edges, must be
+   *    AdjListType::ordered_by_source or AdjListType::ordered_by_dest.
+   * @param fs The file system of the graph.
+   * @param path_prefix The prefix path in the file system.
+   * @return The offset index or error.
+   */
+  static Result<std::shared_ptr<OffsetIndex>> Make(
+      const EdgeInfo& edge_info, AdjListType adj_list_type,
+      std::shared_ptr<FileSystem> fs, const std::string& path_prefix) noexcept;
+
+  /**
+   * @brief Create an OffsetIndex with an opened file system and the number of
+   *   vertex chunks recorded by a manifest.
+   *
+   * The offset directory is listed only if the manifest is listed too, see
+   * ChunkManifest::IsListed().
+   *
+   * @param edge_info The edge info that describes the edge type.
+   * @param adj_list_type The adj list type for the edges, must be
+   *    AdjListType::ordered_by_source or AdjListType::ordered_by_dest.
+   * @param fs The file system of the graph.
+   * @param path_prefix The prefix path in the file system.
+   * @param manifest The manifest of the adj list or of one of its property
+   * groups.
+   * @return The offset index or error.
+   */
+  static Result<std::shared_ptr<OffsetIndex>> Make(
+      const EdgeInfo& edge_info, AdjListType adj_list_type,
+      std::shared_ptr<FileSystem> fs, const std::string& path_prefix,
+      const std::shared_ptr<ChunkManifest>& manifest) noexcept;
+
+  OffsetIndex(const OffsetIndex&) = delete;
+  OffsetIndex& operator=(const OffsetIndex&) = delete;
+
+  /**
+   * @brief Get the offset range of the edges of a vertex.
+   *
+   * @param id The vertex id.
+   * @return Result: std::pair<begin_offset, end_offset> in the vertex chunk of
+   *   the id, or KeyError if the id does not exist.
+   */
+  Result<range_t> GetOffsetRange(IdType id) noexcept;
+
+  /** Load all the offset chunks. */
+  Status LoadAll() noexcept;
+
+  /** Get the number of vertex chunks. */
+  IdType GetVertexChunkNum() const noexcept { return vertex_chunk_num_; }
+
+  /** Get the vertex chunk size of the adj list. */
+  IdType GetVertexChunkSize() const noexcept { return vertex_chunk_size_; }
+
+ private:
+  OffsetIndex(const EdgeInfo& edge_info, AdjListType adj_list_type,
+              std::shared_ptr<FileSystem> fs, const std::string& path_prefix,
+              IdType vertex_chunk_num);
+
+  // check that the adj list is ordered
+  static Status checkAdjListType(AdjListType adj_list_type);
+
+  // load the offset chunk if it is not loaded yet
+  Result<const std::vector<IdType>*> getChunk(IdType vertex_chunk_index);
+
+ private:
+  EdgeInfo edge_info_;
+  AdjListType adj_list_type_;
+  std::shared_ptr<FileSystem> fs_;
+  std::string path_prefix_;
+  IdType vertex_chunk_num_;
+  IdType vertex_chunk_size_;
+  std::vector<std::vector<IdType>> chunks_;
+  std::unique_ptr<std::atomic<bool>[]> loaded_;
+  // one mutex per offset chunk, so that the loads of different chunks run
+  // concurrently and each chunk is loaded once
+  std::unique_ptr<std::mutex[]> mutexes_;
+};
+
+}  // namespace GAR_NAMESPACE_INTERNAL
+#endif  // GAR_READER_OFFSET_INDEX_H_
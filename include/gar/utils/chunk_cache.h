@@ -0,0 +1,223 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef GAR_UTILS_CHUNK_CACHE_H_
+#define GAR_UTILS_CHUNK_CACHE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gar/utils/result.h"
+
+// forward declarations
+namespace arrow {
+class Table;
+}  // namespace arrow
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+/** The statistics of a ChunkCache. */
+struct ChunkCacheStats {
+  /** The number of lookups served from the cache or by a pending load. */
+  int64_t hits = 0;
+  /** The number of lookups that had to load the chunk. */
+  int64_t misses = 0;
+  /** The number of chunks scheduled to load in the background. */
+  int64_t prefetches = 0;
+  /** The number of entries dropped to stay within the capacity. */
+  int64_t evictions = 0;
+  /** The number of cached chunks. */
+  int64_t num_entries = 0;
+  /** The total buffer size of the cached chunks, in bytes. */
+  int64_t size = 0;
+  /** The capacity of the cache, in bytes. */
+  int64_t capacity = 0;
+};
+
+/**
+ * @brief A thread-safe, byte-budgeted LRU cache of decoded chunk tables.
+ *
+ * Entries are keyed by the chunk file path and the projected columns, so the
+ * same file read with different projections is cached separately. A chunk is
+ * loaded at most once at a time: lookups of a chunk that is being loaded, in
+ * the foreground or by Prefetch(), wait for that load instead of reading the
+ * file again. The cache
+ * assumes that chunk files are immutable while cached: the FileSystem write
+ * methods invalidate the paths they write, any other modification of the
+ * files must be followed by Invalidate() or Clear().
+ *
+ * All the arrow chunk readers share the process-wide instance returned by
+ * Global(); set its capacity to 0 to disable caching.
+ */
+class ChunkCache {
+ public:
+  using Loader = std::function<Result<std::shared_ptr<arrow::Table>>()>;
+
+  /** The default capacity of the global cache, 256 MiB. */
+  static constexpr int64_t kDefaultCapacity = 256LL * 1024 * 1024;
+
+  /**
+   * @brief Initialize the ChunkCache.
+   *
+   * @param capacity The capacity of the cache in bytes, 0 disables caching.
+   */
+  explicit ChunkCache(int64_t capacity = kDefaultCapacity) noexcept
+      : capacity_(capacity) {}
+
+  /** Wait for the background loads of the cache to finish. */
+  ~ChunkCache();
+
+  ChunkCache(const ChunkCache&) = delete;
+  ChunkCache& operator=(const ChunkCache&) = delete;
+
+  /** Get the process-wide cache shared by the chunk readers. */
+  static ChunkCache& Global() noexcept;
+
+  /**
+   * @brief Get the chunk table of the path, load and cache it on a miss.
+   *
+   * The loader is called without holding the cache lock, a chunk larger than
+   * the capacity is returned but not cached.
+   *
+   * @param path The path of the chunk file.
+   * @param columns The projected columns, empty means all columns.
+   * @param loader The function to load the chunk table on a miss.
+   * @return The chunk table or the error returned by the loader.
+   */
+  Result<std::shared_ptr<arrow::Table>> GetOrLoad(
+      const std::string& path, const std::vector<std::string>& columns,
+      const Loader& loader) noexcept;
+
+  /**
+   * @brief Get the chunk table of the path if it is cached, or wait for it if
+   *   it is being loaded. A lookup that finds nothing is not counted as a miss.
+   *
+   * @param path The path of the chunk file.
+   * @param columns The projected columns, empty means all columns.
+   * @return The chunk table, or nullptr if it is not cached.
+   */
+  std::shared_ptr<arrow::Table> Get(
+      const std::string& path,
+      const std::vector<std::string>& columns) noexcept;
+
+  /**
+   * @brief Load the chunk table of the path into the cache in the background.
+   *
+   * The chunk readers prefetch the next chunks each time they load a chunk,
+   * up to the depth set by their SetPrefetchDepth(), so that a sequential
+   * scan overlaps reading and decoding with the work on the current chunk.
+   * The prefetched chunks are kept only if the capacity is not zero.
+   *
+   * The loader runs on a thread pool dedicated to the prefetches, not on the
+   * arrow IO thread pool: the file readers schedule their reads on the IO
+   * pool and wait for them, which would deadlock once the loaders occupy all
+   * its threads. It does nothing if the chunk is cached or being loaded.
+   * Errors of the loader are not reported, the following GetOrLoad() of the
+   * chunk returns them. The loader must not reference the caller's stack
+   * since it may run after Prefetch() returns.
+   *
+   * @param path The path of the chunk file.
+   * @param columns The projected columns, empty means all columns.
+   * @param loader The function to load the chunk table.
+   */
+  void Prefetch(const std::string& path,
+                const std::vector<std::string>& columns,
+                Loader loader) noexcept;
+
+  /**
+   * @brief Drop all the cached entries of the path.
+   *
+   * @param path The path of the chunk file.
+   */
+  void Invalidate(const std::string& path) noexcept;
+
+  /**
+   * @brief Drop all the cached entries, the chunks being loaded are not
+   *   cached when their loads finish.
+   */
+  void Clear() noexcept;
+
+  /**
+   * @brief Set the capacity of the cache, evicting entries if necessary.
+   *
+   * @param capacity The capacity in bytes, 0 disables caching.
+   */
+  void SetCapacity(int64_t capacity) noexcept;
+
+  /** Get the capacity of the cache in bytes. */
+  int64_t GetCapacity() const noexcept;
+
+  /** Get the statistics of the cache. */
+  ChunkCacheStats GetStats() const noexcept;
+
+  /** Reset the hit, miss and eviction counters. */
+  void ResetStats() noexcept;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<arrow::Table> table;
+    int64_t size;
+  };
+
+  using Promise = std::promise<Result<std::shared_ptr<arrow::Table>>>;
+
+  // a chunk being loaded, the lookups of the chunk wait on the future
+  struct Pending {
+    std::shared_ptr<Promise> promise;
+    std::shared_future<Result<std::shared_ptr<arrow::Table>>> future;
+  };
+
+  static std::string makeKey(const std::string& path,
+                             const std::vector<std::string>& columns);
+
+  // register a pending load of the key, the caller must hold mutex_
+  std::shared_ptr<Promise> addPending(const std::string& key);
+
+  // run the loader of a pending load, cache the result if the load is still
+  // current and fulfill its promise
+  Result<std::shared_ptr<arrow::Table>> load(
+      const std::string& key, const Loader& loader,
+      const std::shared_ptr<Promise>& promise);
+
+  // evict the least recently used entries until the size fits the capacity,
+  // the caller must hold mutex_
+  void evict();
+
+  mutable std::mutex mutex_;
+  int64_t capacity_;
+  int64_t size_ = 0;
+  int64_t hits_ = 0, misses_ = 0, prefetches_ = 0, evictions_ = 0;
+  // the most recently used entry is at the front
+  std::list<Entry> lru_;
+  // ordered by key so that all the projections of a path are adjacent
+  std::map<std::string, std::list<Entry>::iterator> index_;
+  // the chunks being loaded, ordered by key as index_
+  std::map<std::string, Pending> pending_;
+  // the number of running background loads
+  int64_t running_ = 0;
+  std::condition_variable idle_;
+};
+
+}  // namespace GAR_NAMESPACE_INTERNAL
+#endif  // GAR_UTILS_CHUNK_CACHE_H_
@@ -0,0 +1,245 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef GAR_UTILS_CHUNK_MANIFEST_H_
+#define GAR_UTILS_CHUNK_MANIFEST_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gar/utils/file_type.h"
+#include "gar/utils/filesystem.h"
+#include "gar/utils/result.h"
+#include "gar/utils/status.h"
+#include "gar/utils/utils.h"
+
+// forward declaration
+namespace arrow {
+class Table;
+}  // namespace arrow
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+/** The range of the source and destination ids of an adj list chunk. */
+struct ChunkZoneMap {
+  IdType src_min;
+  IdType src_max;
+  IdType dst_min;
+  IdType dst_max;
+
+  /** Whether the chunk may have an edge with the source id. */
+  bool MayContainSrc(IdType id) const noexcept {
+    return src_min <= id && id <= src_max;
+  }
+
+  /** Whether the chunk may have an edge with the destination id. */
+  bool MayContainDst(IdType id) const noexcept {
+    return dst_min <= id && id <= dst_max;
+  }
+};
+
+/**
+ * @brief The manifest of the edge chunks of an adj list or a property group.
+ *
+ * The chunks of an adj list or an edge property group are stored as
+ * <dir>/part<i>/chunk<j>. The manifest records, for each vertex chunk i, the
+ * number of edge chunks, the total number of rows and the total size in bytes
+ * of the chunk files, so that opening a reader or a collection reads a single
+ * file instead of listing every part<i> directory. The manifest of an adj list
+ * also records the zone map of each edge chunk, the range of its source and
+ * destination ids, with which the lookups by the unsorted id skip the chunks
+ * that cannot contain it. The manifest is stored beside the directory as
+ * <dir>.manifest.yml, see GetPath().
+ *
+ * The manifest is written by EdgeChunkWriter::WriteManifest() and
+ * EdgesBuilder::Dump(), and deleted by the EdgeChunkWriter that writes a chunk
+ * of the directory afterwards, until it is written again. The data written
+ * without a manifest is still readable, Make() falls back to listing the
+ * directories. The manifest is thread-safe and is
+ * meant to be shared by the readers and iterators of the same directory.
+ */
+class ChunkManifest {
+ public:
+  /** The suffix of the manifest path appended to the directory. */
+  static constexpr const char* kSuffix = ".manifest.yml";
+
+  /**
+   * @brief Initialize the ChunkManifest.
+   *
+   * @param chunk_nums The number of edge chunks of each vertex chunk.
+   * @param row_nums The number of rows of each vertex chunk, or empty if
+   * unknown.
+   * @param sizes The size in bytes of each vertex chunk, or empty if unknown.
+   * @param zone_maps The zone map of each edge chunk in the order of the
+   * global chunk index, or empty if unknown.
+   */
+  explicit ChunkManifest(std::vector<IdType> chunk_nums,
+                         std::vector<IdType> row_nums = {},
+                         std::vector<int64_t> sizes = {},
+                         std::vector<ChunkZoneMap> zone_maps = {}) noexcept
+      : chunk_nums_(std::move(chunk_nums)),
+        row_nums_(std::move(row_nums)),
+        sizes_(std::move(sizes)),
+        zone_maps_(std::move(zone_maps)) {}
+
+  ChunkManifest(const ChunkManifest&) = delete;
+  ChunkManifest& operator=(const ChunkManifest&) = delete;
+
+  /**
+   * @brief Get the manifest of a chunk directory, read from its manifest file
+   * or, if there is none, counted by listing the directories. The part<i>
+   * directories are listed lazily, on the first access to their chunk
+   * numbers.
+   *
+   * @param fs The file system of the graph.
+   * @param dir_path The path of the chunk directory.
+   * @return The manifest or error.
+   */
+  static Result<std::shared_ptr<ChunkManifest>> Make(
+      const std::shared_ptr<FileSystem>& fs,
+      const std::string& dir_path) noexcept;
+
+  /**
+   * @brief Collect the manifest of a chunk directory from the files, the
+   * Parquet and ORC chunks are counted from their metadata.
+   *
+   * @param fs The file system of the graph.
+   * @param dir_path The path of the chunk directory.
+   * @param file_type The type of the chunk files.
+   * @param vertex_chunk_num The number of vertex chunks, the part<i>
+   * directories that do not exist have no edge chunks. -1 means the number
+   * of part<i> directories.
+   * @param with_zone_maps Whether to collect the zone maps of the chunks,
+   * which reads the source and destination columns of the adj list chunks.
+   * @return The manifest or error.
+   */
+  static Result<std::shared_ptr<ChunkManifest>> Build(
+      const std::shared_ptr<FileSystem>& fs, const std::string& dir_path,
+      FileType file_type, IdType vertex_chunk_num = -1,
+      bool with_zone_maps = false) noexcept;
+
+  /**
+   * @brief Get the zone map of an adj list chunk in memory, the range of an
+   * empty chunk is empty.
+   *
+   * @param table The adj list chunk with the source and destination columns.
+   * @return The zone map, or Invalid if the table is not an adj list chunk.
+   */
+  static Result<ChunkZoneMap> MakeZoneMap(
+      const std::shared_ptr<arrow::Table>& table) noexcept;
+
+  /**
+   * @brief Read the zone map of an adj list chunk file.
+   *
+   * @param fs The file system of the graph.
+   * @param path The path of the chunk file.
+   * @param file_type The type of the chunk file.
+   * @return The zone map or error.
+   */
+  static Result<ChunkZoneMap> ReadZoneMap(const std::shared_ptr<FileSystem>& fs,
+                                          const std::string& path,
+                                          FileType file_type) noexcept;
+
+  /**
+   * @brief Write the manifest of a chunk directory.
+   *
+   * @param fs The file system of the graph.
+   * @param dir_path The path of the chunk directory.
+   * @return Status: ok or error.
+   */
+  Status Dump(const std::shared_ptr<FileSystem>& fs,
+              const std::string& dir_path) noexcept;
+
+  /** Get the path of the manifest of a chunk directory. */
+  static std::string GetPath(const std::string& dir_path) noexcept;
+
+  /** Get the number of vertex chunks. */
+  IdType GetVertexChunkNum() const noexcept {
+    return static_cast<IdType>(chunk_nums_.size());
+  }
+
+  /**
+   * @brief Get the number of edge chunks of a vertex chunk.
+   *
+   * @param vertex_chunk_index The index of the vertex chunk.
+   * @return The number of edge chunks, or KeyError if the vertex chunk does
+   * not exist.
+   */
+  Result<IdType> GetChunkNum(IdType vertex_chunk_index) noexcept;
+
+  /** Get the number of edge chunks of each vertex chunk. */
+  Result<std::vector<IdType>> GetChunkNums() noexcept;
+
+  /**
+   * Whether the manifest is counted by listing the directories, since there
+   * is no manifest file.
+   */
+  bool IsListed() const noexcept { return fs_ != nullptr; }
+
+  /** Whether the row numbers and sizes are recorded by the manifest. */
+  bool HasStatistics() const noexcept {
+    return row_nums_.size() == chunk_nums_.size() &&
+           sizes_.size() == chunk_nums_.size();
+  }
+
+  /**
+   * @brief Get the number of rows of each vertex chunk.
+   *
+   * @return The row numbers, empty if HasStatistics() is false.
+   */
+  const std::vector<IdType>& GetRowNums() const noexcept { return row_nums_; }
+
+  /**
+   * @brief Get the size in bytes of the chunk files of each vertex chunk.
+   *
+   * @return The sizes, empty if HasStatistics() is false.
+   */
+  const std::vector<int64_t>& GetSizes() const noexcept { return sizes_; }
+
+  /** Whether the zone maps of the edge chunks are recorded by the manifest. */
+  bool HasZoneMaps() const noexcept { return !zone_maps_.empty(); }
+
+  /**
+   * @brief Get the zone map of each edge chunk, indexed by the global chunk
+   *   index.
+   *
+   * @return The zone maps, empty if HasZoneMaps() is false.
+   */
+  const std::vector<ChunkZoneMap>& GetZoneMaps() const noexcept {
+    return zone_maps_;
+  }
+
+ private:
+  // the caller must hold mutex_
+  Result<IdType> getChunkNum(IdType vertex_chunk_index);
+
+  // -1 if the number is not listed yet
+  std::vector<IdType> chunk_nums_;
+  std::vector<IdType> row_nums_;
+  std::vector<int64_t> sizes_;
+  std::vector<ChunkZoneMap> zone_maps_;
+  // the file system and the directory to list the part<i> directories
+  // without a manifest file
+  std::shared_ptr<FileSystem> fs_;
+  std::string dir_path_;
+  std::mutex mutex_;
+};
+
+}  // namespace GAR_NAMESPACE_INTERNAL
+#endif  // GAR_UTILS_CHUNK_MANIFEST_H_
@@ -18,16 +18,22 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "gar/utils/file_type.h"
 #include "gar/utils/result.h"
 #include "gar/utils/status.h"
 #include "gar/utils/utils.h"
+#include "gar/utils/writer_options.h"
 
 // forward declarations
 namespace arrow {
 class Buffer;
 class Table;
+namespace compute {
+class Expression;
+}
 namespace fs {
 class FileSystem;
 }
@@ -54,17 +60,95 @@ class FileSystem {
 
   ~FileSystem() = default;
 
+  /** The default maximum number of rows of a Parquet row group. */
+  static constexpr int64_t kDefaultRowGroupSize = 64 * 1024 * 1024;
+
   /**
    * @brief Read a file as an arrow::Table.
    *
    * @param path The path of the file to read.
    * @param file_type The type of the file to read.
+   * @param columns The names of the columns to read, empty means all the
+   * columns. Only the selected columns are decoded.
    * @return A Result containing a std::shared_ptr to an arrow::Table if
    * successful, or an error Status if unsuccessful.
    */
   Result<std::shared_ptr<arrow::Table>> ReadFileToTable(
+      const std::string& path, FileType file_type,
+      const std::vector<std::string>& columns = {}) const noexcept;
+
+  /**
+   * @brief Read the rows of a file starting from the row group that contains
+   * the given row, the row groups before it are not decoded.
+   *
+   * Only Parquet files are read by row groups, the other file types are read
+   * entirely.
+   *
+   * @param path The path of the file to read.
+   * @param file_type The type of the file to read.
+   * @param row The index of the row in the file.
+   * @param columns The names of the columns to read, empty means all the
+   * columns.
+   * @return A Result containing the table and the index of its first row in
+   * the file, or an error Status if unsuccessful.
+   */
+  Result<std::pair<std::shared_ptr<arrow::Table>, int64_t>>
+  ReadFileToTableFromRow(
+      const std::string& path, FileType file_type, int64_t row,
+      const std::vector<std::string>& columns = {}) const noexcept;
+
+  /**
+   * @brief Get the number of rows of each row group of a Parquet file, from
+   * its metadata.
+   *
+   * @param path The path of the file.
+   * @param file_type The type of the file, the other file types have a single
+   * row group of all the rows.
+   * @return The numbers of rows of the row groups, or an error Status if
+   * unsuccessful.
+   */
+  Result<std::vector<int64_t>> GetRowGroupRowNums(
       const std::string& path, FileType file_type) const noexcept;
 
+  /**
+   * @brief Read the given row groups of a Parquet file, each as a table.
+   *
+   * @param path The path of the file.
+   * @param file_type The type of the file, which must be Parquet.
+   * @param row_groups The indices of the row groups to read.
+   * @param columns The names of the columns to read, empty means all the
+   * columns.
+   * @return The tables of the row groups in the given order, or an error
+   * Status if unsuccessful.
+   */
+  Result<std::vector<std::shared_ptr<arrow::Table>>> ReadFileRowGroups(
+      const std::string& path, FileType file_type,
+      const std::vector<int>& row_groups,
+      const std::vector<std::string>& columns = {}) const noexcept;
+
+  /**
+   * @brief Read the rows of a file that may satisfy a filter.
+   *
+   * The Parquet row groups whose column statistics prove that none of their
+   * rows satisfy the filter are not read, the other file types are read
+   * entirely. The filter itself is not evaluated on the rows read.
+   *
+   * @param path The path of the file to read.
+   * @param file_type The type of the file to read.
+   * @param filter The boolean filter expression, bound to a schema whose
+   * fields of the same names as the columns of the file have the same types.
+   * @param columns The names of the columns to read, empty means all the
+   * columns.
+   * @return A Result containing the tables of the consecutive row groups read,
+   * each with the index of its first row in the file, or an error Status if
+   * unsuccessful.
+   */
+  Result<std::vector<std::pair<int64_t, std::shared_ptr<arrow::Table>>>>
+  ReadFileToTablesWithFilter(
+      const std::string& path, FileType file_type,
+      const arrow::compute::Expression& filter,
+      const std::vector<std::string>& columns = {}) const noexcept;
+
   /**
    * @brief Read a file and convert its bytes to a value of type T.
    *
@@ -93,11 +177,15 @@ class FileSystem {
    * @param input_table The table to write.
    * @param file_type The type of the output file.
    * @param path The path of the output file.
+   * @param row_group_size The maximum number of rows of a row group, only
+   * used by Parquet files and ORC files if the options do not set it.
+   * @param options The encoding options, see WriterOptions.
    * @return A Status indicating OK if successful, or an error if unsuccessful.
    */
   Status WriteTableToFile(const std::shared_ptr<arrow::Table>& table,
-                          FileType file_type, const std::string& path) const
-      noexcept;
+                          FileType file_type, const std::string& path,
+                          int64_t row_group_size = kDefaultRowGroupSize,
+                          const WriterOptions& options = {}) const noexcept;
 
   /**
    * Copy a file.
@@ -108,6 +196,14 @@ class FileSystem {
   Status CopyFile(const std::string& src_path,
                   const std::string& dst_path) const noexcept;
 
+  /**
+   * @brief Delete a file, if it exists.
+   *
+   * @param path The path of the file.
+   * @return A Status indicating OK if successful, or an error if unsuccessful.
+   */
+  Status DeleteFile(const std::string& path) const noexcept;
+
   /**
    * Get the number of file of a directory.
    *
@@ -116,6 +212,37 @@ class FileSystem {
   Result<size_t> GetFileNumOfDir(const std::string& dir_path,
                                  bool recursive = false) const noexcept;
 
+  /**
+   * @brief Check whether a file exists.
+   *
+   * @param path The path of the file.
+   * @return True if the path is a file, false if it does not exist, or an
+   * error Status if the file system can not be accessed.
+   */
+  Result<bool> FileExists(const std::string& path) const noexcept;
+
+  /**
+   * @brief Get the size of a file.
+   *
+   * @param path The path of the file.
+   * @return The size of the file in bytes, or an error Status if
+   * unsuccessful.
+   */
+  Result<int64_t> GetFileSize(const std::string& path) const noexcept;
+
+  /**
+   * @brief Get the number of rows of a file.
+   *
+   * Parquet and ORC files are counted from their metadata, the other file
+   * types are read entirely.
+   *
+   * @param path The path of the file.
+   * @param file_type The type of the file.
+   * @return The number of rows, or an error Status if unsuccessful.
+   */
+  Result<int64_t> GetRowNumOfFile(const std::string& path,
+                                  FileType file_type) const noexcept;
+
  private:
   std::shared_ptr<arrow::fs::FileSystem> arrow_fs_;
 };
@@ -16,15 +16,156 @@ limitations under the License.
 #ifndef GAR_UTILS_READER_UTILS_H_
 #define GAR_UTILS_READER_UTILS_H_
 
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gar/graph_info.h"
+#include "gar/utils/filesystem.h"
+
+// forward declarations
+namespace arrow {
+class Table;
+}  // namespace arrow
 
 namespace GAR_NAMESPACE_INTERNAL {
 
+class ChunkManifest;
+
 namespace utils {
 
+/**
+ * @brief Read a chunk file as arrow::Table through the global ChunkCache.
+ *
+ * @param fs The file system to read the chunk file from.
+ * @param path The path of the chunk file.
+ * @param file_type The file type of the chunk file.
+ * @param columns The names of the columns to read, empty means all columns.
+ */
+Result<std::shared_ptr<arrow::Table>> ReadChunkTable(
+    const std::shared_ptr<FileSystem>& fs, const std::string& path,
+    FileType file_type, const std::vector<std::string>& columns = {}) noexcept;
+
+/**
+ * @brief Read the rows of a chunk file starting from the row group that
+ *   contains the given row, the row groups before it are not decoded.
+ *
+ * The chunk is taken from the global ChunkCache if it is cached. Otherwise
+ * each row group read is added to the cache by itself, so that the later reads
+ * of the chunk only decode the row groups not read yet, and random lookups in
+ * a chunk cost a row group once the chunk is warm. A read from the first row
+ * group reads and caches the whole chunk.
+ *
+ * @param fs The file system to read the chunk file from.
+ * @param path The path of the chunk file.
+ * @param file_type The file type of the chunk file.
+ * @param row The index of the row in the chunk.
+ * @param columns The names of the columns to read, empty means all columns.
+ * @return The table and the index of its first row in the chunk.
+ */
+Result<std::pair<std::shared_ptr<arrow::Table>, IdType>> ReadChunkTableFromRow(
+    const std::shared_ptr<FileSystem>& fs, const std::string& path,
+    FileType file_type, IdType row,
+    const std::vector<std::string>& columns = {}) noexcept;
+
+/**
+ * @brief Load a chunk file into the global ChunkCache in the background, the
+ *   following ReadChunkTable() of the same file and columns waits for the
+ *   load instead of reading the file again.
+ *
+ * @param fs The file system to read the chunk file from.
+ * @param path The path of the chunk file.
+ * @param file_type The file type of the chunk file.
+ * @param columns The names of the columns to read, empty means all columns.
+ */
+void PrefetchChunkTable(const std::shared_ptr<FileSystem>& fs,
+                        const std::string& path, FileType file_type,
+                        const std::vector<std::string>& columns = {}) noexcept;
+
+/**
+ * @brief Get the properties of a property group that are selected.
+ *
+ * @param property_group The property group.
+ * @param property_names The names of the selected properties.
+ * @return The names of the selected properties of the property group, in the
+ *   order of the property group.
+ */
+std::vector<std::string> GetSelectedProperties(
+    const PropertyGroup& property_group,
+    const std::vector<std::string>& property_names) noexcept;
+
+/** The position of a property among the columns read by an iterator. */
+struct PropertyPosition {
+  /** The index of the property group among the property groups read. */
+  int group_index = -1;
+  /** The index of the property among the columns read of its group. */
+  int column_index = -1;
+  /** The index of the property among the columns read of all the groups. */
+  int slot = -1;
+};
+
+/**
+ * @brief Get the position of a property among the columns read from the
+ *   property groups with the selected properties, the same way as the vertex
+ *   and edge iterators read them.
+ *
+ * @param property_groups The property groups of the vertex or edge type.
+ * @param property The name of the property.
+ * @param property_names The names of the selected properties, empty means all
+ *   the properties.
+ * @return The position of the property, or KeyError if the property is not
+ *   read.
+ */
+Result<PropertyPosition> GetPropertyPosition(
+    const std::vector<PropertyGroup>& property_groups,
+    const std::string& property,
+    const std::vector<std::string>& property_names) noexcept;
+
+/**
+ * @brief Get the number of edge chunks of each vertex chunk of an adj list,
+ *   from the chunk manifest of the adj list if it has one, see ChunkManifest.
+ *
+ * @param edge_info The edge info that describes the edge type.
+ * @param prefix The absolute prefix of the graph.
+ * @param adj_list_type The adj list type.
+ * @return The numbers of edge chunks, indexed by the vertex chunk index.
+ */
+Result<std::vector<IdType>> GetEdgeChunkNums(
+    const EdgeInfo& edge_info, const std::string& prefix,
+    AdjListType adj_list_type) noexcept;
+
+/**
+ * @brief Get the number of edges of each vertex chunk of an adj list, from
+ *   the statistics of the chunk manifest of the adj list if it has them, or
+ *   else from the number of rows of the last edge chunk of each vertex chunk.
+ *
+ * @param edge_info The edge info that describes the edge type.
+ * @param prefix The absolute prefix of the graph.
+ * @param adj_list_type The adj list type.
+ * @return The numbers of edges, indexed by the vertex chunk index.
+ */
+Result<std::vector<IdType>> GetEdgeNums(const EdgeInfo& edge_info,
+                                        const std::string& prefix,
+                                        AdjListType adj_list_type) noexcept;
+
+/**
+ * @brief Get the number of edges of each vertex chunk of an adj list with its
+ *   chunk manifest already opened, which does no I/O if the manifest has the
+ *   statistics.
+ *
+ * @param edge_info The edge info that describes the edge type.
+ * @param fs The file system of the graph.
+ * @param base_dir The prefix of the graph in the file system.
+ * @param adj_list_type The adj list type.
+ * @param manifest The chunk manifest of the adj list.
+ * @return The numbers of edges, indexed by the vertex chunk index.
+ */
+Result<std::vector<IdType>> GetEdgeNums(
+    const EdgeInfo& edge_info, const std::shared_ptr<FileSystem>& fs,
+    const std::string& base_dir, AdjListType adj_list_type,
+    const std::shared_ptr<ChunkManifest>& manifest) noexcept;
+
 Result<std::pair<IdType, IdType>> GetAdjListOffsetOfVertex(
     const EdgeInfo& edge_info, const std::string& prefix,
     AdjListType adj_list_type, IdType vid) noexcept;
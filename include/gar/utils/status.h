@@ -117,6 +117,14 @@ class Status {
       : state_((s.state_ == nullptr) ? nullptr : new State(*s.state_)) {}
   /**  Move the specified status. */
   inline Status(Status&& s) noexcept : state_(s.state_) { s.state_ = nullptr; }
+  /** Copy assignment operator. */
+  inline Status& operator=(const Status& s) {
+    if (this != &s) {
+      delete state_;
+      state_ = (s.state_ == nullptr) ? nullptr : new State(*s.state_);
+    }
+    return *this;
+  }
   /** Move assignment operator. */
   inline Status& operator=(Status&& s) noexcept {
     delete state_;
@@ -16,9 +16,13 @@ limitations under the License.
 #ifndef GAR_UTILS_UTILS_H_
 #define GAR_UTILS_UTILS_H_
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -40,34 +44,56 @@ using IdType = int64_t;
 
 namespace util {
 
+/**
+ * @brief Convert the global index of an edge chunk to the pair of its vertex
+ *   chunk index and its index in the vertex chunk, and back.
+ *
+ * The converter holds the prefix sums of the numbers of edge chunks, so the
+ * conversions take constant and logarithmic time in the number of vertex
+ * chunks. It is immutable once built and shared by the iterators of a
+ * collection.
+ */
 struct IndexConverter {
   explicit IndexConverter(std::vector<IdType>&& edge_chunk_nums)
-      : edge_chunk_nums_(std::move(edge_chunk_nums)) {}
-  IdType IndexPairToGlobalChunkIndex(IdType vertex_chunk_index,
-                                     IdType edge_chunk_index) {
-    IdType global_edge_chunk_index = 0;
-    for (IdType i = 0; i < vertex_chunk_index; ++i) {
-      global_edge_chunk_index += edge_chunk_nums_[i];
+      : chunk_offsets_(edge_chunk_nums.size() + 1, 0) {
+    for (size_t i = 0; i < edge_chunk_nums.size(); ++i) {
+      chunk_offsets_[i + 1] = chunk_offsets_[i] + edge_chunk_nums[i];
     }
-    return global_edge_chunk_index + edge_chunk_index;
   }
 
-  // covert edge global chunk index to <vertex_chunk_index, edge_chunk_index>
-  std::pair<IdType, IdType> GlobalChunkIndexToIndexPair(IdType global_index) {
-    std::pair<IdType, IdType> index_pair(0, 0);
-    for (size_t i = 0; i < edge_chunk_nums_.size(); ++i) {
-      if (global_index < edge_chunk_nums_[i]) {
-        index_pair.first = static_cast<IdType>(i);
-        index_pair.second = global_index;
-        break;
-      }
-      global_index -= edge_chunk_nums_[i];
+  IdType IndexPairToGlobalChunkIndex(IdType vertex_chunk_index,
+                                     IdType edge_chunk_index) const {
+    return chunk_offsets_[vertex_chunk_index] + edge_chunk_index;
+  }
+
+  // covert edge global chunk index to <vertex_chunk_index, edge_chunk_index>,
+  // an index out of range is converted to <0, 0>
+  std::pair<IdType, IdType> GlobalChunkIndexToIndexPair(
+      IdType global_index) const {
+    if (global_index < 0 || global_index >= chunk_offsets_.back()) {
+      return std::make_pair(0, 0);
     }
-    return index_pair;
+    // the last vertex chunk that begins at or before the edge chunk, which
+    // skips the vertex chunks without edge chunks
+    auto it = std::upper_bound(chunk_offsets_.begin(), chunk_offsets_.end(),
+                               global_index) -
+              1;
+    return std::make_pair(static_cast<IdType>(it - chunk_offsets_.begin()),
+                          global_index - *it);
   }
 
+  /** Get the number of vertex chunks. */
+  IdType GetVertexChunkNum() const {
+    return static_cast<IdType>(chunk_offsets_.size()) - 1;
+  }
+
+  /** Get the total number of edge chunks. */
+  IdType GetChunkNum() const { return chunk_offsets_.back(); }
+
  private:
-  std::vector<IdType> edge_chunk_nums_;
+  // the global index of the first edge chunk of each vertex chunk, followed
+  // by the total number of edge chunks
+  std::vector<IdType> chunk_offsets_;
 };
 
 static inline IdType IndexPairToGlobalChunkIndex(
@@ -105,6 +131,39 @@ std::shared_ptr<arrow::Array> GetArrowArrayByChunkIndex(
 Result<const void*> GetArrowArrayData(
     std::shared_ptr<arrow::Array> const& array);
 
+/**
+ * @brief The contiguous values of a column of a chunk table, for the rows
+ *   [begin, end) of a reader.
+ */
+struct ColumnCursor {
+  /** The array that holds the values. */
+  std::shared_ptr<arrow::Array> array;
+  /** The values, as returned by GetArrowArrayData(). */
+  const void* data = nullptr;
+  /** The offset of the first row of the values. */
+  int64_t begin = 0;
+  /** The offset past the last row of the values. */
+  int64_t end = 0;
+  /** The index of the vertex chunk of the rows, for the edge readers. */
+  int64_t vertex_chunk_index = -1;
+};
+
+/**
+ * @brief Point a cursor to the values of a column of a chunk table.
+ *
+ * @param chunk_table The chunk table sliced at the row of offset.
+ * @param offset The offset of the first row of the table.
+ * @param column_index The expected index of the column, the column is looked
+ *   up by its name if the table has another column there.
+ * @param name The name of the column.
+ * @param cursor The cursor to point to the first contiguous values of the
+ *   column, at least one row.
+ * @return Status: ok or error.
+ */
+Status LoadColumnCursor(std::shared_ptr<arrow::Table> const& chunk_table,
+                        int64_t offset, int column_index,
+                        const std::string& name, ColumnCursor* cursor);
+
 static inline std::string ConcatStringWithDelimiter(
     const std::vector<std::string>& str_vec, const std::string& delimiter) {
   return std::accumulate(
@@ -114,6 +173,47 @@ static inline std::string ConcatStringWithDelimiter(
       });
 }
 
+/**
+ * @brief Call func(i) for each i in [0, n) on a number of threads, which take
+ *   the indices in order. The loop stops at the first error.
+ *
+ * @param n The number of indices.
+ * @param num_threads The number of threads, 0 means all the cores.
+ * @param func The function returning Status to call.
+ * @return The first error, or ok.
+ */
+template <typename Func>
+Status ParallelFor(int64_t n, int num_threads, Func&& func) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  num_threads = static_cast<int>(std::min<int64_t>(num_threads, n));
+  std::atomic<int64_t> next(0);
+  std::atomic<bool> failed(false);
+  std::mutex status_mutex;
+  Status status = Status::OK();
+  auto worker = [&]() {
+    for (int64_t i = next++; i < n && !failed.load(); i = next++) {
+      auto st = func(i);
+      if (!st.ok()) {
+        std::lock_guard<std::mutex> lock(status_mutex);
+        if (!failed.exchange(true)) {
+          status = std::move(st);
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+}
+
 template <typename T>
 struct ValueGetter {
   inline static T Value(const void* data, int64_t offset) {
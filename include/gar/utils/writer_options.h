@@ -0,0 +1,86 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef GAR_UTILS_WRITER_OPTIONS_H_
+#define GAR_UTILS_WRITER_OPTIONS_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "gar/utils/macros.h"
+#include "gar/utils/status.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+/**
+ * @brief The options of encoding the chunk files of a property group or an
+ *   adj list, stored as "writer_options" in the info YAML.
+ *
+ * The options that are not set take the defaults of the writer: ZSTD with
+ * its default level, the row group size of the writer, and the defaults of
+ * Arrow for the others. CSV files ignore all of them, ORC files use the codec,
+ * the row group size as the row index stride and the dictionary switch. The
+ * options are checked by Validate() when the info is loaded and when a chunk
+ * is written.
+ */
+struct WriterOptions {
+  /**
+   * The compression codec, "uncompressed", "snappy", "gzip", "lz4", "zstd",
+   * "brotli" or "bz2", empty means ZSTD. The codec must be built into Arrow.
+   */
+  std::string compression;
+  /** The compression level of the codec. */
+  std::optional<int> compression_level;
+  /** The maximum number of rows of a row group of the Parquet files. */
+  std::optional<int64_t> row_group_size;
+  /** Whether to encode the columns with dictionaries. */
+  std::optional<bool> dictionary;
+  /** The size in bytes of a data page of the Parquet files. */
+  std::optional<int64_t> page_size;
+  /** Whether to write the column statistics of the Parquet files. */
+  std::optional<bool> statistics;
+  /**
+   * Whether to write the page index of the Parquet files, which requires
+   * Arrow 12 or later.
+   */
+  std::optional<bool> page_index;
+
+  /** Whether none of the options is set. */
+  bool Empty() const noexcept {
+    return compression.empty() && !compression_level && !row_group_size &&
+           !dictionary && !page_size && !statistics && !page_index;
+  }
+
+  /**
+   * @brief Check that the options can be written with the Arrow library.
+   *
+   * @return Status: ok, or Invalid if the codec is unknown or not built into
+   * Arrow, or if the page index is enabled below Arrow 12.
+   */
+  Status Validate() const noexcept;
+};
+
+static inline bool operator==(const WriterOptions& lhs,
+                              const WriterOptions& rhs) {
+  return lhs.compression == rhs.compression &&
+         lhs.compression_level == rhs.compression_level &&
+         lhs.row_group_size == rhs.row_group_size &&
+         lhs.dictionary == rhs.dictionary && lhs.page_size == rhs.page_size &&
+         lhs.statistics == rhs.statistics && lhs.page_index == rhs.page_index;
+}
+
+}  // namespace GAR_NAMESPACE_INTERNAL
+#endif  // GAR_UTILS_WRITER_OPTIONS_H_
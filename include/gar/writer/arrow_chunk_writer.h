@@ -16,11 +16,17 @@ limitations under the License.
 #ifndef GAR_WRITER_ARROW_CHUNK_WRITER_H_
 #define GAR_WRITER_ARROW_CHUNK_WRITER_H_
 
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gar/graph_info.h"
+#include "gar/utils/chunk_manifest.h"
 #include "gar/utils/data_type.h"
 #include "gar/utils/filesystem.h"
 #include "gar/utils/general_params.h"
@@ -30,8 +36,11 @@ limitations under the License.
 
 // forward declaration
 namespace arrow {
+class RecordBatch;
+class RecordBatchReader;
+class Schema;
 class Table;
-}
+}  // namespace arrow
 
 namespace GAR_NAMESPACE_INTERNAL {
 
@@ -82,6 +91,42 @@ class VertexPropertyWriter {
    */
   inline ValidateLevel GetValidateLevel() const { return validate_level_; }
 
+  /**
+   * @brief Set the maximum number of rows of a row group of the Parquet
+   * chunks, smaller row groups let the readers seek inside a chunk without
+   * decoding the rows before the seek position. The row group size of the
+   * writer options of a property group or an adj list takes precedence.
+   *
+   * @param row_group_size The maximum number of rows of a row group.
+   */
+  inline void SetRowGroupSize(int64_t row_group_size) {
+    row_group_size_ = row_group_size;
+  }
+
+  /**
+   * @brief Get the maximum number of rows of a row group.
+   *
+   * @return The row group size of this writer.
+   */
+  inline int64_t GetRowGroupSize() const { return row_group_size_; }
+
+  /**
+   * @brief Set the number of threads with which WriteTable() encodes and
+   * writes the chunks of the property groups concurrently. The chunks are
+   * written serially by default.
+   *
+   * @param num_threads The number of threads, 1 by default, 0 means all the
+   * cores.
+   */
+  inline void SetNumThreads(int num_threads) { num_threads_ = num_threads; }
+
+  /**
+   * @brief Get the number of threads of WriteTable().
+   *
+   * @return The number of threads of this writer, 0 means all the cores.
+   */
+  inline int GetNumThreads() const { return num_threads_; }
+
   /**
    * @brief Check if the write opeartion is allowed.
    *
@@ -144,6 +189,10 @@ class VertexPropertyWriter {
    * @brief Write a single property group for multiple vertex chunks
    * to corresponding files.
    *
+   * The chunks are written concurrently on GetNumThreads() threads. If any
+   * chunk fails, the chunks written by the call are deleted and the first
+   * error is returned.
+   *
    * @param input_table The table containing data.
    * @param property_group The property group.
    * @param start_chunk_index The start index of the vertex chunks.
@@ -157,6 +206,10 @@ class VertexPropertyWriter {
    * @brief Write all property groups for multiple vertex chunks
    * to corresponding files.
    *
+   * The chunks of all the groups are written concurrently on GetNumThreads()
+   * threads. If any chunk fails, the chunks written by the call are deleted
+   * and the first error is returned.
+   *
    * @param input_table The table containing data.
    * @param start_chunk_index The start index of the vertex chunks.
    * @return Status: ok or error.
@@ -165,10 +218,115 @@ class VertexPropertyWriter {
                     IdType start_chunk_index) const noexcept;
 
  private:
+  // write the chunks of the property groups from the start chunk index on
+  // num_threads_ threads, and delete the written chunks if any write fails
+  Status writeTable(const std::shared_ptr<arrow::Table>& input_table,
+                    const std::vector<PropertyGroup>& property_groups,
+                    IdType start_chunk_index) const noexcept;
+
   VertexInfo vertex_info_;
   std::string prefix_;
   std::shared_ptr<FileSystem> fs_;
   ValidateLevel validate_level_;
+  int64_t row_group_size_ = FileSystem::kDefaultRowGroupSize;
+  int num_threads_ = 1;
+};
+
+/**
+ * @brief The writer that writes the vertex property group chunks from a stream
+ * of record batches.
+ *
+ * The record batches may have arbitrary sizes. The rows are buffered only
+ * until a vertex chunk is complete, then the chunk of all the property groups
+ * is written at once, so the peak memory is about one chunk instead of the
+ * whole vertex table. The chunks are written from chunk 0 in order, and
+ * Finish() writes the last partial chunk and the number of vertices.
+ */
+class VertexStreamWriter {
+ public:
+  /**
+   * @brief Initialize the VertexStreamWriter.
+   *
+   * @param vertex_info The vertex info that describes the vertex type.
+   * @param prefix The absolute prefix.
+   * @param validate_level The validate level, with no validate by default.
+   */
+  VertexStreamWriter(
+      const VertexInfo& vertex_info, const std::string& prefix,
+      const ValidateLevel& validate_level = ValidateLevel::no_validate)
+      : vertex_info_(vertex_info),
+        writer_(vertex_info, prefix, validate_level) {}
+
+  /**
+   * @brief Set the maximum number of rows of a row group of the Parquet
+   * chunks, see VertexPropertyWriter::SetRowGroupSize().
+   *
+   * @param row_group_size The maximum number of rows of a row group.
+   */
+  inline void SetRowGroupSize(int64_t row_group_size) {
+    writer_.SetRowGroupSize(row_group_size);
+  }
+
+  /**
+   * @brief Set the number of threads with which the chunks of the property
+   * groups of a vertex chunk are written concurrently.
+   *
+   * @param num_threads The number of threads, 1 by default, 0 means all the
+   * cores.
+   */
+  inline void SetNumThreads(int num_threads) {
+    writer_.SetNumThreads(num_threads);
+  }
+
+  /**
+   * @brief Get the number of vertices written or buffered so far.
+   *
+   * @return The number of vertices.
+   */
+  inline IdType GetVerticesNum() const {
+    return written_rows_ + buffered_rows_;
+  }
+
+  /**
+   * @brief Append a record batch, and write the vertex chunks it completes.
+   *
+   * All the record batches must have the same schema, which contains the
+   * properties of all the property groups.
+   *
+   * @param batch The record batch of the next vertices.
+   * @return Status: ok or error. If a chunk fails, its rows remain buffered.
+   */
+  Status Write(const std::shared_ptr<arrow::RecordBatch>& batch) noexcept;
+
+  /**
+   * @brief Append all the record batches of a reader, and write the vertex
+   * chunks they complete.
+   *
+   * @param reader The reader of the record batches of the next vertices.
+   * @return Status: ok or error.
+   */
+  Status Write(arrow::RecordBatchReader* reader) noexcept;
+
+  /**
+   * @brief Write the last partial vertex chunk and the number of vertices.
+   * No record batch can be written after it.
+   *
+   * @return Status: ok or error.
+   */
+  Status Finish() noexcept;
+
+ private:
+  // write the first num_rows buffered rows as the next vertex chunk
+  Status flushChunk(int64_t num_rows) noexcept;
+
+  VertexInfo vertex_info_;
+  VertexPropertyWriter writer_;
+  std::shared_ptr<arrow::Schema> schema_;
+  std::deque<std::shared_ptr<arrow::RecordBatch>> buffered_batches_;
+  int64_t buffered_rows_ = 0;
+  IdType written_rows_ = 0;
+  IdType chunk_index_ = 0;
+  bool finished_ = false;
 };
 
 /**
@@ -210,6 +368,7 @@ class EdgeChunkWriter {
     default:
       vertex_chunk_size_ = edge_info_.GetSrcChunkSize();
     }
+    written_chunks_ = std::make_shared<WrittenChunks>();
   }
 
   /**
@@ -221,6 +380,81 @@ class EdgeChunkWriter {
     validate_level_ = validate_level;
   }
 
+  /**
+   * @brief Set the maximum number of rows of a row group of the Parquet
+   * chunks, smaller row groups let the readers seek inside a chunk without
+   * decoding the rows before the seek position. The row group size of the
+   * writer options of a property group or an adj list takes precedence.
+   *
+   * @param row_group_size The maximum number of rows of a row group.
+   */
+  inline void SetRowGroupSize(int64_t row_group_size) {
+    row_group_size_ = row_group_size;
+  }
+
+  /**
+   * @brief Get the maximum number of rows of a row group.
+   *
+   * @return The row group size of this writer.
+   */
+  inline int64_t GetRowGroupSize() const { return row_group_size_; }
+
+  /**
+   * @brief Set the number of threads with which the table writes encode and
+   * write the offset, adj list and property group chunks concurrently. The
+   * chunks are written serially by default.
+   *
+   * @param num_threads The number of threads, 1 by default, 0 means all the
+   * cores.
+   */
+  inline void SetNumThreads(int num_threads) { num_threads_ = num_threads; }
+
+  /**
+   * @brief Get the number of threads of the table writes.
+   *
+   * @return The number of threads of this writer, 0 means all the cores.
+   */
+  inline int GetNumThreads() const { return num_threads_; }
+
+  /** The default memory limit of sorting the edges of a vertex chunk. */
+  static constexpr int64_t kDefaultSortMemoryLimit = 256 * 1024 * 1024;
+
+  /**
+   * @brief Set the memory limit of sorting the edges of a vertex chunk. The
+   * sorts of more edges spill sorted runs to the spill directory and merge
+   * them into the chunks.
+   *
+   * @param memory_limit The memory limit in bytes.
+   */
+  inline void SetSortMemoryLimit(int64_t memory_limit) {
+    sort_memory_limit_ = memory_limit;
+  }
+
+  /**
+   * @brief Get the memory limit of sorting the edges of a vertex chunk.
+   *
+   * @return The memory limit in bytes.
+   */
+  inline int64_t GetSortMemoryLimit() const { return sort_memory_limit_; }
+
+  /**
+   * @brief Set the local directory of the sorted runs spilled by the sorts.
+   *
+   * @param spill_dir The local directory, empty means the temporary directory
+   * of the system.
+   */
+  inline void SetSpillDirectory(const std::string& spill_dir) {
+    spill_dir_ = spill_dir;
+  }
+
+  /**
+   * @brief Get the local directory of the spilled sorted runs.
+   *
+   * @return The spill directory, empty means the temporary directory of the
+   * system.
+   */
+  inline const std::string& GetSpillDirectory() const { return spill_dir_; }
+
   /**
    * @brief Check if the writer operation (for adj list or offset) is allowed.
    *
@@ -404,6 +638,11 @@ class EdgeChunkWriter {
    * @brief Write chunks of the adj list and all property groups for the
    * edges of a vertex chunk.
    *
+   * The adj list chunks and the property group chunks are written
+   * concurrently on GetNumThreads() threads, each thread slices, selects and
+   * encodes the chunks it writes. If any chunk fails, the chunks written by
+   * the call are deleted and the first error is returned.
+   *
    * @param input_table The table containing data.
    * @param vertex_chunk_index The index of the vertex chunk.
    * @param start_chunk_index The start index of the edge chunks inside
@@ -472,7 +711,112 @@ class EdgeChunkWriter {
                            IdType vertex_chunk_index,
                            IdType start_chunk_index = 0) const noexcept;
 
+  /**
+   * @brief Sort the edges read from a stream, and write the adj list chunks
+   * (and the offset chunk of an ordered adj list) for the edges of a vertex
+   * chunk.
+   *
+   * The edges are sorted in memory if they fit in GetSortMemoryLimit().
+   * Otherwise the sorted runs of the memory limit are spilled to
+   * GetSpillDirectory() and merged straight into the chunks, so that only one
+   * batch of each run and one edge chunk are kept in memory.
+   *
+   * @param reader The reader of the record batches of the edges.
+   * @param vertex_chunk_index The index of the vertex chunk.
+   * @param start_chunk_index The start index of the edge chunks inside
+   * the vertex chunk.
+   * @return Status: ok or error.
+   */
+  Status SortAndWriteAdjListTable(arrow::RecordBatchReader* reader,
+                                  IdType vertex_chunk_index,
+                                  IdType start_chunk_index = 0) const noexcept;
+
+  /**
+   * @brief Sort the edges read from a stream, and write chunks of the adj list
+   * and all property groups for the edges of a vertex chunk, within the memory
+   * limit as SortAndWriteAdjListTable().
+   *
+   * @param reader The reader of the record batches of the edges.
+   * @param vertex_chunk_index The index of the vertex chunk.
+   * @param start_chunk_index The start index of the edge chunks inside
+   * the vertex chunk.
+   * @return Status: ok or error.
+   */
+  Status SortAndWriteTable(arrow::RecordBatchReader* reader,
+                           IdType vertex_chunk_index,
+                           IdType start_chunk_index = 0) const noexcept;
+
+  /**
+   * @brief Write the chunk manifests of the adj list and all property groups,
+   * see ChunkManifest. The manifest of the adj list records the zone maps of
+   * its chunks, collected when the chunks are written from tables by this
+   * writer, the other chunks are read. Writing a chunk deletes the manifest
+   * of its directory, so that the readers list the directory until the
+   * manifests are written again.
+   *
+   * @param vertex_chunk_num The number of vertex chunks, -1 means the number
+   * of the written part<i> directories.
+   * @return Status: ok or error.
+   */
+  Status WriteManifest(IdType vertex_chunk_num = -1) const noexcept;
+
  private:
+  // write the adj list chunks if with_adj_list, the chunks of the property
+  // groups and the offset chunk if offset_table is not nullptr, on
+  // num_threads_ threads, and delete the written chunks if any write fails
+  Status writeTable(const std::shared_ptr<arrow::Table>& input_table,
+                    bool with_adj_list,
+                    const std::vector<PropertyGroup>& property_groups,
+                    IdType vertex_chunk_index, IdType start_chunk_index,
+                    const std::shared_ptr<arrow::Table>& offset_table =
+                        nullptr) const noexcept;
+
+  // sort the edges, then write the adj list chunks if with_adj_list, the
+  // chunks of the property groups, and the offset chunk if with_adj_list and
+  // the adj list is ordered; the tables larger than sort_memory_limit_ are
+  // sorted by sortAndWrite of a reader
+  Status sortAndWrite(const std::shared_ptr<arrow::Table>& input_table,
+                      bool with_adj_list,
+                      const std::vector<PropertyGroup>& property_groups,
+                      IdType vertex_chunk_index, IdType start_chunk_index) const
+      noexcept;
+
+  // sort the whole table in memory, and write the chunks as sortAndWrite
+  Status sortInMemoryAndWrite(const std::shared_ptr<arrow::Table>& input_table,
+                              bool with_adj_list,
+                              const std::vector<PropertyGroup>& property_groups,
+                              IdType vertex_chunk_index,
+                              IdType start_chunk_index) const noexcept;
+
+  // sort the edges of the reader in memory if they fit in sort_memory_limit_,
+  // otherwise spill sorted runs and k-way merge them into the chunks
+  Status sortAndWrite(arrow::RecordBatchReader* reader, bool with_adj_list,
+                      const std::vector<PropertyGroup>& property_groups,
+                      IdType vertex_chunk_index, IdType start_chunk_index) const
+      noexcept;
+
+  // delete the manifest of the directory of a chunk before writing the chunk,
+  // so that the readers list the chunks until WriteManifest; each manifest
+  // is deleted once between two WriteManifest
+  Status invalidateManifest(const std::string& dir_path) const noexcept;
+
+  // delete the manifest of the adj list, whose vertex chunks and chunks are
+  // changed by writing an adj list or offset chunk
+  Status invalidateAdjListManifest() const noexcept;
+
+  // delete the manifest of a property group
+  Status invalidatePropertyManifest(const PropertyGroup& property_group) const
+      noexcept;
+
+  // merge the sorted runs spilled to the files into the chunks, the merged
+  // edges are written a chunk per thread at a time
+  Status mergeAndWrite(const std::vector<std::string>& run_paths,
+                       const std::shared_ptr<arrow::Schema>& schema,
+                       bool with_adj_list,
+                       const std::vector<PropertyGroup>& property_groups,
+                       IdType vertex_chunk_index,
+                       IdType start_chunk_index) const noexcept;
+
   /**
    * @brief Construct the offset table.
    *
@@ -525,6 +869,21 @@ class EdgeChunkWriter {
   std::string prefix_;
   std::shared_ptr<FileSystem> fs_;
   ValidateLevel validate_level_;
+  int64_t row_group_size_ = FileSystem::kDefaultRowGroupSize;
+  int num_threads_ = 1;
+  int64_t sort_memory_limit_ = kDefaultSortMemoryLimit;
+  std::string spill_dir_;
+  // the state of the written chunks, shared by the copies of the writer
+  struct WrittenChunks {
+    std::mutex mutex;
+    // the zone maps of the adj list chunks written from tables, keyed by the
+    // vertex chunk index and the chunk index
+    std::map<std::pair<IdType, IdType>, ChunkZoneMap> zone_maps;
+    // the directories whose manifests are deleted since the last
+    // WriteManifest
+    std::set<std::string> invalidated_dirs;
+  };
+  std::shared_ptr<WrittenChunks> written_chunks_;
 };
 
 }  // namespace GAR_NAMESPACE_INTERNAL
@@ -289,6 +289,12 @@ class EdgesBuilder {
       GAR_RETURN_NOT_OK(writer.WriteTable(input_table, vertex_chunk_index, 0));
       chunk_edges.second.clear();
     }
+    // dump the chunk manifests
+    IdType vertex_chunk_num = 0;
+    for (const auto& chunk_edges : edges_) {
+      vertex_chunk_num = std::max(vertex_chunk_num, chunk_edges.first + 1);
+    }
+    GAR_RETURN_NOT_OK(writer.WriteManifest(vertex_chunk_num));
     is_saved_ = true;
     return Status::OK();
   }
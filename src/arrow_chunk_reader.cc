@@ -13,7 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include <iostream>
+#include <tuple>
 
 #include "arrow/api.h"
 
@@ -22,18 +24,59 @@ limitations under the License.
 
 namespace GAR_NAMESPACE_INTERNAL {
 
+namespace {
+// get the columns of the selected properties in the order of the group
+Result<std::vector<std::string>> GetSelectedColumns(
+    const PropertyGroup& property_group,
+    const std::vector<std::string>& property_names) {
+  auto columns = utils::GetSelectedProperties(property_group, property_names);
+  if (columns.size() != property_names.size()) {
+    return Status::KeyError("Some of the properties are not in the group.");
+  }
+  return columns;
+}
+
+// call func with the paths of the next depth edge chunks after the chunk
+// (vertex_chunk_index, chunk_index), stop at the end of the adj list
+template <typename Func>
+void ForEachNextEdgeChunk(ChunkManifest* manifest, IdType vertex_chunk_index,
+                          IdType chunk_index, IdType chunk_num, IdType depth,
+                          Func func) noexcept {
+  for (IdType i = 0; i < depth; ++i) {
+    while (++chunk_index >= chunk_num) {
+      if (++vertex_chunk_index >= manifest->GetVertexChunkNum()) {
+        return;
+      }
+      chunk_index = -1;
+      auto maybe_chunk_num = manifest->GetChunkNum(vertex_chunk_index);
+      if (!maybe_chunk_num.status().ok()) {
+        return;
+      }
+      chunk_num = maybe_chunk_num.value();
+    }
+    if (!func(vertex_chunk_index, chunk_index)) {
+      return;
+    }
+  }
+}
+}  // namespace
+
 Result<std::shared_ptr<arrow::Table>>
 VertexPropertyArrowChunkReader::GetChunk() noexcept {
-  if (chunk_table_ == nullptr) {
+  IdType row_offset = seek_id_ - chunk_index_ * vertex_info_.GetChunkSize();
+  if (chunk_table_ == nullptr || row_offset < chunk_table_offset_) {
     GAR_ASSIGN_OR_RAISE(
         auto chunk_file_path,
         vertex_info_.GetFilePath(property_group_, chunk_index_));
     std::string path = prefix_ + chunk_file_path;
-    GAR_ASSIGN_OR_RAISE(chunk_table_, fs_->ReadFileToTable(
-                                          path, property_group_.GetFileType()));
+    GAR_ASSIGN_OR_RAISE(
+        auto chunk,
+        utils::ReadChunkTableFromRow(fs_, path, property_group_.GetFileType(),
+                                     row_offset, columns_));
+    std::tie(chunk_table_, chunk_table_offset_) = chunk;
+    prefetch();
   }
-  IdType row_offset = seek_id_ - chunk_index_ * vertex_info_.GetChunkSize();
-  return chunk_table_->Slice(row_offset);
+  return chunk_table_->Slice(row_offset - chunk_table_offset_);
 }
 
 Result<std::pair<IdType, IdType>>
@@ -42,8 +85,28 @@ VertexPropertyArrowChunkReader::GetRange() noexcept {
     return Status::InvalidOperation("The GetRange operation is not invalid.");
   }
   IdType row_offset = seek_id_ - chunk_index_ * vertex_info_.GetChunkSize();
-  return std::make_pair(seek_id_,
-                        seek_id_ + chunk_table_->num_rows() - row_offset);
+  return std::make_pair(seek_id_, seek_id_ + chunk_table_offset_ +
+                                      chunk_table_->num_rows() - row_offset);
+}
+
+Status VertexPropertyArrowChunkReader::SelectProperties(
+    const std::vector<std::string>& property_names) noexcept {
+  GAR_ASSIGN_OR_RAISE(columns_,
+                      GetSelectedColumns(property_group_, property_names));
+  chunk_table_.reset();
+  return Status::OK();
+}
+
+void VertexPropertyArrowChunkReader::prefetch() noexcept {
+  IdType end = std::min(chunk_index_ + 1 + prefetch_depth_, chunk_num_);
+  for (IdType i = chunk_index_ + 1; i < end; ++i) {
+    auto chunk_file_path = vertex_info_.GetFilePath(property_group_, i);
+    if (!chunk_file_path.status().ok()) {
+      return;
+    }
+    utils::PrefetchChunkTable(fs_, prefix_ + chunk_file_path.value(),
+                              property_group_.GetFileType(), columns_);
+  }
 }
 
 Status AdjListArrowChunkReader::seek_src(IdType id) noexcept {
@@ -59,18 +122,21 @@ Status AdjListArrowChunkReader::seek_src(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
     chunk_table_.reset();
   }
 
   if (adj_list_type_ == AdjListType::unordered_by_source) {
     return seek(0);  // start from first chunk
   } else {
-    GAR_ASSIGN_OR_RAISE(auto range,
-                        utils::GetAdjListOffsetOfVertex(edge_info_, prefix_,
-                                                        adj_list_type_, id));
+    if (offset_index_ == nullptr) {
+      GAR_ASSIGN_OR_RAISE(
+          offset_index_,
+          OffsetIndex::Make(edge_info_, adj_list_type_, fs_, prefix_,
+                            manifest_));
+    }
+    GAR_ASSIGN_OR_RAISE(auto range, offset_index_->GetOffsetRange(id));
     return seek(range.first);
   }
   return Status::OK();
@@ -89,34 +155,40 @@ Status AdjListArrowChunkReader::seek_dst(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
     chunk_table_.reset();
   }
 
   if (adj_list_type_ == AdjListType::unordered_by_dest) {
     return seek(0);  // start from the first chunk
   } else {
-    GAR_ASSIGN_OR_RAISE(auto range,
-                        utils::GetAdjListOffsetOfVertex(edge_info_, prefix_,
-                                                        adj_list_type_, id));
+    if (offset_index_ == nullptr) {
+      GAR_ASSIGN_OR_RAISE(
+          offset_index_,
+          OffsetIndex::Make(edge_info_, adj_list_type_, fs_, prefix_,
+                            manifest_));
+    }
+    GAR_ASSIGN_OR_RAISE(auto range, offset_index_->GetOffsetRange(id));
     return seek(range.first);
   }
 }
 
 Result<std::shared_ptr<arrow::Table>>
 AdjListArrowChunkReader::GetChunk() noexcept {
-  if (chunk_table_ == nullptr) {
+  IdType row_offset = seek_offset_ - chunk_index_ * edge_info_.GetChunkSize();
+  if (chunk_table_ == nullptr || row_offset < chunk_table_offset_) {
     GAR_ASSIGN_OR_RAISE(auto chunk_file_path,
                         edge_info_.GetAdjListFilePath(
                             vertex_chunk_index_, chunk_index_, adj_list_type_));
     std::string path = prefix_ + chunk_file_path;
     GAR_ASSIGN_OR_RAISE(auto file_type, edge_info_.GetFileType(adj_list_type_));
-    GAR_ASSIGN_OR_RAISE(chunk_table_, fs_->ReadFileToTable(path, file_type));
+    GAR_ASSIGN_OR_RAISE(auto chunk, utils::ReadChunkTableFromRow(
+                                        fs_, path, file_type, row_offset));
+    std::tie(chunk_table_, chunk_table_offset_) = chunk;
+    prefetch();
   }
-  IdType row_offset = seek_offset_ - chunk_index_ * edge_info_.GetChunkSize();
-  return chunk_table_->Slice(row_offset);
+  return chunk_table_->Slice(row_offset - chunk_table_offset_);
 }
 
 Result<IdType> AdjListArrowChunkReader::GetRowNumOfChunk() noexcept {
@@ -126,9 +198,34 @@ Result<IdType> AdjListArrowChunkReader::GetRowNumOfChunk() noexcept {
                             vertex_chunk_index_, chunk_index_, adj_list_type_));
     std::string path = prefix_ + chunk_file_path;
     GAR_ASSIGN_OR_RAISE(auto file_type, edge_info_.GetFileType(adj_list_type_));
-    GAR_ASSIGN_OR_RAISE(chunk_table_, fs_->ReadFileToTable(path, file_type));
+    GAR_ASSIGN_OR_RAISE(chunk_table_,
+                        utils::ReadChunkTable(fs_, path, file_type));
+    chunk_table_offset_ = 0;
+    prefetch();
   }
-  return chunk_table_->num_rows();
+  // a partially read chunk always extends to the end of the chunk
+  return chunk_table_offset_ + chunk_table_->num_rows();
+}
+
+void AdjListArrowChunkReader::prefetch() noexcept {
+  auto maybe_file_type = edge_info_.GetFileType(adj_list_type_);
+  if (!maybe_file_type.status().ok()) {
+    return;
+  }
+  FileType file_type = maybe_file_type.value();
+  ForEachNextEdgeChunk(
+      manifest_.get(), vertex_chunk_index_, chunk_index_, chunk_num_,
+      prefetch_depth_,
+      [&](IdType vertex_chunk_index, IdType chunk_index) {
+        auto chunk_file_path = edge_info_.GetAdjListFilePath(
+            vertex_chunk_index, chunk_index, adj_list_type_);
+        if (!chunk_file_path.status().ok()) {
+          return false;
+        }
+        utils::PrefetchChunkTable(fs_, prefix_ + chunk_file_path.value(),
+                                  file_type);
+        return true;
+      });
 }
 
 Status AdjListPropertyArrowChunkReader::seek_src(IdType id) noexcept {
@@ -144,18 +241,21 @@ Status AdjListPropertyArrowChunkReader::seek_src(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
     chunk_table_.reset();
   }
 
   if (adj_list_type_ == AdjListType::unordered_by_source) {
     return seek(0);  // start from first chunk
   } else {
-    GAR_ASSIGN_OR_RAISE(auto range,
-                        utils::GetAdjListOffsetOfVertex(edge_info_, prefix_,
-                                                        adj_list_type_, id));
+    if (offset_index_ == nullptr) {
+      GAR_ASSIGN_OR_RAISE(
+          offset_index_,
+          OffsetIndex::Make(edge_info_, adj_list_type_, fs_, prefix_,
+                            manifest_));
+    }
+    GAR_ASSIGN_OR_RAISE(auto range, offset_index_->GetOffsetRange(id));
     return seek(range.first);
   }
   return Status::OK();
@@ -174,22 +274,33 @@ Status AdjListPropertyArrowChunkReader::seek_dst(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
     chunk_table_.reset();
   }
 
   if (adj_list_type_ == AdjListType::unordered_by_dest) {
     return seek(0);  // start from the first chunk
   } else {
-    GAR_ASSIGN_OR_RAISE(auto range,
-                        utils::GetAdjListOffsetOfVertex(edge_info_, prefix_,
-                                                        adj_list_type_, id));
+    if (offset_index_ == nullptr) {
+      GAR_ASSIGN_OR_RAISE(
+          offset_index_,
+          OffsetIndex::Make(edge_info_, adj_list_type_, fs_, prefix_,
+                            manifest_));
+    }
+    GAR_ASSIGN_OR_RAISE(auto range, offset_index_->GetOffsetRange(id));
     return seek(range.first);
   }
 }
 
+Status AdjListPropertyArrowChunkReader::SelectProperties(
+    const std::vector<std::string>& property_names) noexcept {
+  GAR_ASSIGN_OR_RAISE(columns_,
+                      GetSelectedColumns(property_group_, property_names));
+  chunk_table_.reset();
+  return Status::OK();
+}
+
 Result<std::shared_ptr<arrow::Array>>
 AdjListOffsetArrowChunkReader::GetChunk() noexcept {
   if (chunk_table_ == nullptr) {
@@ -198,25 +309,64 @@ AdjListOffsetArrowChunkReader::GetChunk() noexcept {
         edge_info_.GetAdjListOffsetFilePath(chunk_index_, adj_list_type_));
     std::string path = prefix_ + chunk_file_path;
     GAR_ASSIGN_OR_RAISE(auto file_type, edge_info_.GetFileType(adj_list_type_));
-    GAR_ASSIGN_OR_RAISE(chunk_table_, fs_->ReadFileToTable(path, file_type));
+    GAR_ASSIGN_OR_RAISE(chunk_table_,
+                        utils::ReadChunkTable(fs_, path, file_type));
+    prefetch();
   }
   IdType row_offset = seek_id_ - chunk_index_ * vertex_chunk_size_;
   return chunk_table_->Slice(row_offset)->column(0)->chunk(0);
 }
 
+void AdjListOffsetArrowChunkReader::prefetch() noexcept {
+  auto maybe_file_type = edge_info_.GetFileType(adj_list_type_);
+  if (!maybe_file_type.status().ok()) {
+    return;
+  }
+  IdType end = std::min(chunk_index_ + 1 + prefetch_depth_, vertex_chunk_num_);
+  for (IdType i = chunk_index_ + 1; i < end; ++i) {
+    auto chunk_file_path =
+        edge_info_.GetAdjListOffsetFilePath(i, adj_list_type_);
+    if (!chunk_file_path.status().ok()) {
+      return;
+    }
+    utils::PrefetchChunkTable(fs_, prefix_ + chunk_file_path.value(),
+                              maybe_file_type.value());
+  }
+}
+
 Result<std::shared_ptr<arrow::Table>>
 AdjListPropertyArrowChunkReader::GetChunk() noexcept {
-  if (chunk_table_ == nullptr) {
+  IdType row_offset = seek_offset_ - chunk_index_ * edge_info_.GetChunkSize();
+  if (chunk_table_ == nullptr || row_offset < chunk_table_offset_) {
     GAR_ASSIGN_OR_RAISE(
         auto chunk_file_path,
         edge_info_.GetPropertyFilePath(property_group_, adj_list_type_,
                                        vertex_chunk_index_, chunk_index_));
     std::string path = prefix_ + chunk_file_path;
-    GAR_ASSIGN_OR_RAISE(chunk_table_, fs_->ReadFileToTable(
-                                          path, property_group_.GetFileType()));
+    GAR_ASSIGN_OR_RAISE(
+        auto chunk,
+        utils::ReadChunkTableFromRow(fs_, path, property_group_.GetFileType(),
+                                     row_offset, columns_));
+    std::tie(chunk_table_, chunk_table_offset_) = chunk;
+    prefetch();
   }
-  IdType row_offset = seek_offset_ - chunk_index_ * edge_info_.GetChunkSize();
-  return chunk_table_->Slice(row_offset);
+  return chunk_table_->Slice(row_offset - chunk_table_offset_);
+}
+
+void AdjListPropertyArrowChunkReader::prefetch() noexcept {
+  ForEachNextEdgeChunk(
+      manifest_.get(), vertex_chunk_index_, chunk_index_, chunk_num_,
+      prefetch_depth_,
+      [&](IdType vertex_chunk_index, IdType chunk_index) {
+        auto chunk_file_path = edge_info_.GetPropertyFilePath(
+            property_group_, adj_list_type_, vertex_chunk_index, chunk_index);
+        if (!chunk_file_path.status().ok()) {
+          return false;
+        }
+        utils::PrefetchChunkTable(fs_, prefix_ + chunk_file_path.value(),
+                                  property_group_.GetFileType(), columns_);
+        return true;
+      });
 }
 
 }  // namespace GAR_NAMESPACE_INTERNAL
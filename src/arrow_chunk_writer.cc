@@ -13,66 +13,25 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
 #include <iostream>
+#include <queue>
+#include <random>
+#include <thread>
 
 #include "arrow/api.h"
 #include "arrow/compute/api.h"
-#include "arrow/compute/exec/exec_plan.h"
-#include "arrow/dataset/dataset.h"
-#include "arrow/dataset/file_base.h"
-#include "arrow/dataset/file_parquet.h"
-#include "arrow/dataset/plan.h"
-#include "arrow/dataset/scanner.h"
+#include "arrow/io/file.h"
+#include "arrow/ipc/api.h"
+#include "arrow/util/byte_size.h"
 
+#include "gar/utils/chunk_manifest.h"
+#include "gar/utils/utils.h"
 #include "gar/writer/arrow_chunk_writer.h"
 
 namespace GAR_NAMESPACE_INTERNAL {
-// common methods
-
-#if defined(ARROW_VERSION) && ARROW_VERSION >= 10000000
-using AsyncGeneratorType =
-    arrow::AsyncGenerator<std::optional<arrow::compute::ExecBatch>>;
-#else
-using AsyncGeneratorType =
-    arrow::AsyncGenerator<arrow::util::optional<arrow::compute::ExecBatch>>;
-#endif
-
-/**
- * @brief Execute a compute plan and collect the results as a table.
- *
- * @param exec_context The execution context.
- * @param plan The compute pan to execute.
- * @param schema The schema the input table.
- * @param sink_gen The async generator.
- */
-Result<std::shared_ptr<arrow::Table>> ExecutePlanAndCollectAsTable(
-    const arrow::compute::ExecContext& exec_context,
-    std::shared_ptr<arrow::compute::ExecPlan> plan,
-    std::shared_ptr<arrow::Schema> schema, AsyncGeneratorType sink_gen) {
-  // translate sink_gen (async) to sink_reader (sync)
-  std::shared_ptr<arrow::RecordBatchReader> sink_reader =
-      arrow::compute::MakeGeneratorReader(schema, std::move(sink_gen),
-                                          exec_context.memory_pool());
-
-  // validate the ExecPlan
-  RETURN_NOT_ARROW_OK(plan->Validate());
-  //  start the ExecPlan
-  RETURN_NOT_ARROW_OK(plan->StartProducing());
-
-  // collect sink_reader into a Table
-  std::shared_ptr<arrow::Table> response_table;
-  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
-      response_table, arrow::Table::FromRecordBatchReader(sink_reader.get()));
-
-  // stop producing
-  plan->StopProducing();
-  // plan mark finished
-  auto future = plan->finished();
-  if (!future.status().ok()) {
-    return Status::ArrowError(future.status().ToString());
-  }
-  return response_table;
-}
 
 // implementations for VertexPropertyChunkWriter
 
@@ -131,7 +90,8 @@ Status VertexPropertyWriter::WriteChunk(
   GAR_ASSIGN_OR_RAISE(auto suffix,
                       vertex_info_.GetFilePath(property_group, chunk_index));
   std::string path = prefix_ + suffix;
-  return fs_->WriteTableToFile(in_table, file_type, path);
+  return fs_->WriteTableToFile(in_table, file_type, path, row_group_size_,
+                               property_group.GetWriterOptions());
 }
 
 Status VertexPropertyWriter::WriteChunk(
@@ -148,30 +108,259 @@ Status VertexPropertyWriter::WriteTable(
     const std::shared_ptr<arrow::Table>& input_table,
     const PropertyGroup& property_group, IdType start_chunk_index) const
     noexcept {
+  return writeTable(input_table, {property_group}, start_chunk_index);
+}
+
+Status VertexPropertyWriter::WriteTable(
+    const std::shared_ptr<arrow::Table>& input_table,
+    IdType start_chunk_index) const noexcept {
+  return writeTable(input_table, vertex_info_.GetPropertyGroups(),
+                    start_chunk_index);
+}
+
+Status VertexPropertyWriter::writeTable(
+    const std::shared_ptr<arrow::Table>& input_table,
+    const std::vector<PropertyGroup>& property_groups,
+    IdType start_chunk_index) const noexcept {
   IdType chunk_size = vertex_info_.GetChunkSize();
   int64_t length = input_table->num_rows();
-  IdType chunk_index = start_chunk_index;
-  for (int64_t offset = 0; offset < length;
-       offset += chunk_size, chunk_index++) {
-    auto in_chunk = input_table->Slice(offset, chunk_size);
-    GAR_RETURN_NOT_OK(WriteChunk(in_chunk, property_group, chunk_index));
+  IdType chunk_num = (length + chunk_size - 1) / chunk_size;
+  int64_t task_num = chunk_num * static_cast<int64_t>(property_groups.size());
+  // the (group, chunk) files are independent, each task slices, selects and
+  // encodes its chunk
+  std::vector<char> started(task_num, 0);
+  auto status = util::ParallelFor(
+      task_num, num_threads_, [&](int64_t task) -> Status {
+        const auto& property_group = property_groups[task / chunk_num];
+        IdType i = task % chunk_num;
+        started[task] = 1;
+        auto in_chunk = input_table->Slice(i * chunk_size, chunk_size);
+        return WriteChunk(in_chunk, property_group, start_chunk_index + i);
+      });
+  if (!status.ok()) {
+    // delete the chunks written or partially written by this call, the
+    // errors of the deletion are ignored
+    for (int64_t task = 0; task < task_num; ++task) {
+      if (!started[task]) {
+        continue;
+      }
+      auto maybe_suffix = vertex_info_.GetFilePath(
+          property_groups[task / chunk_num],
+          start_chunk_index + task % chunk_num);
+      if (!maybe_suffix.has_error()) {
+        fs_->DeleteFile(prefix_ + maybe_suffix.value());
+      }
+    }
+  }
+  return status;
+}
+
+// implementations for VertexStreamWriter
+
+Status VertexStreamWriter::Write(
+    const std::shared_ptr<arrow::RecordBatch>& batch) noexcept {
+  if (finished_) {
+    return Status::InvalidOperation("The vertex stream writer is finished.");
+  }
+  if (schema_ == nullptr) {
+    schema_ = batch->schema();
+  } else if (!schema_->Equals(*batch->schema())) {
+    return Status::TypeError("The schema of the record batch " +
+                             batch->schema()->ToString() +
+                             " does not match the stream " +
+                             schema_->ToString() + ".");
+  }
+  if (batch->num_rows() == 0) {
+    return Status::OK();
+  }
+  buffered_batches_.push_back(batch);
+  buffered_rows_ += batch->num_rows();
+  IdType chunk_size = vertex_info_.GetChunkSize();
+  while (buffered_rows_ >= chunk_size) {
+    GAR_RETURN_NOT_OK(flushChunk(chunk_size));
   }
   return Status::OK();
 }
 
-Status VertexPropertyWriter::WriteTable(
-    const std::shared_ptr<arrow::Table>& input_table,
-    IdType start_chunk_index) const noexcept {
-  auto property_groups = vertex_info_.GetPropertyGroups();
-  for (auto& property_group : property_groups) {
-    GAR_RETURN_NOT_OK(
-        WriteTable(input_table, property_group, start_chunk_index));
+Status VertexStreamWriter::Write(arrow::RecordBatchReader* reader) noexcept {
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (true) {
+    RETURN_NOT_ARROW_OK(reader->ReadNext(&batch));
+    if (batch == nullptr) {
+      break;
+    }
+    GAR_RETURN_NOT_OK(Write(batch));
+  }
+  return Status::OK();
+}
+
+Status VertexStreamWriter::Finish() noexcept {
+  if (finished_) {
+    return Status::InvalidOperation("The vertex stream writer is finished.");
+  }
+  if (buffered_rows_ > 0) {
+    GAR_RETURN_NOT_OK(flushChunk(buffered_rows_));
+  }
+  GAR_RETURN_NOT_OK(writer_.WriteVerticesNum(GetVerticesNum()));
+  finished_ = true;
+  return Status::OK();
+}
+
+Status VertexStreamWriter::flushChunk(int64_t num_rows) noexcept {
+  // the batches of the chunk are zero-copy slices, the buffer is consumed only
+  // after the chunk is written
+  std::vector<std::shared_ptr<arrow::RecordBatch>> chunk_batches;
+  size_t consumed = 0;
+  int64_t rows = 0, rest = 0;
+  while (rows < num_rows) {
+    const auto& batch = buffered_batches_[consumed];
+    int64_t length = std::min(batch->num_rows(), num_rows - rows);
+    if (length == batch->num_rows()) {
+      chunk_batches.push_back(batch);
+      ++consumed;
+    } else {
+      chunk_batches.push_back(batch->Slice(0, length));
+      rest = length;
+    }
+    rows += length;
+  }
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      auto chunk_table,
+      arrow::Table::FromRecordBatches(schema_, chunk_batches));
+  GAR_RETURN_NOT_OK(writer_.WriteTable(chunk_table, chunk_index_));
+
+  buffered_batches_.erase(buffered_batches_.begin(),
+                          buffered_batches_.begin() + consumed);
+  if (rest > 0) {
+    buffered_batches_.front() = buffered_batches_.front()->Slice(rest);
   }
+  buffered_rows_ -= num_rows;
+  written_rows_ += num_rows;
+  ++chunk_index_;
   return Status::OK();
 }
 
 // implementations for EdgeChunkWriter
 
+namespace {
+// the number of rows of a batch of the spilled sorted runs
+constexpr int64_t kSpillBatchSize = 64 * 1024;
+
+// the number of bytes of an array, the buffers of a sliced array are only
+// counted for the rows of the slice
+int64_t GetArraySize(const arrow::Array& array) {
+  const auto& type = *array.type();
+  if (arrow::is_fixed_width(type.id())) {
+    const auto& fixed_width_type =
+        static_cast<const arrow::FixedWidthType&>(type);
+    return (array.length() * fixed_width_type.bit_width() + 7) / 8;
+  }
+  if (type.id() == arrow::Type::STRING || type.id() == arrow::Type::BINARY) {
+    const auto& binary_array = static_cast<const arrow::BinaryArray&>(array);
+    return binary_array.total_values_length() +
+           (array.length() + 1) * sizeof(int32_t);
+  }
+  if (type.id() == arrow::Type::LARGE_STRING ||
+      type.id() == arrow::Type::LARGE_BINARY) {
+    const auto& binary_array =
+        static_cast<const arrow::LargeBinaryArray&>(array);
+    return binary_array.total_values_length() +
+           (array.length() + 1) * sizeof(int64_t);
+  }
+  return arrow::util::TotalBufferSize(array);
+}
+
+int64_t GetBatchSize(const arrow::RecordBatch& batch) {
+  int64_t size = 0;
+  for (const auto& column : batch.columns()) {
+    size += GetArraySize(*column);
+  }
+  return size;
+}
+
+int64_t GetTableSize(const arrow::Table& table) {
+  int64_t size = 0;
+  for (const auto& column : table.columns()) {
+    for (const auto& chunk : column->chunks()) {
+      size += GetArraySize(*chunk);
+    }
+  }
+  return size;
+}
+
+// the local files of the sorted runs, which are deleted with the object
+struct SpillFiles {
+  ~SpillFiles() {
+    for (const auto& path : paths) {
+      std::error_code ec;
+      std::filesystem::remove(path, ec);
+    }
+  }
+
+  // write a sorted run as an Arrow IPC file in the spill directory
+  Status Write(const std::string& spill_dir,
+               const std::shared_ptr<arrow::Table>& table) {
+    static std::atomic<uint64_t> run_id{0};
+    auto path = (std::filesystem::path(spill_dir) /
+                 ("gar_sort_run_" + std::to_string(std::random_device{}()) +
+                  "_" + std::to_string(run_id++) + ".arrow"))
+                    .string();
+    paths.push_back(path);
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto output, arrow::io::FileOutputStream::Open(path));
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto writer, arrow::ipc::MakeFileWriter(output, table->schema()));
+    RETURN_NOT_ARROW_OK(writer->WriteTable(*table, kSpillBatchSize));
+    RETURN_NOT_ARROW_OK(writer->Close());
+    RETURN_NOT_ARROW_OK(output->Close());
+    return Status::OK();
+  }
+
+  std::vector<std::string> paths;
+};
+
+// the cursor of the merge on a spilled sorted run, which reads one batch at a
+// time
+struct RunCursor {
+  Status Open(const std::string& path, int key_index) {
+    key_index_ = key_index;
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto input,
+                                         arrow::io::ReadableFile::Open(path));
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        reader_, arrow::ipc::RecordBatchFileReader::Open(input));
+    return Next();
+  }
+
+  // read the next non-empty batch, batch is nullptr at the end of the run
+  Status Next() {
+    batch = nullptr;
+    keys = nullptr;
+    row = 0;
+    while (batch_index_ < reader_->num_record_batches()) {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+          batch, reader_->ReadRecordBatch(batch_index_++));
+      if (batch->num_rows() > 0) {
+        keys = std::static_pointer_cast<arrow::Int64Array>(
+                   batch->column(key_index_))
+                   ->raw_values();
+        return Status::OK();
+      }
+    }
+    batch = nullptr;
+    return Status::OK();
+  }
+
+  std::shared_ptr<arrow::RecordBatch> batch;
+  const IdType* keys = nullptr;
+  int64_t row = 0;
+
+ private:
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader_;
+  int batch_index_ = 0;
+  int key_index_ = 0;
+};
+}  // namespace
+
 Status EdgeChunkWriter::Validate(
     const std::shared_ptr<arrow::Table>& input_table, IdType vertex_chunk_index,
     ValidateLevel validate_level) const noexcept {
@@ -194,6 +383,7 @@ Status EdgeChunkWriter::WriteOffsetChunk(const std::string& file_name,
   GAR_ASSIGN_OR_RAISE(auto suffix, edge_info_.GetAdjListOffsetFilePath(
                                        vertex_chunk_index, adj_list_type_));
   std::string path = prefix_ + suffix;
+  GAR_RETURN_NOT_OK(invalidateAdjListManifest());
   return fs_->CopyFile(file_name, path);
 }
 
@@ -204,6 +394,12 @@ Status EdgeChunkWriter::WriteAdjListChunk(const std::string& file_name,
       auto suffix, edge_info_.GetAdjListFilePath(vertex_chunk_index,
                                                  chunk_index, adj_list_type_));
   std::string path = prefix_ + suffix;
+  {
+    // the copied chunk is read by WriteManifest
+    std::lock_guard<std::mutex> lock(written_chunks_->mutex);
+    written_chunks_->zone_maps.erase({vertex_chunk_index, chunk_index});
+  }
+  GAR_RETURN_NOT_OK(invalidateAdjListManifest());
   return fs_->CopyFile(file_name, path);
 }
 
@@ -215,6 +411,7 @@ Status EdgeChunkWriter::WritePropertyChunk(const std::string& file_name,
                                        property_group, adj_list_type_,
                                        vertex_chunk_index, chunk_index));
   std::string path = prefix_ + suffix;
+  GAR_RETURN_NOT_OK(invalidatePropertyManifest(property_group));
   return fs_->CopyFile(file_name, path);
 }
 
@@ -226,7 +423,11 @@ Status EdgeChunkWriter::WriteOffsetChunk(
   GAR_ASSIGN_OR_RAISE(auto suffix, edge_info_.GetAdjListOffsetFilePath(
                                        vertex_chunk_index, adj_list_type_));
   std::string path = prefix_ + suffix;
-  return fs_->WriteTableToFile(input_table, file_type, path);
+  GAR_ASSIGN_OR_RAISE(const auto& writer_options,
+                      edge_info_.GetWriterOptions(adj_list_type_));
+  GAR_RETURN_NOT_OK(invalidateAdjListManifest());
+  return fs_->WriteTableToFile(input_table, file_type, path, row_group_size_,
+                               writer_options);
 }
 
 Status EdgeChunkWriter::WriteAdjListChunk(
@@ -251,7 +452,16 @@ Status EdgeChunkWriter::WriteAdjListChunk(
       auto suffix, edge_info_.GetAdjListFilePath(vertex_chunk_index,
                                                  chunk_index, adj_list_type_));
   std::string path = prefix_ + suffix;
-  return fs_->WriteTableToFile(in_table, file_type, path);
+  GAR_ASSIGN_OR_RAISE(const auto& writer_options,
+                      edge_info_.GetWriterOptions(adj_list_type_));
+  // collect the zone map while the chunk is in memory, for WriteManifest
+  GAR_ASSIGN_OR_RAISE(auto zone_map, ChunkManifest::MakeZoneMap(in_table));
+  GAR_RETURN_NOT_OK(invalidateAdjListManifest());
+  GAR_RETURN_NOT_OK(fs_->WriteTableToFile(in_table, file_type, path,
+                                          row_group_size_, writer_options));
+  std::lock_guard<std::mutex> lock(written_chunks_->mutex);
+  written_chunks_->zone_maps[{vertex_chunk_index, chunk_index}] = zone_map;
+  return Status::OK();
 }
 
 Status EdgeChunkWriter::WritePropertyChunk(
@@ -275,7 +485,9 @@ Status EdgeChunkWriter::WritePropertyChunk(
                                        property_group, adj_list_type_,
                                        vertex_chunk_index, chunk_index));
   std::string path = prefix_ + suffix;
-  return fs_->WriteTableToFile(in_table, file_type, path);
+  GAR_RETURN_NOT_OK(invalidatePropertyManifest(property_group));
+  return fs_->WriteTableToFile(in_table, file_type, path, row_group_size_,
+                               property_group.GetWriterOptions());
 }
 
 Status EdgeChunkWriter::WritePropertyChunk(
@@ -301,117 +513,481 @@ Status EdgeChunkWriter::WriteChunk(
 Status EdgeChunkWriter::WriteAdjListTable(
     const std::shared_ptr<arrow::Table>& input_table, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
-  int64_t length = input_table->num_rows();
-  IdType chunk_index = start_chunk_index;
-  for (int64_t offset = 0; offset < length;
-       offset += chunk_size_, chunk_index++) {
-    auto in_chunk = input_table->Slice(offset, chunk_size_);
-    GAR_RETURN_NOT_OK(
-        WriteAdjListChunk(in_chunk, vertex_chunk_index, chunk_index));
-  }
-  return Status::OK();
+  return writeTable(input_table, true, {}, vertex_chunk_index,
+                    start_chunk_index);
 }
 
 Status EdgeChunkWriter::WritePropertyTable(
     const std::shared_ptr<arrow::Table>& input_table,
     const PropertyGroup& property_group, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
-  int64_t length = input_table->num_rows();
-  IdType chunk_index = start_chunk_index;
-  for (int64_t offset = 0; offset < length;
-       offset += chunk_size_, chunk_index++) {
-    auto in_chunk = input_table->Slice(offset, chunk_size_);
-    GAR_RETURN_NOT_OK(WritePropertyChunk(in_chunk, property_group,
-                                         vertex_chunk_index, chunk_index));
-  }
-  return Status::OK();
+  return writeTable(input_table, false, {property_group}, vertex_chunk_index,
+                    start_chunk_index);
 }
 
 Status EdgeChunkWriter::WritePropertyTable(
     const std::shared_ptr<arrow::Table>& input_table, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
-  int64_t length = input_table->num_rows();
-  IdType chunk_index = start_chunk_index;
-  for (int64_t offset = 0; offset < length;
-       offset += chunk_size_, chunk_index++) {
-    auto in_chunk = input_table->Slice(offset, chunk_size_);
-    GAR_RETURN_NOT_OK(
-        WritePropertyChunk(in_chunk, vertex_chunk_index, chunk_index));
-  }
-  return Status::OK();
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info_.GetPropertyGroups(adj_list_type_));
+  return writeTable(input_table, false, property_groups, vertex_chunk_index,
+                    start_chunk_index);
 }
 
 Status EdgeChunkWriter::WriteTable(
     const std::shared_ptr<arrow::Table>& input_table, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info_.GetPropertyGroups(adj_list_type_));
+  return writeTable(input_table, true, property_groups, vertex_chunk_index,
+                    start_chunk_index);
+}
+
+Status EdgeChunkWriter::writeTable(
+    const std::shared_ptr<arrow::Table>& input_table, bool with_adj_list,
+    const std::vector<PropertyGroup>& property_groups,
+    IdType vertex_chunk_index, IdType start_chunk_index,
+    const std::shared_ptr<arrow::Table>& offset_table) const noexcept {
   int64_t length = input_table->num_rows();
-  IdType chunk_index = start_chunk_index;
-  for (int64_t offset = 0; offset < length;
-       offset += chunk_size_, chunk_index++) {
-    auto in_chunk = input_table->Slice(offset, chunk_size_);
-    GAR_RETURN_NOT_OK(WriteChunk(in_chunk, vertex_chunk_index, chunk_index));
+  IdType chunk_num = (length + chunk_size_ - 1) / chunk_size_;
+  // the kinds of the files of each chunk, -1 for the adj list and i for the
+  // i-th property group
+  std::vector<int> kinds;
+  if (with_adj_list) {
+    kinds.push_back(-1);
   }
-  return Status::OK();
+  for (size_t i = 0; i < property_groups.size(); ++i) {
+    kinds.push_back(static_cast<int>(i));
+  }
+  int64_t kind_num = static_cast<int64_t>(kinds.size());
+  // the offset chunk is the last task
+  int64_t file_num = chunk_num * kind_num;
+  int64_t task_num = file_num + (offset_table != nullptr ? 1 : 0);
+  auto get_path = [&](int64_t task) -> Result<std::string> {
+    if (task == file_num) {
+      GAR_ASSIGN_OR_RAISE(auto suffix, edge_info_.GetAdjListOffsetFilePath(
+                                           vertex_chunk_index, adj_list_type_));
+      return prefix_ + suffix;
+    }
+    int kind = kinds[task % kind_num];
+    IdType chunk_index = start_chunk_index + task / kind_num;
+    if (kind < 0) {
+      GAR_ASSIGN_OR_RAISE(auto suffix,
+                          edge_info_.GetAdjListFilePath(
+                              vertex_chunk_index, chunk_index, adj_list_type_));
+      return prefix_ + suffix;
+    }
+    GAR_ASSIGN_OR_RAISE(auto suffix,
+                        edge_info_.GetPropertyFilePath(
+                            property_groups[kind], adj_list_type_,
+                            vertex_chunk_index, chunk_index));
+    return prefix_ + suffix;
+  };
+  // the files of a chunk are neighboring tasks, so that the threads slice and
+  // encode the same rows while the others write their files
+  std::vector<char> started(task_num, 0);
+  auto status = util::ParallelFor(
+      task_num, num_threads_, [&](int64_t task) -> Status {
+        started[task] = 1;
+        if (task == file_num) {
+          return WriteOffsetChunk(offset_table, vertex_chunk_index);
+        }
+        int kind = kinds[task % kind_num];
+        IdType i = task / kind_num;
+        auto in_chunk = input_table->Slice(i * chunk_size_, chunk_size_);
+        if (kind < 0) {
+          return WriteAdjListChunk(in_chunk, vertex_chunk_index,
+                                   start_chunk_index + i);
+        }
+        return WritePropertyChunk(in_chunk, property_groups[kind],
+                                  vertex_chunk_index, start_chunk_index + i);
+      });
+  if (!status.ok()) {
+    // delete the chunks written or partially written by this call, the
+    // errors of the deletion are ignored
+    for (int64_t task = 0; task < task_num; ++task) {
+      if (!started[task]) {
+        continue;
+      }
+      auto maybe_path = get_path(task);
+      if (!maybe_path.has_error()) {
+        fs_->DeleteFile(maybe_path.value());
+      }
+    }
+  }
+  return status;
 }
 
 Status EdgeChunkWriter::SortAndWriteAdjListTable(
     const std::shared_ptr<arrow::Table>& input_table, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
-  GAR_ASSIGN_OR_RAISE(
-      auto response_table,
-      sortTable(input_table, getSortColumnName(adj_list_type_)));
-
-  if (adj_list_type_ == AdjListType::ordered_by_source ||
-      adj_list_type_ == AdjListType::ordered_by_dest) {
-    GAR_ASSIGN_OR_RAISE(
-        auto offset_table,
-        getOffsetTable(response_table, getSortColumnName(adj_list_type_),
-                       vertex_chunk_index));
-    GAR_RETURN_NOT_OK(WriteOffsetChunk(offset_table, vertex_chunk_index));
-  }
-
-  return WriteAdjListTable(response_table, vertex_chunk_index,
-                           start_chunk_index);
+  return sortAndWrite(input_table, true, {}, vertex_chunk_index,
+                      start_chunk_index);
 }
 
 Status EdgeChunkWriter::SortAndWritePropertyTable(
     const std::shared_ptr<arrow::Table>& input_table,
     const PropertyGroup& property_group, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
-  GAR_ASSIGN_OR_RAISE(
-      auto response_table,
-      sortTable(input_table, getSortColumnName(adj_list_type_)));
-  return WritePropertyTable(response_table, property_group, vertex_chunk_index,
-                            start_chunk_index);
+  return sortAndWrite(input_table, false, {property_group}, vertex_chunk_index,
+                      start_chunk_index);
 }
 
 Status EdgeChunkWriter::SortAndWritePropertyTable(
     const std::shared_ptr<arrow::Table>& input_table, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
-  GAR_ASSIGN_OR_RAISE(
-      auto response_table,
-      sortTable(input_table, getSortColumnName(adj_list_type_)));
-  return WritePropertyTable(response_table, vertex_chunk_index,
-                            start_chunk_index);
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info_.GetPropertyGroups(adj_list_type_));
+  return sortAndWrite(input_table, false, property_groups, vertex_chunk_index,
+                      start_chunk_index);
 }
 
 Status EdgeChunkWriter::SortAndWriteTable(
     const std::shared_ptr<arrow::Table>& input_table, IdType vertex_chunk_index,
     IdType start_chunk_index) const noexcept {
-  GAR_ASSIGN_OR_RAISE(
-      auto response_table,
-      sortTable(input_table, getSortColumnName(adj_list_type_)));
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info_.GetPropertyGroups(adj_list_type_));
+  return sortAndWrite(input_table, true, property_groups, vertex_chunk_index,
+                      start_chunk_index);
+}
+
+Status EdgeChunkWriter::SortAndWriteAdjListTable(
+    arrow::RecordBatchReader* reader, IdType vertex_chunk_index,
+    IdType start_chunk_index) const noexcept {
+  return sortAndWrite(reader, true, {}, vertex_chunk_index, start_chunk_index);
+}
 
-  if (adj_list_type_ == AdjListType::ordered_by_source ||
-      adj_list_type_ == AdjListType::ordered_by_dest) {
+Status EdgeChunkWriter::SortAndWriteTable(arrow::RecordBatchReader* reader,
+                                          IdType vertex_chunk_index,
+                                          IdType start_chunk_index) const
+    noexcept {
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info_.GetPropertyGroups(adj_list_type_));
+  return sortAndWrite(reader, true, property_groups, vertex_chunk_index,
+                      start_chunk_index);
+}
+
+Status EdgeChunkWriter::sortAndWrite(
+    const std::shared_ptr<arrow::Table>& input_table, bool with_adj_list,
+    const std::vector<PropertyGroup>& property_groups,
+    IdType vertex_chunk_index, IdType start_chunk_index) const noexcept {
+  if (GetTableSize(*input_table) > sort_memory_limit_) {
+    // the sorted runs replace the sorted copy of the whole table
+    arrow::TableBatchReader reader(*input_table);
+    reader.set_chunksize(kSpillBatchSize);
+    return sortAndWrite(&reader, with_adj_list, property_groups,
+                        vertex_chunk_index, start_chunk_index);
+  }
+  return sortInMemoryAndWrite(input_table, with_adj_list, property_groups,
+                              vertex_chunk_index, start_chunk_index);
+}
+
+Status EdgeChunkWriter::sortInMemoryAndWrite(
+    const std::shared_ptr<arrow::Table>& input_table, bool with_adj_list,
+    const std::vector<PropertyGroup>& property_groups,
+    IdType vertex_chunk_index, IdType start_chunk_index) const noexcept {
+  std::string column_name = getSortColumnName(adj_list_type_);
+  GAR_ASSIGN_OR_RAISE(auto response_table,
+                      sortTable(input_table, column_name));
+  std::shared_ptr<arrow::Table> offset_table;
+  if (with_adj_list && (adj_list_type_ == AdjListType::ordered_by_source ||
+                        adj_list_type_ == AdjListType::ordered_by_dest)) {
+    GAR_ASSIGN_OR_RAISE(offset_table,
+                        getOffsetTable(response_table, column_name,
+                                       vertex_chunk_index));
+  }
+  return writeTable(response_table, with_adj_list, property_groups,
+                    vertex_chunk_index, start_chunk_index, offset_table);
+}
+
+Status EdgeChunkWriter::sortAndWrite(
+    arrow::RecordBatchReader* reader, bool with_adj_list,
+    const std::vector<PropertyGroup>& property_groups,
+    IdType vertex_chunk_index, IdType start_chunk_index) const noexcept {
+  std::string column_name = getSortColumnName(adj_list_type_);
+  auto schema = reader->schema();
+  int column_index = schema->GetFieldIndex(column_name);
+  if (column_index == -1) {
+    return Status::InvalidOperation("The column " + column_name +
+                                    " to sort by is not provided.");
+  }
+  if (schema->field(column_index)->type()->id() != arrow::Type::INT64) {
+    return Status::TypeError("The column " + column_name +
+                             " to sort by is not of int64.");
+  }
+  std::string spill_dir = spill_dir_;
+  if (spill_dir.empty()) {
+    std::error_code ec;
+    spill_dir = std::filesystem::temp_directory_path(ec).string();
+    if (ec) {
+      return Status::IOError("Failed to get the temporary directory: " +
+                             ec.message());
+    }
+  }
+  SpillFiles runs;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  int64_t buffered_size = 0;
+  // sort the buffered batches and spill them as a run
+  auto spill = [&]() -> Status {
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto run_table, arrow::Table::FromRecordBatches(schema, batches));
+    batches.clear();
+    buffered_size = 0;
+    GAR_ASSIGN_OR_RAISE(auto sorted_table, sortTable(run_table, column_name));
+    run_table.reset();
+    return runs.Write(spill_dir, sorted_table);
+  };
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (true) {
+    RETURN_NOT_ARROW_OK(reader->ReadNext(&batch));
+    if (batch == nullptr) {
+      break;
+    }
+    if (batch->column(column_index)->null_count() > 0) {
+      return Status::Invalid("The column " + column_name +
+                             " to sort by has null values.");
+    }
+    batches.push_back(batch);
+    buffered_size += GetBatchSize(*batch);
+    if (buffered_size > sort_memory_limit_) {
+      GAR_RETURN_NOT_OK(spill());
+    }
+  }
+  if (runs.paths.empty()) {
+    // all the edges fit in the memory limit
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto input_table, arrow::Table::FromRecordBatches(schema, batches));
+    batches.clear();
+    return sortInMemoryAndWrite(input_table, with_adj_list, property_groups,
+                                vertex_chunk_index, start_chunk_index);
+  }
+  if (!batches.empty()) {
+    GAR_RETURN_NOT_OK(spill());
+  }
+  return mergeAndWrite(runs.paths, schema, with_adj_list, property_groups,
+                       vertex_chunk_index, start_chunk_index);
+}
+
+Status EdgeChunkWriter::mergeAndWrite(
+    const std::vector<std::string>& run_paths,
+    const std::shared_ptr<arrow::Schema>& schema, bool with_adj_list,
+    const std::vector<PropertyGroup>& property_groups,
+    IdType vertex_chunk_index, IdType start_chunk_index) const noexcept {
+  std::string column_name = getSortColumnName(adj_list_type_);
+  int column_index = schema->GetFieldIndex(column_name);
+  size_t run_num = run_paths.size();
+  std::vector<RunCursor> cursors(run_num);
+  // the heap of the (key, run) of the next row of each run, the ties are
+  // broken by the run so that the merge is stable
+  using HeapItem = std::pair<IdType, size_t>;
+  std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>>
+      heap;
+  for (size_t r = 0; r < run_num; ++r) {
+    GAR_RETURN_NOT_OK(cursors[r].Open(run_paths[r], column_index));
+    if (cursors[r].batch != nullptr) {
+      heap.emplace(cursors[r].keys[0], r);
+    }
+  }
+
+  // the number of edges whose key is not larger than each vertex of the
+  // vertex chunk, as getOffsetTable
+  bool with_offset =
+      with_adj_list && (adj_list_type_ == AdjListType::ordered_by_source ||
+                        adj_list_type_ == AdjListType::ordered_by_dest);
+  IdType begin_index = vertex_chunk_index * vertex_chunk_size_,
+         end_index = begin_index + vertex_chunk_size_;
+  std::vector<int64_t> offsets(with_offset ? vertex_chunk_size_ + 1 : 0, 0);
+
+  IdType chunk_index = start_chunk_index;
+  // buffer a chunk for each thread, so that the threads of a write encode the
+  // chunks concurrently and are not started again for every chunk
+  int64_t flush_chunk_num =
+      num_threads_ > 0 ? num_threads_
+                       : std::max(1U, std::thread::hardware_concurrency());
+  int64_t flush_rows = chunk_size_ * flush_chunk_num;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> chunk_batches;
+  int64_t chunk_rows = 0;
+  // delete the chunks written by the merge if any write fails, the errors of
+  // the deletion are ignored
+  auto delete_chunks = [&]() {
+    for (IdType i = start_chunk_index; i < chunk_index; ++i) {
+      if (with_adj_list) {
+        auto maybe_suffix = edge_info_.GetAdjListFilePath(vertex_chunk_index,
+                                                          i, adj_list_type_);
+        if (!maybe_suffix.has_error()) {
+          fs_->DeleteFile(prefix_ + maybe_suffix.value());
+        }
+      }
+      for (const auto& property_group : property_groups) {
+        auto maybe_suffix = edge_info_.GetPropertyFilePath(
+            property_group, adj_list_type_, vertex_chunk_index, i);
+        if (!maybe_suffix.has_error()) {
+          fs_->DeleteFile(prefix_ + maybe_suffix.value());
+        }
+      }
+    }
+  };
+  auto flush = [&]() -> Status {
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto chunk_table,
+        arrow::Table::FromRecordBatches(schema, chunk_batches));
+    GAR_RETURN_NOT_OK(writeTable(chunk_table, with_adj_list, property_groups,
+                                 vertex_chunk_index, chunk_index));
+    chunk_index += (chunk_rows + chunk_size_ - 1) / chunk_size_;
+    chunk_batches.clear();
+    chunk_rows = 0;
+    return Status::OK();
+  };
+
+  auto merge = [&]() -> Status {
+    while (!heap.empty()) {
+      size_t r = heap.top().second;
+      heap.pop();
+      auto& cursor = cursors[r];
+      // take the consecutive rows of the run that precede the heads of the
+      // other runs, up to the end of the batch and of the buffered chunks
+      int64_t length = cursor.batch->num_rows();
+      int64_t end = std::min(length, cursor.row + (flush_rows - chunk_rows));
+      int64_t row = cursor.row;
+      if (heap.empty()) {
+        row = end;
+      } else {
+        HeapItem next = heap.top();
+        while (row < end && HeapItem(cursor.keys[row], r) < next) {
+          ++row;
+        }
+      }
+      if (with_offset) {
+        for (int64_t i = cursor.row; i < row; ++i) {
+          IdType key = cursor.keys[i];
+          if (key < end_index) {
+            ++offsets[std::max(key, begin_index) - begin_index + 1];
+          }
+        }
+      }
+      chunk_batches.push_back(
+          cursor.batch->Slice(cursor.row, row - cursor.row));
+      chunk_rows += row - cursor.row;
+      cursor.row = row;
+      if (chunk_rows == flush_rows) {
+        GAR_RETURN_NOT_OK(flush());
+      }
+      if (cursor.row == length) {
+        GAR_RETURN_NOT_OK(cursor.Next());
+      }
+      if (cursor.batch != nullptr) {
+        heap.emplace(cursor.keys[cursor.row], r);
+      }
+    }
+    if (chunk_rows > 0) {
+      GAR_RETURN_NOT_OK(flush());
+    }
+    if (!with_offset) {
+      return Status::OK();
+    }
+    for (size_t i = 1; i < offsets.size(); ++i) {
+      offsets[i] += offsets[i - 1];
+    }
+    arrow::Int64Builder builder;
+    RETURN_NOT_ARROW_OK(builder.AppendValues(offsets));
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto array, builder.Finish());
+    auto offset_table = arrow::Table::Make(
+        arrow::schema({arrow::field(GeneralParams::kOffsetCol,
+                                    arrow::int64())}),
+        {array});
+    return WriteOffsetChunk(offset_table, vertex_chunk_index);
+  };
+
+  auto status = merge();
+  if (!status.ok()) {
+    delete_chunks();
+  }
+  return status;
+}
+
+Status EdgeChunkWriter::WriteManifest(IdType vertex_chunk_num) const noexcept {
+  GAR_ASSIGN_OR_RAISE(auto adj_list_path_prefix,
+                      edge_info_.GetAdjListPathPrefix(adj_list_type_));
+  GAR_ASSIGN_OR_RAISE(auto file_type, edge_info_.GetFileType(adj_list_type_));
+  std::string dir_path = prefix_ + adj_list_path_prefix;
+  GAR_ASSIGN_OR_RAISE(
+      auto manifest,
+      ChunkManifest::Build(fs_, dir_path, file_type, vertex_chunk_num));
+  // the zone maps of the chunks written from tables are collected at write
+  // time, only the other chunks are read
+  std::map<std::pair<IdType, IdType>, ChunkZoneMap> written;
+  {
+    std::lock_guard<std::mutex> lock(written_chunks_->mutex);
+    written = written_chunks_->zone_maps;
+  }
+  GAR_ASSIGN_OR_RAISE(auto chunk_nums, manifest->GetChunkNums());
+  std::vector<ChunkZoneMap> zone_maps;
+  for (IdType i = 0; i < static_cast<IdType>(chunk_nums.size()); ++i) {
+    for (IdType j = 0; j < chunk_nums[i]; ++j) {
+      auto it = written.find({i, j});
+      if (it != written.end()) {
+        zone_maps.push_back(it->second);
+        continue;
+      }
+      GAR_ASSIGN_OR_RAISE(auto suffix,
+                          edge_info_.GetAdjListFilePath(i, j, adj_list_type_));
+      GAR_ASSIGN_OR_RAISE(
+          auto zone_map,
+          ChunkManifest::ReadZoneMap(fs_, prefix_ + suffix, file_type));
+      zone_maps.push_back(zone_map);
+    }
+  }
+  manifest = std::make_shared<ChunkManifest>(
+      std::move(chunk_nums), manifest->GetRowNums(), manifest->GetSizes(),
+      std::move(zone_maps));
+  GAR_RETURN_NOT_OK(manifest->Dump(fs_, dir_path));
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info_.GetPropertyGroups(adj_list_type_));
+  for (const auto& property_group : property_groups) {
     GAR_ASSIGN_OR_RAISE(
-        auto offset_table,
-        getOffsetTable(response_table, getSortColumnName(adj_list_type_),
-                       vertex_chunk_index));
-    GAR_RETURN_NOT_OK(WriteOffsetChunk(offset_table, vertex_chunk_index));
+        auto pg_path_prefix,
+        edge_info_.GetPropertyGroupPathPrefix(property_group, adj_list_type_));
+    dir_path = prefix_ + pg_path_prefix;
+    GAR_ASSIGN_OR_RAISE(
+        manifest, ChunkManifest::Build(fs_, dir_path,
+                                       property_group.GetFileType(),
+                                       vertex_chunk_num));
+    GAR_RETURN_NOT_OK(manifest->Dump(fs_, dir_path));
   }
+  // the chunks written from now on delete the manifests again
+  std::lock_guard<std::mutex> lock(written_chunks_->mutex);
+  written_chunks_->invalidated_dirs.clear();
+  return Status::OK();
+}
 
-  return WriteTable(response_table, vertex_chunk_index, start_chunk_index);
+Status EdgeChunkWriter::invalidateManifest(const std::string& dir_path) const
+    noexcept {
+  {
+    std::lock_guard<std::mutex> lock(written_chunks_->mutex);
+    if (!written_chunks_->invalidated_dirs.insert(dir_path).second) {
+      return Status::OK();
+    }
+  }
+  auto status = fs_->DeleteFile(ChunkManifest::GetPath(dir_path));
+  if (!status.ok()) {
+    std::lock_guard<std::mutex> lock(written_chunks_->mutex);
+    written_chunks_->invalidated_dirs.erase(dir_path);
+  }
+  return status;
+}
+
+Status EdgeChunkWriter::invalidateAdjListManifest() const noexcept {
+  GAR_ASSIGN_OR_RAISE(auto adj_list_path_prefix,
+                      edge_info_.GetAdjListPathPrefix(adj_list_type_));
+  return invalidateManifest(prefix_ + adj_list_path_prefix);
+}
+
+Status EdgeChunkWriter::invalidatePropertyManifest(
+    const PropertyGroup& property_group) const noexcept {
+  GAR_ASSIGN_OR_RAISE(
+      auto pg_path_prefix,
+      edge_info_.GetPropertyGroupPathPrefix(property_group, adj_list_type_));
+  return invalidateManifest(prefix_ + pg_path_prefix);
 }
 
 Result<std::shared_ptr<arrow::Table>> EdgeChunkWriter::getOffsetTable(
@@ -471,26 +1047,15 @@ Result<std::shared_ptr<arrow::Table>> EdgeChunkWriter::getOffsetTable(
 Result<std::shared_ptr<arrow::Table>> EdgeChunkWriter::sortTable(
     const std::shared_ptr<arrow::Table>& input_table,
     const std::string& column_name) {
-  auto exec_context = arrow::compute::default_exec_context();
-  auto plan = arrow::compute::ExecPlan::Make(exec_context).ValueOrDie();
-  int max_batch_size = 2;
-  auto table_source_options =
-      arrow::compute::TableSourceNodeOptions{input_table, max_batch_size};
-  auto source = arrow::compute::MakeExecNode("table_source", plan.get(), {},
-                                             table_source_options)
-                    .ValueOrDie();
-  AsyncGeneratorType sink_gen;
-  if (!arrow::compute::MakeExecNode(
-           "order_by_sink", plan.get(), {source},
-           arrow::compute::OrderBySinkNodeOptions{
-               arrow::compute::SortOptions{{arrow::compute::SortKey{
-                   column_name, arrow::compute::SortOrder::Ascending}}},
-               &sink_gen})
-           .ok()) {
-    return Status::InvalidOperation();
-  }
-  return ExecutePlanAndCollectAsTable(*exec_context, plan,
-                                      input_table->schema(), sink_gen);
+  // the stable sort indices of the whole table, then one take of the rows
+  arrow::compute::SortOptions options{{arrow::compute::SortKey{
+      column_name, arrow::compute::SortOrder::Ascending}}};
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      auto indices,
+      arrow::compute::SortIndices(arrow::Datum(input_table), options));
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      auto sorted, arrow::compute::Take(input_table, indices));
+  return sorted.table();
 }
 
 }  // namespace GAR_NAMESPACE_INTERNAL
@@ -0,0 +1,100 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <utility>
+
+#include "gar/engine/bfs.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+namespace engine {
+
+namespace {
+// the sum of the degrees of the active vertices
+int64_t SumDegrees(const CSR& csr, const Frontier& frontier) {
+  int64_t sum = 0;
+  if (frontier.IsDense()) {
+    for (IdType vid = 0; vid < frontier.GetVertexNum(); ++vid) {
+      if (frontier.Contains(vid)) {
+        sum += csr.GetDegree(vid);
+      }
+    }
+  } else {
+    for (IdType vid : frontier.GetVertices()) {
+      sum += csr.GetDegree(vid);
+    }
+  }
+  return sum;
+}
+}  // namespace
+
+Result<std::vector<int32_t>> BFS(const BSPEngine& engine, IdType root,
+                                 const BFSOptions& options) noexcept {
+  IdType vertex_num = engine.GetVertexNum();
+  if (root < 0 || root >= vertex_num) {
+    return Status::OutOfRange("The root " + std::to_string(root) +
+                              " is out of range [0, " +
+                              std::to_string(vertex_num) + ").");
+  }
+  // the distances are only written to the next buffer, which is made current
+  // once at the end, so the steps need not copy the buffers
+  VertexState<int32_t> distance(vertex_num, -1);
+  distance.SetNext(root, 0);
+  Frontier frontier(vertex_num);
+  frontier.Add(root);
+  bool optimize = engine.CanPush() && engine.CanPull();
+  bool bottom_up = !engine.CanPush();
+  // the edges a bottom-up step checks, the incoming edges of the unvisited
+  int64_t unvisited_edges = 0;
+  if (optimize) {
+    unvisited_edges = engine.GetInEdges()->GetEdgeNum() -
+                      engine.GetInEdges()->GetDegree(root);
+  }
+  IdType prev_size = 0;
+  for (int32_t depth = 1; !frontier.Empty(); ++depth) {
+    if (optimize) {
+      if (bottom_up) {
+        bottom_up = !(frontier.Size() < prev_size &&
+                      frontier.Size() * options.beta < vertex_num);
+      } else {
+        bottom_up = SumDegrees(*engine.GetOutEdges(), frontier) *
+                        options.alpha >
+                    unvisited_edges;
+      }
+    }
+    auto visit = [&](IdType, IdType dst) {
+      return distance.CompareAndSetNext(dst, -1, depth);
+    };
+    auto unvisited = [&](IdType dst) { return distance.GetNext(dst) == -1; };
+    Frontier next(vertex_num);
+    if (bottom_up) {
+      GAR_RETURN_NOT_OK(engine.Pull(frontier, visit, unvisited, &next));
+    } else {
+      GAR_RETURN_NOT_OK(engine.Push(frontier, visit, unvisited, &next));
+    }
+    if (optimize) {
+      unvisited_edges -= SumDegrees(*engine.GetInEdges(), next);
+    }
+    prev_size = frontier.Size();
+    frontier = std::move(next);
+  }
+  distance.Swap();
+  return distance.GetValues();
+}
+
+}  // namespace engine
+
+}  // namespace GAR_NAMESPACE_INTERNAL
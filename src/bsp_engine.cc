@@ -0,0 +1,109 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "arrow/api.h"
+
+#include "gar/engine/bsp_engine.h"
+#include "gar/writer/arrow_chunk_writer.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+namespace engine {
+
+Result<std::shared_ptr<BSPEngine>> BSPEngine::Make(
+    const GraphInfo& graph_info, const std::string& src_label,
+    const std::string& edge_label, const std::string& dst_label,
+    const BSPOptions& options) noexcept {
+  if (src_label != dst_label) {
+    return Status::Invalid(
+        "The BSP engine requires the same source and destination label, but "
+        "got " +
+        src_label + " and " + dst_label + ".");
+  }
+  GAR_ASSIGN_OR_RAISE(auto vertex_info, graph_info.GetVertexInfo(src_label));
+  GAR_ASSIGN_OR_RAISE(auto edge_info,
+                      graph_info.GetEdgeInfo(src_label, edge_label, dst_label));
+  CSROptions csr_options;
+  csr_options.num_threads = options.num_threads;
+  std::shared_ptr<CSR> out_edges, in_edges;
+  if (edge_info.ContainAdjList(AdjListType::ordered_by_source)) {
+    GAR_ASSIGN_OR_RAISE(
+        out_edges,
+        LoadCSR(graph_info, src_label, edge_label, dst_label,
+                AdjListType::ordered_by_source, csr_options));
+  }
+  if (edge_info.ContainAdjList(AdjListType::ordered_by_dest)) {
+    GAR_ASSIGN_OR_RAISE(
+        in_edges, LoadCSR(graph_info, src_label, edge_label, dst_label,
+                          AdjListType::ordered_by_dest, csr_options));
+  }
+  if (out_edges == nullptr && in_edges == nullptr) {
+    return Status::Invalid("The edge type " + src_label + "_" + edge_label +
+                           "_" + dst_label + " has no ordered adj list.");
+  }
+  IdType vertex_num = out_edges != nullptr ? out_edges->GetVertexNum()
+                                           : in_edges->GetVertexNum();
+  return std::make_shared<BSPEngine>(std::move(out_edges), std::move(in_edges),
+                                     vertex_num, vertex_info.GetChunkSize(),
+                                     options);
+}
+
+template <typename T>
+Status WriteVertexProperty(const VertexInfo& vertex_info,
+                           const PropertyGroup& property_group,
+                           const std::string& prefix,
+                           const std::vector<T>& values) noexcept {
+  const auto& properties = property_group.GetProperties();
+  if (properties.size() != 1) {
+    return Status::Invalid(
+        "The property group to write must have exactly one property, but it "
+        "has " +
+        std::to_string(properties.size()) + ".");
+  }
+  auto type = arrow::CTypeTraits<T>::type_singleton();
+  if (!DataType::DataTypeToArrowDataType(properties[0].type)->Equals(type)) {
+    return Status::TypeError("The values of type " + type->ToString() +
+                             " do not match the property " +
+                             properties[0].name + ".");
+  }
+  typename arrow::CTypeTraits<T>::BuilderType builder;
+  RETURN_NOT_ARROW_OK(builder.AppendValues(values));
+  std::shared_ptr<arrow::Array> array;
+  RETURN_NOT_ARROW_OK(builder.Finish(&array));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(properties[0].name, type)}), {array});
+  VertexPropertyWriter writer(vertex_info, prefix);
+  return writer.WriteTable(table, property_group, 0);
+}
+
+template Status WriteVertexProperty<int32_t>(
+    const VertexInfo& vertex_info, const PropertyGroup& property_group,
+    const std::string& prefix, const std::vector<int32_t>& values) noexcept;
+
+template Status WriteVertexProperty<int64_t>(
+    const VertexInfo& vertex_info, const PropertyGroup& property_group,
+    const std::string& prefix, const std::vector<int64_t>& values) noexcept;
+
+template Status WriteVertexProperty<float>(
+    const VertexInfo& vertex_info, const PropertyGroup& property_group,
+    const std::string& prefix, const std::vector<float>& values) noexcept;
+
+template Status WriteVertexProperty<double>(
+    const VertexInfo& vertex_info, const PropertyGroup& property_group,
+    const std::string& prefix, const std::vector<double>& values) noexcept;
+
+}  // namespace engine
+
+}  // namespace GAR_NAMESPACE_INTERNAL
@@ -0,0 +1,259 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "arrow/api.h"
+#include "arrow/io/interfaces.h"
+#include "arrow/util/byte_size.h"
+#include "arrow/util/thread_pool.h"
+
+#include "gar/utils/chunk_cache.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+namespace {
+// the loads of Prefetch() run on their own pool: the CSV and Parquet readers
+// schedule work on the arrow IO pool and block on it, which deadlocks once the
+// loads occupy all the threads of the IO pool
+Result<arrow::internal::Executor*> GetPrefetchExecutor() {
+  // never destroyed, as the global cache
+  static auto maybe_pool = arrow::internal::ThreadPool::MakeEternal(
+      arrow::io::GetIOThreadPoolCapacity());
+  if (!maybe_pool.ok()) {
+    return Status::ArrowError(maybe_pool.status().ToString());
+  }
+  return maybe_pool.ValueUnsafe().get();
+}
+}  // namespace
+
+ChunkCache& ChunkCache::Global() noexcept {
+  // never destroyed, the background loads may outlive the static destruction
+  // of the arrow thread pools
+  static ChunkCache* cache = new ChunkCache();
+  return *cache;
+}
+
+ChunkCache::~ChunkCache() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this]() { return running_ == 0; });
+}
+
+std::string ChunkCache::makeKey(const std::string& path,
+                                const std::vector<std::string>& columns) {
+  // '\0' can not appear in a path or a column name, so the keys of the same
+  // path always share the prefix path + '\0'
+  std::string key = path;
+  key.push_back('\0');
+  for (const auto& column : columns) {
+    key.append(column);
+    key.push_back('\0');
+  }
+  return key;
+}
+
+Result<std::shared_ptr<arrow::Table>> ChunkCache::GetOrLoad(
+    const std::string& path, const std::vector<std::string>& columns,
+    const Loader& loader) noexcept {
+  std::string key = makeKey(path, columns);
+  std::shared_ptr<Promise> promise;
+  std::shared_future<Result<std::shared_ptr<arrow::Table>>> future;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->table;
+    }
+    auto pending_it = pending_.find(key);
+    if (pending_it != pending_.end()) {
+      // being loaded by a prefetch or another reader
+      ++hits_;
+      future = pending_it->second.future;
+    } else {
+      ++misses_;
+      promise = addPending(key);
+    }
+  }
+  if (future.valid()) {
+    return future.get();
+  }
+  return load(key, loader, promise);
+}
+
+std::shared_ptr<arrow::Table> ChunkCache::Get(
+    const std::string& path, const std::vector<std::string>& columns) noexcept {
+  std::string key = makeKey(path, columns);
+  std::shared_future<Result<std::shared_ptr<arrow::Table>>> future;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->table;
+    }
+    auto pending_it = pending_.find(key);
+    if (pending_it == pending_.end()) {
+      return nullptr;
+    }
+    ++hits_;
+    future = pending_it->second.future;
+  }
+  const auto& result = future.get();
+  return result.status().ok() ? result.value() : nullptr;
+}
+
+void ChunkCache::Prefetch(const std::string& path,
+                          const std::vector<std::string>& columns,
+                          Loader loader) noexcept {
+  std::string key = makeKey(path, columns);
+  std::shared_ptr<Promise> promise;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || index_.find(key) != index_.end() ||
+        pending_.find(key) != pending_.end()) {
+      return;
+    }
+    ++prefetches_;
+    ++running_;
+    promise = addPending(key);
+  }
+  auto task = [this, key, loader = std::move(loader), promise]() {
+    // the waiters get the result through the promise
+    static_cast<void>(load(key, loader, promise));
+    std::lock_guard<std::mutex> lock(mutex_);
+    --running_;
+    idle_.notify_all();
+  };
+  auto maybe_executor = GetPrefetchExecutor();
+  Status status = maybe_executor.status();
+  if (status.ok()) {
+    auto spawn_status = maybe_executor.value()->Spawn(std::move(task));
+    if (!spawn_status.ok()) {
+      status = Status::IOError(spawn_status.ToString());
+    }
+  }
+  if (!status.ok()) {
+    // fail the waiters, the next lookup loads the chunk in the foreground
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(key);
+    if (it != pending_.end() && it->second.promise == promise) {
+      pending_.erase(it);
+    }
+    --running_;
+    promise->set_value(status);
+  }
+}
+
+std::shared_ptr<ChunkCache::Promise> ChunkCache::addPending(
+    const std::string& key) {
+  auto promise = std::make_shared<Promise>();
+  pending_.emplace(key, Pending{promise, promise->get_future().share()});
+  return promise;
+}
+
+Result<std::shared_ptr<arrow::Table>> ChunkCache::load(
+    const std::string& key, const Loader& loader,
+    const std::shared_ptr<Promise>& promise) {
+  auto result = loader();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(key);
+    // the pending load is dropped by Invalidate() or Clear() if the file is
+    // modified meanwhile, the table may be stale then and is not cached
+    if (it != pending_.end() && it->second.promise == promise) {
+      pending_.erase(it);
+      if (result.status().ok()) {
+        auto table = result.value();
+        int64_t size = arrow::util::TotalBufferSize(*table);
+        if (size <= capacity_ && index_.find(key) == index_.end()) {
+          lru_.push_front(Entry{key, table, size});
+          index_.emplace(key, lru_.begin());
+          size_ += size;
+          evict();
+        }
+      }
+    }
+  }
+  promise->set_value(result);
+  return result;
+}
+
+void ChunkCache::Invalidate(const std::string& path) noexcept {
+  std::string prefix = path;
+  prefix.push_back('\0');
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.lower_bound(prefix);
+  while (it != index_.end() &&
+         it->first.compare(0, prefix.size(), prefix) == 0) {
+    size_ -= it->second->size;
+    lru_.erase(it->second);
+    it = index_.erase(it);
+  }
+  auto pending_it = pending_.lower_bound(prefix);
+  while (pending_it != pending_.end() &&
+         pending_it->first.compare(0, prefix.size(), prefix) == 0) {
+    pending_it = pending_.erase(pending_it);
+  }
+}
+
+void ChunkCache::Clear() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lru_.clear();
+  index_.clear();
+  pending_.clear();
+  size_ = 0;
+}
+
+void ChunkCache::SetCapacity(int64_t capacity) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  evict();
+}
+
+int64_t ChunkCache::GetCapacity() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+ChunkCacheStats ChunkCache::GetStats() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ChunkCacheStats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.prefetches = prefetches_;
+  stats.evictions = evictions_;
+  stats.num_entries = static_cast<int64_t>(lru_.size());
+  stats.size = size_;
+  stats.capacity = capacity_;
+  return stats;
+}
+
+void ChunkCache::ResetStats() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  hits_ = misses_ = prefetches_ = evictions_ = 0;
+}
+
+void ChunkCache::evict() {
+  while (size_ > capacity_ && !lru_.empty()) {
+    const auto& entry = lru_.back();
+    size_ -= entry.size;
+    index_.erase(entry.key);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
+
+}  // namespace GAR_NAMESPACE_INTERNAL
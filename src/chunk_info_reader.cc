@@ -33,9 +33,8 @@ Status AdjListChunkInfoReader::seek_src(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
   }
 
   if (adj_list_type_ == AdjListType::unordered_by_source) {
@@ -62,9 +61,8 @@ Status AdjListChunkInfoReader::seek_dst(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
   }
 
   if (adj_list_type_ == AdjListType::unordered_by_dest) {
@@ -90,9 +88,8 @@ Status AdjListPropertyChunkInfoReader::seek_src(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
   }
   if (adj_list_type_ == AdjListType::unordered_by_source) {
     return seek(0);  // start from first chunk
@@ -118,9 +115,8 @@ Status AdjListPropertyChunkInfoReader::seek_dst(IdType id) noexcept {
   }
   if (vertex_chunk_index_ != new_vertex_chunk_index) {
     vertex_chunk_index_ = new_vertex_chunk_index;
-    std::string chunk_dir =
-        base_dir_ + "/part" + std::to_string(vertex_chunk_index_);
-    GAR_ASSIGN_OR_RAISE(chunk_num_, fs_->GetFileNumOfDir(chunk_dir));
+    GAR_ASSIGN_OR_RAISE(chunk_num_,
+                        manifest_->GetChunkNum(vertex_chunk_index_));
   }
 
   if (adj_list_type_ == AdjListType::unordered_by_dest) {
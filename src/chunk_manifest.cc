@@ -0,0 +1,260 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <limits>
+
+#include "arrow/api.h"
+#include "yaml-cpp/yaml.h"
+
+#include "gar/utils/chunk_manifest.h"
+#include "gar/utils/general_params.h"
+#include "gar/utils/yaml.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+namespace {
+// read a sequence of integers of the manifest
+template <typename T>
+Result<std::vector<T>> GetSequence(const Yaml& yaml, const std::string& key) {
+  std::vector<T> values;
+  const auto node = yaml[key];
+  if (!node.IsDefined() || node.IsNull()) {
+    return values;
+  }
+  if (!node.IsSequence()) {
+    return Status::YamlError("The " + key + " of the manifest is invalid.");
+  }
+  values.reserve(node.size());
+  try {
+    for (const auto& value : node) {
+      values.push_back(value.as<T>());
+    }
+  } catch (YAML::Exception& e) { return Status::YamlError(e.what()); }
+  return values;
+}
+
+// read the zone maps of the manifest, one [src_min, src_max, dst_min, dst_max]
+// sequence for each edge chunk
+Result<std::vector<ChunkZoneMap>> ReadZoneMaps(
+    const Yaml& yaml, const std::vector<IdType>& chunk_nums) {
+  GAR_ASSIGN_OR_RAISE(auto ranges,
+                      GetSequence<std::vector<IdType>>(yaml, "zone_maps"));
+  if (ranges.empty()) {
+    return std::vector<ChunkZoneMap>();
+  }
+  IdType chunk_num = 0;
+  for (auto num : chunk_nums) {
+    chunk_num += num;
+  }
+  if (static_cast<IdType>(ranges.size()) != chunk_num) {
+    return Status::YamlError(
+        "The zone maps of the manifest do not match the chunk numbers.");
+  }
+  std::vector<ChunkZoneMap> zone_maps;
+  zone_maps.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    if (range.size() != 4) {
+      return Status::YamlError("The zone map of the manifest is invalid.");
+    }
+    zone_maps.push_back({range[0], range[1], range[2], range[3]});
+  }
+  return zone_maps;
+}
+
+// collect the range of an id column
+void UpdateRange(const std::shared_ptr<arrow::ChunkedArray>& column,
+                 IdType* min, IdType* max) {
+  for (const auto& array : column->chunks()) {
+    auto ids = std::static_pointer_cast<arrow::Int64Array>(array);
+    const int64_t* values = ids->raw_values();
+    for (int64_t i = 0; i < ids->length(); ++i) {
+      *min = std::min(*min, values[i]);
+      *max = std::max(*max, values[i]);
+    }
+  }
+}
+
+// get the path of the directory without the trailing slashes
+std::string TrimTrailingSlashes(const std::string& dir_path) {
+  std::string path = dir_path;
+  while (!path.empty() && path.back() == '/') {
+    path.pop_back();
+  }
+  return path;
+}
+}  // namespace
+
+std::string ChunkManifest::GetPath(const std::string& dir_path) noexcept {
+  return TrimTrailingSlashes(dir_path) + kSuffix;
+}
+
+Result<ChunkZoneMap> ChunkManifest::MakeZoneMap(
+    const std::shared_ptr<arrow::Table>& table) noexcept {
+  constexpr IdType kMin = std::numeric_limits<IdType>::min();
+  constexpr IdType kMax = std::numeric_limits<IdType>::max();
+  ChunkZoneMap zone_map{kMax, kMin, kMax, kMin};
+  auto src = table->GetColumnByName(GeneralParams::kSrcIndexCol);
+  auto dst = table->GetColumnByName(GeneralParams::kDstIndexCol);
+  if (src == nullptr || dst == nullptr ||
+      src->type()->id() != arrow::Type::INT64 ||
+      dst->type()->id() != arrow::Type::INT64) {
+    return Status::Invalid("The table is not an adj list chunk.");
+  }
+  UpdateRange(src, &zone_map.src_min, &zone_map.src_max);
+  UpdateRange(dst, &zone_map.dst_min, &zone_map.dst_max);
+  return zone_map;
+}
+
+Result<ChunkZoneMap> ChunkManifest::ReadZoneMap(
+    const std::shared_ptr<FileSystem>& fs, const std::string& path,
+    FileType file_type) noexcept {
+  GAR_ASSIGN_OR_RAISE(auto table,
+                      fs->ReadFileToTable(path, file_type,
+                                          {GeneralParams::kSrcIndexCol,
+                                           GeneralParams::kDstIndexCol}));
+  auto maybe_zone_map = MakeZoneMap(table);
+  if (!maybe_zone_map.status().ok()) {
+    return Status::Invalid("The chunk " + path + " is not an adj list chunk.");
+  }
+  return maybe_zone_map.value();
+}
+
+Result<std::shared_ptr<ChunkManifest>> ChunkManifest::Make(
+    const std::shared_ptr<FileSystem>& fs,
+    const std::string& dir_path) noexcept {
+  const std::string path = GetPath(dir_path);
+  GAR_ASSIGN_OR_RAISE(auto exists, fs->FileExists(path));
+  if (exists) {
+    GAR_ASSIGN_OR_RAISE(auto content, fs->ReadFileToValue<std::string>(path));
+    GAR_ASSIGN_OR_RAISE(auto yaml, Yaml::Load(content));
+    if (!(*yaml)["chunk_nums"].IsDefined()) {
+      return Status::YamlError("The manifest " + path + " has no chunk_nums.");
+    }
+    GAR_ASSIGN_OR_RAISE(auto chunk_nums,
+                        GetSequence<IdType>(*yaml, "chunk_nums"));
+    GAR_ASSIGN_OR_RAISE(auto row_nums, GetSequence<IdType>(*yaml, "row_nums"));
+    GAR_ASSIGN_OR_RAISE(auto sizes, GetSequence<int64_t>(*yaml, "sizes"));
+    GAR_ASSIGN_OR_RAISE(auto zone_maps, ReadZoneMaps(*yaml, chunk_nums));
+    return std::make_shared<ChunkManifest>(
+        std::move(chunk_nums), std::move(row_nums), std::move(sizes),
+        std::move(zone_maps));
+  }
+  // no manifest, list the part<i> directories on demand
+  GAR_ASSIGN_OR_RAISE(auto vertex_chunk_num, fs->GetFileNumOfDir(dir_path));
+  auto manifest = std::make_shared<ChunkManifest>(
+      std::vector<IdType>(vertex_chunk_num, -1));
+  manifest->fs_ = fs;
+  manifest->dir_path_ = TrimTrailingSlashes(dir_path);
+  return manifest;
+}
+
+Result<std::shared_ptr<ChunkManifest>> ChunkManifest::Build(
+    const std::shared_ptr<FileSystem>& fs, const std::string& dir_path,
+    FileType file_type, IdType vertex_chunk_num,
+    bool with_zone_maps) noexcept {
+  bool listed = vertex_chunk_num < 0;
+  if (listed) {
+    GAR_ASSIGN_OR_RAISE(vertex_chunk_num, fs->GetFileNumOfDir(dir_path));
+  }
+  std::vector<IdType> chunk_nums(vertex_chunk_num, 0);
+  std::vector<IdType> row_nums(vertex_chunk_num, 0);
+  std::vector<int64_t> sizes(vertex_chunk_num, 0);
+  std::vector<ChunkZoneMap> zone_maps;
+  std::string base_dir = TrimTrailingSlashes(dir_path);
+  for (IdType i = 0; i < vertex_chunk_num; ++i) {
+    std::string chunk_dir = base_dir + "/part" + std::to_string(i);
+    auto maybe_chunk_num = fs->GetFileNumOfDir(chunk_dir);
+    if (!maybe_chunk_num.status().ok()) {
+      if (listed) {
+        return maybe_chunk_num.status();
+      }
+      continue;  // the writers skip the vertex chunks without edges
+    }
+    chunk_nums[i] = maybe_chunk_num.value();
+    for (IdType j = 0; j < chunk_nums[i]; ++j) {
+      std::string path = chunk_dir + "/chunk" + std::to_string(j);
+      GAR_ASSIGN_OR_RAISE(auto row_num, fs->GetRowNumOfFile(path, file_type));
+      GAR_ASSIGN_OR_RAISE(auto size, fs->GetFileSize(path));
+      row_nums[i] += row_num;
+      sizes[i] += size;
+      if (with_zone_maps) {
+        GAR_ASSIGN_OR_RAISE(auto zone_map, ReadZoneMap(fs, path, file_type));
+        zone_maps.push_back(zone_map);
+      }
+    }
+  }
+  return std::make_shared<ChunkManifest>(
+      std::move(chunk_nums), std::move(row_nums), std::move(sizes),
+      std::move(zone_maps));
+}
+
+Result<IdType> ChunkManifest::GetChunkNum(IdType vertex_chunk_index) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return getChunkNum(vertex_chunk_index);
+}
+
+Result<std::vector<IdType>> ChunkManifest::GetChunkNums() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (IdType i = 0; i < GetVertexChunkNum(); ++i) {
+    GAR_RETURN_NOT_OK(getChunkNum(i).status());
+  }
+  return chunk_nums_;
+}
+
+Result<IdType> ChunkManifest::getChunkNum(IdType vertex_chunk_index) {
+  if (vertex_chunk_index < 0 || vertex_chunk_index >= GetVertexChunkNum()) {
+    return Status::KeyError("The vertex chunk " +
+                            std::to_string(vertex_chunk_index) +
+                            " does not exist.");
+  }
+  if (chunk_nums_[vertex_chunk_index] < 0) {
+    std::string chunk_dir =
+        dir_path_ + "/part" + std::to_string(vertex_chunk_index);
+    GAR_ASSIGN_OR_RAISE(chunk_nums_[vertex_chunk_index],
+                        fs_->GetFileNumOfDir(chunk_dir));
+  }
+  return chunk_nums_[vertex_chunk_index];
+}
+
+Status ChunkManifest::Dump(const std::shared_ptr<FileSystem>& fs,
+                           const std::string& dir_path) noexcept {
+  GAR_ASSIGN_OR_RAISE(auto chunk_nums, GetChunkNums());
+  YAML::Node node;
+  node["chunk_nums"] = chunk_nums;
+  node["chunk_nums"].SetStyle(YAML::EmitterStyle::Flow);
+  if (HasStatistics()) {
+    node["row_nums"] = row_nums_;
+    node["row_nums"].SetStyle(YAML::EmitterStyle::Flow);
+    node["sizes"] = sizes_;
+    node["sizes"].SetStyle(YAML::EmitterStyle::Flow);
+  }
+  if (HasZoneMaps()) {
+    node["zone_maps"] = YAML::Node(YAML::NodeType::Sequence);
+    for (const auto& zone_map : zone_maps_) {
+      YAML::Node range;
+      range.push_back(zone_map.src_min);
+      range.push_back(zone_map.src_max);
+      range.push_back(zone_map.dst_min);
+      range.push_back(zone_map.dst_max);
+      range.SetStyle(YAML::EmitterStyle::Flow);
+      node["zone_maps"].push_back(range);
+    }
+  }
+  return fs->WriteValueToFile<std::string>(YAML::Dump(node),
+                                           GetPath(dir_path));
+}
+
+}  // namespace GAR_NAMESPACE_INTERNAL
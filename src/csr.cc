@@ -0,0 +1,406 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/io/file.h"
+
+#include "gar/csr.h"
+#include "gar/utils/filesystem.h"
+#include "gar/utils/general_params.h"
+#include "gar/utils/reader_utils.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+namespace {
+// the memory of the arrays of a CSR, allocated in memory or mapped to a file
+class CSRStorage {
+ public:
+  static Result<std::unique_ptr<CSRStorage>> Make(
+      int64_t size, const std::string& mmap_path) {
+    std::unique_ptr<CSRStorage> storage(new CSRStorage());
+    if (mmap_path.empty()) {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(storage->buffer_,
+                                           arrow::AllocateBuffer(size));
+    } else {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+          storage->file_, arrow::io::MemoryMappedFile::Create(mmap_path, size));
+    }
+    storage->size_ = size;
+    return storage;
+  }
+
+  // write the data at the position, thread-safe for disjoint ranges
+  Status Write(int64_t position, const void* data, int64_t nbytes) {
+    if (file_ != nullptr) {
+      RETURN_NOT_ARROW_OK(file_->WriteAt(position, data, nbytes));
+    } else {
+      std::memcpy(buffer_->mutable_data() + position, data, nbytes);
+    }
+    return Status::OK();
+  }
+
+  Result<std::shared_ptr<arrow::Buffer>> Finish() {
+    if (file_ != nullptr) {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto buffer,
+                                           file_->ReadAt(0, size_));
+      return buffer;
+    }
+    return std::shared_ptr<arrow::Buffer>(std::move(buffer_));
+  }
+
+ private:
+  CSRStorage() = default;
+
+  std::unique_ptr<arrow::Buffer> buffer_;
+  std::shared_ptr<arrow::io::MemoryMappedFile> file_;
+  int64_t size_ = 0;
+};
+
+// read the number of vertices of a label
+Result<IdType> ReadVertexNum(const GraphInfo& graph_info,
+                             const std::shared_ptr<FileSystem>& fs,
+                             const std::string& base_dir,
+                             const std::string& label) {
+  GAR_ASSIGN_OR_RAISE(auto vertex_info, graph_info.GetVertexInfo(label));
+  GAR_ASSIGN_OR_RAISE(auto file_path, vertex_info.GetVerticesNumFilePath());
+  return fs->ReadFileToValue<IdType>(base_dir + file_path);
+}
+
+// the layout of an ordered adj list
+struct OrderedAdjList {
+  EdgeInfo edge_info;
+  AdjListType adj_list_type;
+  FileType file_type;
+  std::shared_ptr<FileSystem> fs;
+  std::string base_dir;
+  // the number of the vertices the offsets are indexed by
+  IdType vertex_num;
+  IdType vertex_chunk_size;
+  IdType vertex_chunk_num;
+  // the number of edge chunks of each vertex chunk
+  std::vector<IdType> edge_chunk_nums;
+};
+
+Result<OrderedAdjList> OpenOrderedAdjList(const GraphInfo& graph_info,
+                                          const std::string& src_label,
+                                          const std::string& edge_label,
+                                          const std::string& dst_label,
+                                          AdjListType adj_list_type) {
+  if (adj_list_type != AdjListType::ordered_by_source &&
+      adj_list_type != AdjListType::ordered_by_dest) {
+    return Status::Invalid("The adj list must be ordered, but got " +
+                           std::string(AdjListTypeToString(adj_list_type)));
+  }
+  bool by_source = adj_list_type == AdjListType::ordered_by_source;
+  GAR_ASSIGN_OR_RAISE(auto edge_info,
+                      graph_info.GetEdgeInfo(src_label, edge_label, dst_label));
+  GAR_ASSIGN_OR_RAISE(auto file_type, edge_info.GetFileType(adj_list_type));
+  std::string base_dir;
+  GAR_ASSIGN_OR_RAISE(
+      auto fs, FileSystemFromUriOrPath(graph_info.GetPrefix(), &base_dir));
+  GAR_ASSIGN_OR_RAISE(
+      IdType vertex_num,
+      ReadVertexNum(graph_info, fs, base_dir,
+                    by_source ? src_label : dst_label));
+  IdType vertex_chunk_size =
+      by_source ? edge_info.GetSrcChunkSize() : edge_info.GetDstChunkSize();
+  IdType vertex_chunk_num =
+      (vertex_num + vertex_chunk_size - 1) / vertex_chunk_size;
+  GAR_ASSIGN_OR_RAISE(
+      auto edge_chunk_nums,
+      utils::GetEdgeChunkNums(edge_info, graph_info.GetPrefix(),
+                              adj_list_type));
+  edge_chunk_nums.resize(
+      std::max<size_t>(edge_chunk_nums.size(), vertex_chunk_num), 0);
+  return OrderedAdjList{edge_info,         adj_list_type,    file_type,
+                        fs,                base_dir,         vertex_num,
+                        vertex_chunk_size, vertex_chunk_num,
+                        std::move(edge_chunk_nums)};
+}
+
+// read the offsets of each vertex chunk in parallel, the vertex chunks without
+// edges may have no offset chunk and get no offsets
+Result<std::vector<std::vector<IdType>>> ReadOffsetChunks(
+    const OrderedAdjList& adj_list, int num_threads) {
+  std::vector<std::vector<IdType>> chunk_offsets(adj_list.vertex_chunk_num);
+  GAR_RETURN_NOT_OK(util::ParallelFor(
+      adj_list.vertex_chunk_num, num_threads, [&](IdType i) -> Status {
+        GAR_ASSIGN_OR_RAISE(auto chunk_file_path,
+                            adj_list.edge_info.GetAdjListOffsetFilePath(
+                                i, adj_list.adj_list_type));
+        auto maybe_table = adj_list.fs->ReadFileToTable(
+            adj_list.base_dir + chunk_file_path, adj_list.file_type);
+        if (!maybe_table.status().ok()) {
+          return adj_list.edge_chunk_nums[i] == 0 ? Status::OK()
+                                                  : maybe_table.status();
+        }
+        auto table = maybe_table.value();
+        auto& offsets = chunk_offsets[i];
+        offsets.reserve(table->num_rows());
+        for (const auto& array : table->column(0)->chunks()) {
+          if (array->type()->id() != arrow::Type::INT64) {
+            return Status::TypeError("The offset column must be int64.");
+          }
+          auto int64_array = std::static_pointer_cast<arrow::Int64Array>(array);
+          offsets.insert(offsets.end(), int64_array->raw_values(),
+                         int64_array->raw_values() + int64_array->length());
+        }
+        return Status::OK();
+      }));
+  return chunk_offsets;
+}
+
+// get the degrees of the vertices from the offset chunks
+Result<std::shared_ptr<arrow::Array>> GetDegrees(
+    const GraphInfo& graph_info, const std::string& src_label,
+    const std::string& edge_label, const std::string& dst_label,
+    AdjListType adj_list_type, int num_threads) {
+  GAR_ASSIGN_OR_RAISE(auto adj_list,
+                      OpenOrderedAdjList(graph_info, src_label, edge_label,
+                                         dst_label, adj_list_type));
+  GAR_ASSIGN_OR_RAISE(auto chunk_offsets,
+                      ReadOffsetChunks(adj_list, num_threads));
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      std::shared_ptr<arrow::Buffer> buffer,
+      arrow::AllocateBuffer(adj_list.vertex_num * sizeof(int64_t)));
+  auto degrees = reinterpret_cast<int64_t*>(buffer->mutable_data());
+  GAR_RETURN_NOT_OK(util::ParallelFor(
+      adj_list.vertex_chunk_num, num_threads, [&](IdType i) -> Status {
+        IdType first = i * adj_list.vertex_chunk_size;
+        IdType chunk_vertex_num =
+            std::min(adj_list.vertex_chunk_size, adj_list.vertex_num - first);
+        const auto& offsets = chunk_offsets[i];
+        for (IdType j = 0; j < chunk_vertex_num; ++j) {
+          degrees[first + j] = j + 1 < static_cast<IdType>(offsets.size())
+                                   ? offsets[j + 1] - offsets[j]
+                                   : 0;
+        }
+        return Status::OK();
+      }));
+  return std::make_shared<arrow::Int64Array>(adj_list.vertex_num,
+                                             std::move(buffer));
+}
+}  // namespace
+
+CSR::Iterator::Iterator(const CSR* csr, IdType offset) noexcept : csr_(csr) {
+  moveTo(offset);
+}
+
+void CSR::Iterator::moveTo(IdType offset) noexcept {
+  offset_ = offset;
+  const int64_t* offsets = csr_->offsets_;
+  vertex_ = std::upper_bound(offsets, offsets + csr_->vertex_num_ + 1, offset) -
+            offsets - 1;
+  vertex_ = std::min(vertex_, csr_->vertex_num_);
+}
+
+bool CSR::Iterator::first(const Iterator& from, IdType id,
+                          bool aligned) noexcept {
+  if (aligned) {
+    if (id < 0 || id >= csr_->vertex_num_) {
+      return false;
+    }
+    IdType begin = std::max(csr_->offsets_[id], from.offset_);
+    if (begin >= csr_->offsets_[id + 1]) {
+      return false;
+    }
+    offset_ = begin;
+    vertex_ = id;
+    return true;
+  }
+  for (IdType i = from.offset_; i < csr_->edge_num_; ++i) {
+    if (csr_->GetNeighbor(i) == id) {
+      moveTo(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CSR::Iterator::next(bool aligned) noexcept {
+  if (is_end()) {
+    return false;
+  }
+  if (aligned) {
+    IdType id = vertex_;
+    this->operator++();
+    return !is_end() && vertex_ == id;
+  }
+  IdType id = csr_->GetNeighbor(offset_);
+  for (IdType i = offset_ + 1; i < csr_->edge_num_; ++i) {
+    if (csr_->GetNeighbor(i) == id) {
+      moveTo(i);
+      return true;
+    }
+  }
+  moveTo(csr_->edge_num_);
+  return false;
+}
+
+CSR::CSR(std::shared_ptr<arrow::Buffer> data, IdType vertex_num,
+         IdType edge_num, bool compact, AdjListType adj_list_type) noexcept
+    : data_(std::move(data)),
+      vertex_num_(vertex_num),
+      edge_num_(edge_num),
+      compact_(compact),
+      by_source_(adj_list_type == AdjListType::ordered_by_source) {
+  offsets_ = reinterpret_cast<const int64_t*>(data_->data());
+  const uint8_t* neighbors =
+      data_->data() + (vertex_num_ + 1) * sizeof(int64_t);
+  neighbors32_ = reinterpret_cast<const int32_t*>(neighbors);
+  neighbors64_ = reinterpret_cast<const int64_t*>(neighbors);
+}
+
+Result<std::shared_ptr<arrow::Array>> GetOutDegrees(
+    const GraphInfo& graph_info, const std::string& src_label,
+    const std::string& edge_label, const std::string& dst_label,
+    int num_threads) noexcept {
+  return GetDegrees(graph_info, src_label, edge_label, dst_label,
+                    AdjListType::ordered_by_source, num_threads);
+}
+
+Result<std::shared_ptr<arrow::Array>> GetInDegrees(
+    const GraphInfo& graph_info, const std::string& src_label,
+    const std::string& edge_label, const std::string& dst_label,
+    int num_threads) noexcept {
+  return GetDegrees(graph_info, src_label, edge_label, dst_label,
+                    AdjListType::ordered_by_dest, num_threads);
+}
+
+Result<std::shared_ptr<CSR>> LoadCSR(const GraphInfo& graph_info,
+                                     const std::string& src_label,
+                                     const std::string& edge_label,
+                                     const std::string& dst_label,
+                                     AdjListType adj_list_type,
+                                     const CSROptions& options) noexcept {
+  GAR_ASSIGN_OR_RAISE(auto adj_list,
+                      OpenOrderedAdjList(graph_info, src_label, edge_label,
+                                         dst_label, adj_list_type));
+  bool by_source = adj_list_type == AdjListType::ordered_by_source;
+  const auto& edge_info = adj_list.edge_info;
+  const auto& fs = adj_list.fs;
+  const auto& base_dir = adj_list.base_dir;
+  const auto& edge_chunk_nums = adj_list.edge_chunk_nums;
+  FileType file_type = adj_list.file_type;
+  IdType vertex_num = adj_list.vertex_num;
+  IdType vertex_chunk_size = adj_list.vertex_chunk_size;
+  IdType vertex_chunk_num = adj_list.vertex_chunk_num;
+  GAR_ASSIGN_OR_RAISE(
+      IdType neighbor_num,
+      ReadVertexNum(graph_info, fs, base_dir,
+                    by_source ? dst_label : src_label));
+  GAR_ASSIGN_OR_RAISE(auto chunk_offsets,
+                      ReadOffsetChunks(adj_list, options.num_threads));
+  // the first edge of each vertex chunk
+  std::vector<IdType> edge_offsets(vertex_chunk_num + 1, 0);
+  for (IdType i = 0; i < vertex_chunk_num; ++i) {
+    IdType edge_num =
+        chunk_offsets[i].empty() ? 0 : chunk_offsets[i].back();
+    edge_offsets[i + 1] = edge_offsets[i] + edge_num;
+  }
+  IdType edge_num = edge_offsets.back();
+
+  bool compact =
+      options.compact_ids &&
+      neighbor_num <= static_cast<IdType>(std::numeric_limits<int32_t>::max());
+  int64_t id_width = compact ? sizeof(int32_t) : sizeof(int64_t);
+  int64_t neighbors_position = (vertex_num + 1) * sizeof(int64_t);
+  GAR_ASSIGN_OR_RAISE(
+      auto storage,
+      CSRStorage::Make(neighbors_position + edge_num * id_width,
+                       options.mmap_path));
+
+  // the offsets, shifted by the first edge of their vertex chunks
+  for (IdType i = 0; i < vertex_chunk_num; ++i) {
+    IdType chunk_vertex_num =
+        std::min(vertex_chunk_size, vertex_num - i * vertex_chunk_size);
+    std::vector<int64_t> offsets(chunk_vertex_num);
+    const auto& local = chunk_offsets[i];
+    for (IdType j = 0; j < chunk_vertex_num; ++j) {
+      IdType offset = j < static_cast<IdType>(local.size())
+                          ? local[j]
+                          : (local.empty() ? 0 : local.back());
+      offsets[j] = edge_offsets[i] + offset;
+    }
+    GAR_RETURN_NOT_OK(storage->Write(i * vertex_chunk_size * sizeof(int64_t),
+                                     offsets.data(),
+                                     chunk_vertex_num * sizeof(int64_t)));
+    std::vector<IdType>().swap(chunk_offsets[i]);
+  }
+  GAR_RETURN_NOT_OK(storage->Write(vertex_num * sizeof(int64_t), &edge_num,
+                                   sizeof(int64_t)));
+
+  // the neighbors, decoding only the neighbor column of the adj list chunks
+  std::vector<std::pair<IdType, IdType>> chunks;
+  for (IdType i = 0; i < vertex_chunk_num; ++i) {
+    for (IdType j = 0; j < edge_chunk_nums[i]; ++j) {
+      chunks.emplace_back(i, j);
+    }
+  }
+  std::vector<std::string> columns = {
+      by_source ? GeneralParams::kDstIndexCol : GeneralParams::kSrcIndexCol};
+  IdType edge_chunk_size = edge_info.GetChunkSize();
+  GAR_RETURN_NOT_OK(util::ParallelFor(
+      static_cast<IdType>(chunks.size()), options.num_threads,
+      [&](IdType k) -> Status {
+        IdType vertex_chunk_index = chunks[k].first;
+        IdType chunk_index = chunks[k].second;
+        GAR_ASSIGN_OR_RAISE(auto chunk_file_path,
+                            edge_info.GetAdjListFilePath(
+                                vertex_chunk_index, chunk_index,
+                                adj_list_type));
+        GAR_ASSIGN_OR_RAISE(
+            auto table,
+            fs->ReadFileToTable(base_dir + chunk_file_path, file_type,
+                                columns));
+        IdType position = edge_offsets[vertex_chunk_index] +
+                          chunk_index * edge_chunk_size;
+        if (position + table->num_rows() >
+            edge_offsets[vertex_chunk_index + 1]) {
+          return Status::Invalid(
+              "The adj list chunk " + chunk_file_path +
+              " does not match the offsets of its vertex chunk.");
+        }
+        std::vector<int32_t> compact_ids;
+        for (const auto& array : table->column(0)->chunks()) {
+          if (array->type()->id() != arrow::Type::INT64) {
+            return Status::TypeError("The adj list column must be int64.");
+          }
+          auto ids = std::static_pointer_cast<arrow::Int64Array>(array);
+          const void* data = ids->raw_values();
+          if (compact) {
+            compact_ids.assign(ids->raw_values(),
+                               ids->raw_values() + ids->length());
+            data = compact_ids.data();
+          }
+          GAR_RETURN_NOT_OK(storage->Write(
+              neighbors_position + position * id_width, data,
+              ids->length() * id_width));
+          position += ids->length();
+        }
+        return Status::OK();
+      }));
+
+  GAR_ASSIGN_OR_RAISE(auto data, storage->Finish());
+  return std::make_shared<CSR>(std::move(data), vertex_num, edge_num, compact,
+                               adj_list_type);
+}
+
+}  // namespace GAR_NAMESPACE_INTERNAL
@@ -15,20 +15,95 @@ limitations under the License.
 
 #include "arrow/adapters/orc/adapter.h"
 #include "arrow/api.h"
+#include "arrow/compute/api.h"
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 12000000
+#include "arrow/compute/expression.h"
+#else
+#include "arrow/compute/exec/expression.h"
+#endif
 #include "arrow/csv/api.h"
 #include "arrow/filesystem/api.h"
 #include "arrow/io/api.h"
 #include "arrow/ipc/writer.h"
+#include "arrow/util/compression.h"
 #include "arrow/util/uri.h"
 #include "parquet/arrow/reader.h"
 #include "parquet/arrow/writer.h"
+#include "parquet/metadata.h"
+#include "parquet/statistics.h"
 
+#include "gar/utils/chunk_cache.h"
 #include "gar/utils/filesystem.h"
 
 namespace GAR_NAMESPACE_INTERNAL {
 
+namespace {
+// get the indices of the columns in the parquet file
+Result<std::vector<int>> GetParquetColumnIndices(
+    parquet::arrow::FileReader* reader, const std::vector<std::string>& columns,
+    const std::string& path) {
+  auto schema = reader->parquet_reader()->metadata()->schema();
+  std::vector<int> column_indices;
+  for (const auto& column : columns) {
+    int index = schema->ColumnIndex(column);
+    if (index < 0) {
+      return Status::KeyError("The column " + column + " is not found in " +
+                              path);
+    }
+    column_indices.push_back(index);
+  }
+  return column_indices;
+}
+
+// get the predicate that is true for all the rows of a parquet row group from
+// the min/max statistics of the columns referenced by the filter
+Result<arrow::compute::Expression> GetRowGroupGuarantee(
+    const parquet::RowGroupMetaData& row_group,
+    const parquet::SchemaDescriptor& parquet_schema,
+    const arrow::Schema& schema, const std::vector<arrow::FieldRef>& refs) {
+  namespace cp = arrow::compute;
+  cp::Expression guarantee = cp::literal(true);
+  for (const auto& ref : refs) {
+    const std::string* name = ref.name();
+    if (name == nullptr) {
+      continue;
+    }
+    int column_index = parquet_schema.ColumnIndex(*name);
+    auto field = schema.GetFieldByName(*name);
+    if (column_index < 0 || field == nullptr) {
+      continue;  // not a column of the file
+    }
+    auto statistics = row_group.ColumnChunk(column_index)->statistics();
+    if (statistics == nullptr || !statistics->HasMinMax()) {
+      continue;
+    }
+    std::shared_ptr<arrow::Scalar> min, max;
+    if (!parquet::arrow::StatisticsAsScalars(*statistics, &min, &max).ok()) {
+      continue;
+    }
+    auto maybe_min = cp::Cast(min, field->type());
+    auto maybe_max = cp::Cast(max, field->type());
+    if (!maybe_min.ok() || !maybe_max.ok()) {
+      continue;
+    }
+    auto field_expr = cp::field_ref(*name);
+    auto range =
+        cp::and_(cp::greater_equal(field_expr, cp::literal(*maybe_min)),
+                 cp::less_equal(field_expr, cp::literal(*maybe_max)));
+    if (!statistics->HasNullCount() || statistics->null_count() > 0) {
+      range = cp::or_(range, cp::is_null(field_expr));
+    }
+    guarantee = cp::and_(guarantee, range);
+  }
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto bound_guarantee,
+                                       guarantee.Bind(schema));
+  return bound_guarantee;
+}
+}  // namespace
+
 Result<std::shared_ptr<arrow::Table>> FileSystem::ReadFileToTable(
-    const std::string& path, FileType file_type) const noexcept {
+    const std::string& path, FileType file_type,
+    const std::vector<std::string>& columns) const noexcept {
   arrow::MemoryPool* pool = arrow::default_memory_pool();
   std::shared_ptr<arrow::Table> table;
   switch (file_type) {
@@ -38,6 +113,7 @@ Result<std::shared_ptr<arrow::Table>> FileSystem::ReadFileToTable(
     auto read_options = arrow::csv::ReadOptions::Defaults();
     auto parse_options = arrow::csv::ParseOptions::Defaults();
     auto convert_options = arrow::csv::ConvertOptions::Defaults();
+    convert_options.include_columns = columns;
     GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
         auto reader, arrow::csv::TableReader::Make(
                          arrow::io::IOContext(pool), is, read_options,
@@ -50,7 +126,14 @@ Result<std::shared_ptr<arrow::Table>> FileSystem::ReadFileToTable(
                                          arrow_fs_->OpenInputFile(path));
     std::unique_ptr<parquet::arrow::FileReader> reader;
     RETURN_NOT_ARROW_OK(parquet::arrow::OpenFile(input, pool, &reader));
-    RETURN_NOT_ARROW_OK(reader->ReadTable(&table));
+    if (columns.empty()) {
+      RETURN_NOT_ARROW_OK(reader->ReadTable(&table));
+    } else {
+      GAR_ASSIGN_OR_RAISE(
+          auto column_indices,
+          GetParquetColumnIndices(reader.get(), columns, path));
+      RETURN_NOT_ARROW_OK(reader->ReadTable(column_indices, &table));
+    }
     break;
   }
   case FileType::ORC: {
@@ -58,7 +141,11 @@ Result<std::shared_ptr<arrow::Table>> FileSystem::ReadFileToTable(
                                          arrow_fs_->OpenInputFile(path));
     GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
         auto reader, arrow::adapters::orc::ORCFileReader::Open(input, pool));
-    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(table, reader->Read());
+    if (columns.empty()) {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(table, reader->Read());
+    } else {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(table, reader->Read(columns));
+    }
     break;
   }
   default:
@@ -67,6 +154,165 @@ Result<std::shared_ptr<arrow::Table>> FileSystem::ReadFileToTable(
   return table;
 }
 
+Result<std::pair<std::shared_ptr<arrow::Table>, int64_t>>
+FileSystem::ReadFileToTableFromRow(
+    const std::string& path, FileType file_type, int64_t row,
+    const std::vector<std::string>& columns) const noexcept {
+  if (file_type != FileType::PARQUET || row <= 0) {
+    GAR_ASSIGN_OR_RAISE(auto table, ReadFileToTable(path, file_type, columns));
+    return std::make_pair(table, static_cast<int64_t>(0));
+  }
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto input,
+                                       arrow_fs_->OpenInputFile(path));
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  RETURN_NOT_ARROW_OK(parquet::arrow::OpenFile(input, pool, &reader));
+  auto metadata = reader->parquet_reader()->metadata();
+  // find the row group that contains the row
+  int num_row_groups = metadata->num_row_groups();
+  int first_row_group = 0;
+  int64_t first_row = 0;
+  while (first_row_group < num_row_groups &&
+         first_row + metadata->RowGroup(first_row_group)->num_rows() <= row) {
+    first_row += metadata->RowGroup(first_row_group)->num_rows();
+    ++first_row_group;
+  }
+  if (first_row_group == num_row_groups) {
+    // the row is out of the file, read the file as a whole
+    first_row_group = 0;
+    first_row = 0;
+  }
+  std::vector<int> row_groups;
+  for (int i = first_row_group; i < num_row_groups; ++i) {
+    row_groups.push_back(i);
+  }
+  std::shared_ptr<arrow::Table> table;
+  if (columns.empty()) {
+    RETURN_NOT_ARROW_OK(reader->ReadRowGroups(row_groups, &table));
+  } else {
+    GAR_ASSIGN_OR_RAISE(auto column_indices,
+                        GetParquetColumnIndices(reader.get(), columns, path));
+    RETURN_NOT_ARROW_OK(
+        reader->ReadRowGroups(row_groups, column_indices, &table));
+  }
+  return std::make_pair(table, first_row);
+}
+
+Result<std::vector<int64_t>> FileSystem::GetRowGroupRowNums(
+    const std::string& path, FileType file_type) const noexcept {
+  if (file_type != FileType::PARQUET) {
+    GAR_ASSIGN_OR_RAISE(auto row_num, GetRowNumOfFile(path, file_type));
+    return std::vector<int64_t>{row_num};
+  }
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto input,
+                                       arrow_fs_->OpenInputFile(path));
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  RETURN_NOT_ARROW_OK(parquet::arrow::OpenFile(input, pool, &reader));
+  auto metadata = reader->parquet_reader()->metadata();
+  std::vector<int64_t> row_nums(metadata->num_row_groups());
+  for (int i = 0; i < metadata->num_row_groups(); ++i) {
+    row_nums[i] = metadata->RowGroup(i)->num_rows();
+  }
+  return row_nums;
+}
+
+Result<std::vector<std::shared_ptr<arrow::Table>>>
+FileSystem::ReadFileRowGroups(const std::string& path, FileType file_type,
+                              const std::vector<int>& row_groups,
+                              const std::vector<std::string>& columns) const
+    noexcept {
+  if (file_type != FileType::PARQUET) {
+    return Status::Invalid("Only the Parquet files are read by row groups.");
+  }
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto input,
+                                       arrow_fs_->OpenInputFile(path));
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  RETURN_NOT_ARROW_OK(parquet::arrow::OpenFile(input, pool, &reader));
+  std::vector<int> column_indices;
+  if (!columns.empty()) {
+    GAR_ASSIGN_OR_RAISE(column_indices,
+                        GetParquetColumnIndices(reader.get(), columns, path));
+  }
+  std::vector<std::shared_ptr<arrow::Table>> tables(row_groups.size());
+  for (size_t i = 0; i < row_groups.size(); ++i) {
+    if (columns.empty()) {
+      RETURN_NOT_ARROW_OK(reader->ReadRowGroup(row_groups[i], &tables[i]));
+    } else {
+      RETURN_NOT_ARROW_OK(
+          reader->ReadRowGroup(row_groups[i], column_indices, &tables[i]));
+    }
+  }
+  return tables;
+}
+
+Result<std::vector<std::pair<int64_t, std::shared_ptr<arrow::Table>>>>
+FileSystem::ReadFileToTablesWithFilter(
+    const std::string& path, FileType file_type,
+    const arrow::compute::Expression& filter,
+    const std::vector<std::string>& columns) const noexcept {
+  std::vector<std::pair<int64_t, std::shared_ptr<arrow::Table>>> tables;
+  if (file_type != FileType::PARQUET) {
+    GAR_ASSIGN_OR_RAISE(auto table, ReadFileToTable(path, file_type, columns));
+    tables.emplace_back(0, table);
+    return tables;
+  }
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto input,
+                                       arrow_fs_->OpenInputFile(path));
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  RETURN_NOT_ARROW_OK(parquet::arrow::OpenFile(input, pool, &reader));
+  std::shared_ptr<arrow::Schema> schema;
+  RETURN_NOT_ARROW_OK(reader->GetSchema(&schema));
+  std::vector<int> column_indices;
+  if (!columns.empty()) {
+    GAR_ASSIGN_OR_RAISE(column_indices,
+                        GetParquetColumnIndices(reader.get(), columns, path));
+  }
+  auto metadata = reader->parquet_reader()->metadata();
+  auto refs = arrow::compute::FieldsInExpression(filter);
+
+  // read the consecutive row groups that may contain matched rows together
+  std::vector<int> row_groups;
+  int64_t first_row = 0, row = 0;
+  auto read_row_groups = [&]() -> Status {
+    if (row_groups.empty()) {
+      return Status::OK();
+    }
+    std::shared_ptr<arrow::Table> table;
+    if (columns.empty()) {
+      RETURN_NOT_ARROW_OK(reader->ReadRowGroups(row_groups, &table));
+    } else {
+      RETURN_NOT_ARROW_OK(
+          reader->ReadRowGroups(row_groups, column_indices, &table));
+    }
+    tables.emplace_back(first_row, table);
+    row_groups.clear();
+    return Status::OK();
+  };
+  for (int i = 0; i < metadata->num_row_groups(); ++i) {
+    auto row_group = metadata->RowGroup(i);
+    GAR_ASSIGN_OR_RAISE(auto guarantee,
+                        GetRowGroupGuarantee(*row_group, *metadata->schema(),
+                                             *schema, refs));
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto simplified,
+        arrow::compute::SimplifyWithGuarantee(filter, guarantee));
+    if (simplified.IsSatisfiable()) {
+      if (row_groups.empty()) {
+        first_row = row;
+      }
+      row_groups.push_back(i);
+    } else {
+      GAR_RETURN_NOT_OK(read_row_groups());
+    }
+    row += row_group->num_rows();
+  }
+  GAR_RETURN_NOT_OK(read_row_groups());
+  return tables;
+}
+
 template <typename T>
 Result<T> FileSystem::ReadFileToValue(const std::string& path) const noexcept {
   T ret;
@@ -97,6 +343,7 @@ Status FileSystem::WriteValueToFile(const T& value,
                                        arrow_fs_->OpenOutputStream(path));
   RETURN_NOT_ARROW_OK(ofstream->Write(&value, sizeof(T)));
   RETURN_NOT_ARROW_OK(ofstream->Close());
+  ChunkCache::Global().Invalidate(path);
   return Status::OK();
 }
 
@@ -109,12 +356,25 @@ Status FileSystem::WriteValueToFile(const std::string& value,
                                        arrow_fs_->OpenOutputStream(path));
   RETURN_NOT_ARROW_OK(ofstream->Write(value.c_str(), value.size()));
   RETURN_NOT_ARROW_OK(ofstream->Close());
+  ChunkCache::Global().Invalidate(path);
   return Status::OK();
 }
 
 Status FileSystem::WriteTableToFile(const std::shared_ptr<arrow::Table>& table,
-                                    FileType file_type,
-                                    const std::string& path) const noexcept {
+                                    FileType file_type, const std::string& path,
+                                    int64_t row_group_size,
+                                    const WriterOptions& options) const
+    noexcept {
+  GAR_RETURN_NOT_OK(options.Validate());
+  auto compression = arrow::Compression::type::ZSTD;
+  if (!options.compression.empty()) {
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        compression,
+        arrow::util::Codec::GetCompressionType(options.compression));
+  }
+  if (options.row_group_size) {
+    row_group_size = *options.row_group_size;
+  }
   RETURN_NOT_ARROW_OK(
       arrow_fs_->CreateDir(path.substr(0, path.find_last_of("/"))));
   GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto output_stream,
@@ -133,15 +393,49 @@ Status FileSystem::WriteTableToFile(const std::shared_ptr<arrow::Table>& table,
   }
   case FileType::PARQUET: {
     parquet::WriterProperties::Builder builder;
-    builder.compression(arrow::Compression::type::ZSTD);  // enable compression
+    builder.compression(compression);  // enable compression
+    if (options.compression_level) {
+      builder.compression_level(*options.compression_level);
+    }
+    if (options.dictionary) {
+      if (*options.dictionary) {
+        builder.enable_dictionary();
+      } else {
+        builder.disable_dictionary();
+      }
+    }
+    if (options.page_size) {
+      builder.data_pagesize(*options.page_size);
+    }
+    if (options.statistics) {
+      if (*options.statistics) {
+        builder.enable_statistics();
+      } else {
+        builder.disable_statistics();
+      }
+    }
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 12000000
+    if (options.page_index.value_or(true)) {
+      builder.enable_write_page_index();
+    } else {
+      builder.disable_write_page_index();
+    }
+#endif
     RETURN_NOT_ARROW_OK(parquet::arrow::WriteTable(
-        *table, arrow::default_memory_pool(), output_stream, 64 * 1024 * 1024,
+        *table, arrow::default_memory_pool(), output_stream, row_group_size,
         builder.build(), parquet::default_arrow_writer_properties()));
     break;
   }
   case FileType::ORC: {
     auto writer_options = arrow::adapters::orc::WriteOptions();
-    writer_options.compression = arrow::Compression::type::ZSTD;
+    writer_options.compression = compression;
+    if (options.row_group_size) {
+      writer_options.row_index_stride = *options.row_group_size;
+    }
+    if (options.dictionary && !*options.dictionary) {
+      // no column is below the threshold of the ratio of distinct keys
+      writer_options.dictionary_key_size_threshold = 0;
+    }
     GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
         auto writer, arrow::adapters::orc::ORCFileWriter::Open(
                          output_stream.get(), writer_options));
@@ -155,6 +449,7 @@ Status FileSystem::WriteTableToFile(const std::shared_ptr<arrow::Table>& table,
         " for writing.";
     return Status::Invalid(message);
   }
+  ChunkCache::Global().Invalidate(path);
   return Status::OK();
 }
 
@@ -163,6 +458,16 @@ Status FileSystem::CopyFile(const std::string& src_path,
   RETURN_NOT_ARROW_OK(
       arrow_fs_->CreateDir(dst_path.substr(0, dst_path.find_last_of("/"))));
   RETURN_NOT_ARROW_OK(arrow_fs_->CopyFile(src_path, dst_path));
+  ChunkCache::Global().Invalidate(dst_path);
+  return Status::OK();
+}
+
+Status FileSystem::DeleteFile(const std::string& path) const noexcept {
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto info, arrow_fs_->GetFileInfo(path));
+  if (info.type() == arrow::fs::FileType::File) {
+    RETURN_NOT_ARROW_OK(arrow_fs_->DeleteFile(path));
+  }
+  ChunkCache::Global().Invalidate(path);
   return Status::OK();
 }
 
@@ -178,6 +483,48 @@ Result<size_t> FileSystem::GetFileNumOfDir(const std::string& dir_path,
   return file_infos.size();
 }
 
+Result<bool> FileSystem::FileExists(const std::string& path) const noexcept {
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto file_info,
+                                       arrow_fs_->GetFileInfo(path));
+  return file_info.IsFile();
+}
+
+Result<int64_t> FileSystem::GetFileSize(const std::string& path) const
+    noexcept {
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto file_info,
+                                       arrow_fs_->GetFileInfo(path));
+  if (!file_info.IsFile()) {
+    return Status::IOError("The file " + path + " does not exist.");
+  }
+  return file_info.size();
+}
+
+Result<int64_t> FileSystem::GetRowNumOfFile(const std::string& path,
+                                            FileType file_type) const
+    noexcept {
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  switch (file_type) {
+  case FileType::PARQUET: {
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto input,
+                                         arrow_fs_->OpenInputFile(path));
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    RETURN_NOT_ARROW_OK(parquet::arrow::OpenFile(input, pool, &reader));
+    return reader->parquet_reader()->metadata()->num_rows();
+  }
+  case FileType::ORC: {
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto input,
+                                         arrow_fs_->OpenInputFile(path));
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto reader, arrow::adapters::orc::ORCFileReader::Open(input, pool));
+    return reader->NumberOfRows();
+  }
+  default: {
+    GAR_ASSIGN_OR_RAISE(auto table, ReadFileToTable(path, file_type));
+    return table->num_rows();
+  }
+  }
+}
+
 Result<std::shared_ptr<FileSystem>> FileSystemFromUriOrPath(
     const std::string& uri, std::string* out_path) {
   GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
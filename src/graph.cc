@@ -13,91 +13,545 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "arrow/api.h"
+#include "arrow/compute/api.h"
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 12000000
+#include "arrow/compute/expression.h"
+#else
+#include "arrow/compute/exec/expression.h"
+#endif
+
 #include "gar/graph.h"
-#include "gar/utils/convert_to_arrow_type.h"
+#include "gar/utils/general_params.h"
 
 namespace GAR_NAMESPACE_INTERNAL {
 
-template <Type type>
-Status CastToAny(std::shared_ptr<arrow::Array> array,
-                 std::any& any) {  // NOLINT
-  using ArrayType = typename ConvertToArrowType<type>::ArrayType;
-  auto column = std::dynamic_pointer_cast<ArrayType>(array);
-  any = column->GetView(0);
-  return Status::OK();
+namespace {
+// evaluate the filter on the rows of the table, return the indices of the
+// matched rows
+Result<std::vector<int64_t>> GetMatchedRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const arrow::compute::Expression& filter, const arrow::Schema& schema) {
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  if (table->num_columns() == 0) {
+    batches.push_back(arrow::RecordBatch::Make(
+        arrow::schema({}), table->num_rows(), arrow::ArrayVector{}));
+  } else {
+    arrow::TableBatchReader reader(*table);
+    std::shared_ptr<arrow::RecordBatch> batch;
+    RETURN_NOT_ARROW_OK(reader.ReadNext(&batch));
+    while (batch != nullptr) {
+      batches.push_back(batch);
+      RETURN_NOT_ARROW_OK(reader.ReadNext(&batch));
+    }
+  }
+  std::vector<int64_t> rows;
+  int64_t offset = 0;
+  for (const auto& batch : batches) {
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto exec_batch, arrow::compute::MakeExecBatch(schema, batch));
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        auto mask, arrow::compute::ExecuteScalarExpression(filter, exec_batch));
+    if (mask.is_scalar()) {
+      auto scalar =
+          std::static_pointer_cast<arrow::BooleanScalar>(mask.scalar());
+      if (scalar->is_valid && scalar->value) {
+        for (int64_t i = 0; i < batch->num_rows(); ++i) {
+          rows.push_back(offset + i);
+        }
+      }
+    } else {
+      auto array =
+          std::static_pointer_cast<arrow::BooleanArray>(mask.make_array());
+      for (int64_t i = 0; i < array->length(); ++i) {
+        if (array->IsValid(i) && array->Value(i)) {
+          rows.push_back(offset + i);
+        }
+      }
+    }
+    offset += batch->num_rows();
+  }
+  return rows;
 }
 
-template <>
-Status CastToAny<Type::STRING>(std::shared_ptr<arrow::Array> array,
-                               std::any& any) {  // NOLINT
-  using ArrayType = typename ConvertToArrowType<Type::STRING>::ArrayType;
-  auto column = std::dynamic_pointer_cast<ArrayType>(array);
-  any = column->GetString(0);
-  return Status::OK();
+// take the rows of the column and cast them to the type
+Result<std::shared_ptr<arrow::ChunkedArray>> TakeColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::vector<int64_t>& rows,
+    const std::shared_ptr<arrow::DataType>& type) {
+  arrow::Int64Builder builder;
+  RETURN_NOT_ARROW_OK(builder.AppendValues(rows));
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto indices, builder.Finish());
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      auto taken, arrow::compute::Take(column, indices));
+  if (!taken.type()->Equals(type)) {
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(taken,
+                                         arrow::compute::Cast(taken, type));
+  }
+  return taken.chunked_array();
 }
 
-Status TryToCastToAny(const DataType& type, std::shared_ptr<arrow::Array> array,
-                      std::any& any) {  // NOLINT
-  switch (type.id()) {
-  case Type::BOOL:
-    return CastToAny<Type::BOOL>(array, any);
-  case Type::INT32:
-    return CastToAny<Type::INT32>(array, any);
-  case Type::INT64:
-    return CastToAny<Type::INT64>(array, any);
-  case Type::FLOAT:
-    return CastToAny<Type::FLOAT>(array, any);
-  case Type::DOUBLE:
-    return CastToAny<Type::DOUBLE>(array, any);
-  case Type::STRING:
-    return CastToAny<Type::STRING>(array, any);
-  default:
-    return Status::TypeError();
-  }
-  return Status::TypeError();
+// a scan of the chunks of the property groups that evaluates a filter on the
+// properties and outputs the matched rows, shared by the vertex and the edge
+// filters; the callers give the paths of the chunks and the id columns
+class FilterScan {
+ public:
+  // bind the filter to the schema of all the properties of the groups, and
+  // collect the columns to read, the groups referred by the filter first
+  static Result<FilterScan> Make(
+      const std::vector<PropertyGroup>& property_groups,
+      const arrow::compute::Expression& filter,
+      const std::vector<std::string>& property_names,
+      arrow::FieldVector id_fields, std::shared_ptr<FileSystem> fs,
+      std::string base_dir) {
+    FilterScan scan;
+    arrow::FieldVector fields;
+    for (const auto& pg : property_groups) {
+      for (const auto& property : pg.GetProperties()) {
+        fields.push_back(arrow::field(
+            property.name, DataType::DataTypeToArrowDataType(property.type)));
+      }
+    }
+    scan.schema_ = arrow::schema(fields);
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(scan.filter_,
+                                         filter.Bind(*scan.schema_));
+    if (scan.filter_.type()->id() != arrow::Type::BOOL) {
+      return Status::TypeError("The filter must be a boolean expression.");
+    }
+    for (const auto& ref : arrow::compute::FieldsInExpression(scan.filter_)) {
+      if (ref.name() == nullptr) {
+        return Status::Invalid("The filter must refer to properties by name.");
+      }
+      GAR_RETURN_NOT_OK(scan.addColumn(property_groups, *ref.name()));
+    }
+    scan.filter_group_num_ = scan.groups_.size();
+    scan.id_num_ = id_fields.size();
+    for (const auto& name : property_names) {
+      GAR_RETURN_NOT_OK(scan.addColumn(property_groups, name));
+      id_fields.push_back(scan.schema_->GetFieldByName(name));
+    }
+    scan.out_schema_ = arrow::schema(id_fields);
+    scan.property_names_ = property_names;
+    scan.fs_ = std::move(fs);
+    scan.base_dir_ = std::move(base_dir);
+    return scan;
+  }
+
+  // scan a chunk: get_path gives the path of the chunk of a group, count_rows
+  // the number of rows of the chunk if the filter refers to no property, and
+  // take_ids the id columns of the matched rows of the chunk
+  Status ScanChunk(
+      const std::function<Result<std::string>(const PropertyGroup&)>&
+          get_path,
+      const std::function<Result<int64_t>()>& count_rows,
+      const std::function<Result<arrow::ChunkedArrayVector>(
+          const std::vector<int64_t>&)>& take_ids) {
+    // read the chunk of the group with the columns of the group
+    auto read_chunk = [&](size_t k) -> Result<std::shared_ptr<arrow::Table>> {
+      GAR_ASSIGN_OR_RAISE(auto path, get_path(groups_[k]));
+      return utils::ReadChunkTable(fs_, base_dir_ + path,
+                                   groups_[k].GetFileType(), group_columns_[k]);
+    };
+    // the rows of the filter columns, with the index of their first row
+    std::vector<std::pair<int64_t, std::shared_ptr<arrow::Table>>> pieces;
+    if (filter_group_num_ == 1) {
+      // prune the row groups by the statistics
+      GAR_ASSIGN_OR_RAISE(auto path, get_path(groups_[0]));
+      GAR_ASSIGN_OR_RAISE(
+          pieces, fs_->ReadFileToTablesWithFilter(base_dir_ + path,
+                                                  groups_[0].GetFileType(),
+                                                  filter_, group_columns_[0]));
+    } else {
+      arrow::FieldVector chunk_fields;
+      arrow::ChunkedArrayVector chunk_columns;
+      int64_t chunk_rows = 0;
+      for (size_t k = 0; k < filter_group_num_; ++k) {
+        GAR_ASSIGN_OR_RAISE(auto table, read_chunk(k));
+        chunk_rows = table->num_rows();
+        for (int j = 0; j < table->num_columns(); ++j) {
+          chunk_fields.push_back(table->schema()->field(j));
+          chunk_columns.push_back(table->column(j));
+        }
+      }
+      if (filter_group_num_ == 0) {
+        GAR_ASSIGN_OR_RAISE(chunk_rows, count_rows());
+      }
+      pieces.emplace_back(0, arrow::Table::Make(arrow::schema(chunk_fields),
+                                                chunk_columns, chunk_rows));
+    }
+
+    for (const auto& piece : pieces) {
+      GAR_ASSIGN_OR_RAISE(auto rows,
+                          GetMatchedRows(piece.second, filter_, *schema_));
+      if (rows.empty()) {
+        continue;
+      }
+      std::vector<int64_t> chunk_rows(rows);
+      for (auto& row : chunk_rows) {
+        row += piece.first;
+      }
+      GAR_ASSIGN_OR_RAISE(auto columns, take_ids(chunk_rows));
+      for (size_t k = 0; k < property_names_.size(); ++k) {
+        const auto& type = out_schema_->field(id_num_ + k)->type();
+        auto column = piece.second->GetColumnByName(property_names_[k]);
+        if (column != nullptr) {
+          GAR_ASSIGN_OR_RAISE(column, TakeColumn(column, rows, type));
+        } else {
+          // a property of another group, read from the whole chunk
+          size_t g = groupOf(property_names_[k]);
+          GAR_ASSIGN_OR_RAISE(auto table, read_chunk(g));
+          GAR_ASSIGN_OR_RAISE(
+              column, TakeColumn(table->GetColumnByName(property_names_[k]),
+                                 chunk_rows, type));
+        }
+        columns.push_back(column);
+      }
+      tables_.push_back(arrow::Table::Make(out_schema_, columns));
+    }
+    return Status::OK();
+  }
+
+  // the table of the matched rows of all the scanned chunks
+  Result<std::shared_ptr<arrow::Table>> Finish() const {
+    if (tables_.empty()) {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+          auto table, arrow::Table::MakeEmpty(out_schema_));
+      return table;
+    }
+    GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto table,
+                                         arrow::ConcatenateTables(tables_));
+    return table;
+  }
+
+ private:
+  // read the property with the columns of its group
+  Status addColumn(const std::vector<PropertyGroup>& property_groups,
+                   const std::string& name) {
+    auto pg = std::find_if(
+        property_groups.begin(), property_groups.end(),
+        [&](const PropertyGroup& group) {
+          const auto& properties = group.GetProperties();
+          return std::any_of(
+              properties.begin(), properties.end(),
+              [&](const Property& property) { return property.name == name; });
+        });
+    if (pg == property_groups.end()) {
+      return Status::KeyError("The property is not found.");
+    }
+    size_t i = std::find(groups_.begin(), groups_.end(), *pg) - groups_.begin();
+    if (i == groups_.size()) {
+      groups_.push_back(*pg);
+      group_columns_.emplace_back();
+    }
+    auto& columns = group_columns_[i];
+    if (std::find(columns.begin(), columns.end(), name) == columns.end()) {
+      columns.push_back(name);
+    }
+    return Status::OK();
+  }
+
+  // the index of the group read with the property
+  size_t groupOf(const std::string& name) const {
+    size_t i = 0;
+    while (std::find(group_columns_[i].begin(), group_columns_[i].end(),
+                     name) == group_columns_[i].end()) {
+      ++i;
+    }
+    return i;
+  }
+
+  arrow::compute::Expression filter_;
+  std::shared_ptr<arrow::Schema> schema_;
+  std::vector<PropertyGroup> groups_;
+  std::vector<std::vector<std::string>> group_columns_;
+  size_t filter_group_num_ = 0;
+  size_t id_num_ = 0;
+  std::shared_ptr<arrow::Schema> out_schema_;
+  std::vector<std::string> property_names_;
+  std::shared_ptr<FileSystem> fs_;
+  std::string base_dir_;
+  std::vector<std::shared_ptr<arrow::Table>> tables_;
+};
+}  // namespace
+
+namespace {
+// the arrow array of the values of type T
+template <typename T>
+struct ValueArray {};
+
+template <>
+struct ValueArray<bool> {
+  using type = arrow::BooleanArray;
+};
+
+template <>
+struct ValueArray<int32_t> {
+  using type = arrow::Int32Array;
+};
+
+template <>
+struct ValueArray<int64_t> {
+  using type = arrow::Int64Array;
+};
+
+template <>
+struct ValueArray<float> {
+  using type = arrow::FloatArray;
+};
+
+template <>
+struct ValueArray<double> {
+  using type = arrow::DoubleArray;
+};
+
+template <>
+struct ValueArray<std::string> {
+  using type = arrow::StringArray;
+};
+
+template <>
+struct ValueArray<std::string_view> {
+  using type = arrow::StringArray;
+};
+
+// get the value of the property at the first rows of the chunks, the strings
+// are viewed in place in the chunks
+template <typename T>
+Result<T> GetPropertyValue(
+    const std::vector<std::shared_ptr<arrow::Table>>& chunks,
+    const std::string& property) {
+  using ArrayType = typename ValueArray<T>::type;
+  for (const auto& chunk_table : chunks) {
+    auto column = chunk_table->GetColumnByName(property);
+    if (column == nullptr) {
+      continue;
+    }
+    auto array = column->chunk(0);
+    if (array->type_id() != ArrayType::TypeClass::type_id) {
+      return Status::TypeError("The property type is not match.");
+    }
+    auto value = static_cast<const ArrayType&>(*array).GetView(0);
+    if constexpr (std::is_same_v<T, std::string> ||
+                  std::is_same_v<T, std::string_view>) {
+      return T(value.data(), value.size());
+    } else {
+      return value;
+    }
+  }
+  return Status::KeyError("The property is not exist.");
 }
 
-Vertex::Vertex(IdType id,
-               std::vector<VertexPropertyArrowChunkReader>& readers)  // NOLINT
-    : id_(id) {
-  // get the first row of table
-  for (auto& reader : readers) {
-    GAR_ASSIGN_OR_RAISE_ERROR(auto chunk_table, reader.GetChunk());
-    auto schema = chunk_table->schema();
-    for (int i = 0; i < schema->num_fields(); ++i) {
-      auto field = chunk_table->field(i);
-      auto type = DataType::ArrowDataTypeToDataType(field->type());
-      GAR_RAISE_ERROR_NOT_OK(TryToCastToAny(
-          type, chunk_table->column(i)->chunk(0), properties_[field->name()]));
+// get the chunks of the readers sliced at their current rows, and keep the
+// first error
+template <typename Reader>
+std::vector<std::shared_ptr<arrow::Table>> GetReaderChunks(
+    std::vector<Reader>* readers, Status* status) {
+  std::vector<std::shared_ptr<arrow::Table>> chunks;
+  chunks.reserve(readers->size());
+  for (auto& reader : *readers) {
+    auto maybe_chunk = reader.GetChunk();
+    if (!maybe_chunk.status().ok()) {
+      *status = maybe_chunk.status();
+      return {};
     }
+    chunks.push_back(maybe_chunk.value());
   }
+  return chunks;
+}
+
+// get the source or destination id at the first row of the adj list chunk
+IdType GetEndpoint(const std::shared_ptr<arrow::Table>& chunk_table,
+                   const Status& status, int column_index) {
+  GAR_RAISE_ERROR_NOT_OK(status);
+  return static_cast<const arrow::Int64Array&>(
+             *chunk_table->column(column_index)->chunk(0))
+      .Value(0);
+}
+}  // namespace
+
+Vertex::Vertex(IdType id,
+               std::vector<VertexPropertyArrowChunkReader>& readers) noexcept
+    : id_(id), chunks_(GetReaderChunks(&readers, &status_)) {}
+
+template <typename T>
+Result<T> Vertex::property(const std::string& property) const noexcept {
+  GAR_RETURN_NOT_OK(status_);
+  return GetPropertyValue<T>(chunks_, property);
 }
 
 Edge::Edge(
-    AdjListArrowChunkReader& adj_list_reader,                          // NOLINT
-    std::vector<AdjListPropertyArrowChunkReader>& property_readers) {  // NOLINT
-  // get the first row of table
-  GAR_ASSIGN_OR_RAISE_ERROR(auto adj_list_chunk_table,
-                            adj_list_reader.GetChunk());
-  src_id_ = std::dynamic_pointer_cast<arrow::Int64Array>(
-                adj_list_chunk_table->column(0)->chunk(0))
-                ->GetView(0);
-  dst_id_ = std::dynamic_pointer_cast<arrow::Int64Array>(
-                adj_list_chunk_table->column(1)->chunk(0))
-                ->GetView(0);
-  for (auto& reader : property_readers) {
-    // get the first row of table
-    GAR_ASSIGN_OR_RAISE_ERROR(auto chunk_table, reader.GetChunk());
-    auto schema = chunk_table->schema();
-    for (int i = 0; i < schema->num_fields(); ++i) {
-      auto field = chunk_table->field(i);
-      auto type = DataType::ArrowDataTypeToDataType(field->type());
-      GAR_RAISE_ERROR_NOT_OK(TryToCastToAny(
-          type, chunk_table->column(i)->chunk(0), properties_[field->name()]));
+    AdjListArrowChunkReader& adj_list_reader,
+    std::vector<AdjListPropertyArrowChunkReader>& property_readers) noexcept {
+  auto maybe_chunk = adj_list_reader.GetChunk();
+  if (!maybe_chunk.status().ok()) {
+    status_ = maybe_chunk.status();
+    return;
+  }
+  adj_list_chunk_ = maybe_chunk.value();
+  property_chunks_ = GetReaderChunks(&property_readers, &status_);
+}
+
+IdType Edge::source() const {
+  return GetEndpoint(adj_list_chunk_, status_, 0);
+}
+
+IdType Edge::destination() const {
+  return GetEndpoint(adj_list_chunk_, status_, 1);
+}
+
+template <typename T>
+Result<T> Edge::property(const std::string& property) const noexcept {
+  GAR_RETURN_NOT_OK(status_);
+  return GetPropertyValue<T>(property_chunks_, property);
+}
+
+#define INSTANTIATE_PROPERTY(T)                                          \
+  template Result<T> Vertex::property<T>(const std::string& property) \
+      const noexcept;                                                   \
+  template Result<T> Edge::property<T>(const std::string& property)   \
+      const noexcept;
+
+INSTANTIATE_PROPERTY(bool)
+INSTANTIATE_PROPERTY(int32_t)
+INSTANTIATE_PROPERTY(int64_t)
+INSTANTIATE_PROPERTY(float)
+INSTANTIATE_PROPERTY(double)
+INSTANTIATE_PROPERTY(std::string)
+INSTANTIATE_PROPERTY(std::string_view)
+
+#undef INSTANTIATE_PROPERTY
+
+Status VertexIter::loadCursor(int reader_index, int column_index,
+                              const std::string& name,
+                              util::ColumnCursor* cursor) {
+  if (reader_index < 0 || reader_index >= static_cast<int>(readers_.size())) {
+    return Status::KeyError("The property " + name + " is not read.");
+  }
+  auto& reader = readers_[reader_index];
+  GAR_RETURN_NOT_OK(reader.seek(cur_offset_));
+  GAR_ASSIGN_OR_RAISE(auto chunk_table, reader.GetChunk());
+  return util::LoadColumnCursor(chunk_table, cur_offset_, column_index, name,
+                                cursor);
+}
+
+Result<std::shared_ptr<EdgeCollectionMeta>> EdgeCollectionMeta::Make(
+    const EdgeInfo& edge_info, AdjListType adj_list_type,
+    const std::string& prefix,
+    std::shared_ptr<util::IndexConverter> index_converter,
+    std::shared_ptr<OffsetIndex> offset_index) noexcept {
+  auto meta = std::make_shared<EdgeCollectionMeta>();
+  meta->edge_info = edge_info;
+  meta->adj_list_type = adj_list_type;
+  GAR_ASSIGN_OR_RAISE(meta->fs,
+                      FileSystemFromUriOrPath(prefix, &meta->path_prefix));
+  GAR_ASSIGN_OR_RAISE(auto adj_list_path_prefix,
+                      edge_info.GetAdjListPathPrefix(adj_list_type));
+  GAR_ASSIGN_OR_RAISE(
+      meta->adj_list_manifest,
+      ChunkManifest::Make(meta->fs, meta->path_prefix + adj_list_path_prefix));
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info.GetPropertyGroups(adj_list_type));
+  for (const auto& pg : property_groups) {
+    GAR_ASSIGN_OR_RAISE(
+        auto pg_path_prefix,
+        edge_info.GetPropertyGroupPathPrefix(pg, adj_list_type));
+    GAR_ASSIGN_OR_RAISE(
+        auto manifest,
+        ChunkManifest::Make(meta->fs, meta->path_prefix + pg_path_prefix));
+    meta->property_manifests.push_back(std::move(manifest));
+  }
+  // the members given by the caller are not made again, which would list
+  // the directories of a listed manifest
+  meta->index_converter = std::move(index_converter);
+  if (meta->index_converter == nullptr) {
+    GAR_ASSIGN_OR_RAISE(auto edge_chunk_nums,
+                        meta->adj_list_manifest->GetChunkNums());
+    meta->index_converter =
+        std::make_shared<util::IndexConverter>(std::move(edge_chunk_nums));
+  }
+  meta->offset_index = std::move(offset_index);
+  if (meta->offset_index == nullptr &&
+      (adj_list_type == AdjListType::ordered_by_source ||
+       adj_list_type == AdjListType::ordered_by_dest)) {
+    GAR_ASSIGN_OR_RAISE(meta->offset_index,
+                        OffsetIndex::Make(edge_info, adj_list_type, meta->fs,
+                                          meta->path_prefix,
+                                          meta->adj_list_manifest));
+  }
+  return meta;
+}
+
+EdgeIter::EdgeIter(std::shared_ptr<const EdgeCollectionMeta> meta,
+                   IdType global_chunk_index, IdType offset,
+                   IdType chunk_begin, IdType chunk_end,
+                   IdType offset_of_chunk_begin, IdType offset_of_chunk_end,
+                   const std::vector<std::string>& property_names)
+    : adj_list_reader_(
+          meta->edge_info, meta->adj_list_type, meta->fs, meta->path_prefix,
+          meta->adj_list_manifest, meta->offset_index,
+          meta->index_converter->GlobalChunkIndexToIndexPair(global_chunk_index)
+              .first),
+      global_chunk_index_(global_chunk_index),
+      cur_offset_(offset),
+      chunk_size_(meta->edge_info.GetChunkSize()),
+      src_chunk_size_(meta->edge_info.GetSrcChunkSize()),
+      dst_chunk_size_(meta->edge_info.GetDstChunkSize()),
+      num_row_of_chunk_(0),
+      chunk_begin_(chunk_begin),
+      chunk_end_(chunk_end),
+      offset_of_chunk_begin_(offset_of_chunk_begin),
+      offset_of_chunk_end_(offset_of_chunk_end),
+      adj_list_type_(meta->adj_list_type),
+      meta_(std::move(meta)) {
+  vertex_chunk_index_ =
+      meta_->index_converter->GlobalChunkIndexToIndexPair(global_chunk_index)
+          .first;
+  const auto& edge_info = meta_->edge_info;
+  GAR_ASSIGN_OR_RAISE_ERROR(const auto& property_groups,
+                            edge_info.GetPropertyGroups(adj_list_type_));
+  for (size_t i = 0; i < property_groups.size(); ++i) {
+    const auto& pg = property_groups[i];
+    std::vector<std::string> selected;
+    if (!property_names.empty()) {
+      selected = utils::GetSelectedProperties(pg, property_names);
+      if (selected.empty()) {
+        continue;
+      }
+    }
+    property_readers_.emplace_back(edge_info, pg, adj_list_type_, meta_->fs,
+                                   meta_->path_prefix,
+                                   meta_->property_manifests[i],
+                                   meta_->offset_index, vertex_chunk_index_);
+    if (!selected.empty()) {
+      // the selected properties are of the group, so the selection never
+      // fails, and a failure would be a bug
+      GAR_RAISE_ERROR_NOT_OK(
+          property_readers_.back().SelectProperties(selected));
     }
   }
 }
 
+std::shared_ptr<const EdgeCollectionMeta> EdgeIter::openMeta(
+    const EdgeInfo& edge_info, const std::string& prefix,
+    AdjListType adj_list_type,
+    std::shared_ptr<util::IndexConverter> index_converter,
+    std::shared_ptr<OffsetIndex> offset_index) {
+  GAR_ASSIGN_OR_RAISE_ERROR(
+      auto meta,
+      EdgeCollectionMeta::Make(edge_info, adj_list_type, prefix,
+                               std::move(index_converter),
+                               std::move(offset_index)));
+  return meta;
+}
+
 IdType EdgeIter::source() {
   adj_list_reader_.seek(cur_offset_);
   GAR_ASSIGN_OR_RAISE_ERROR(auto chunk, adj_list_reader_.GetChunk());
@@ -114,6 +568,307 @@ IdType EdgeIter::destination() {
       ->GetView(0);
 }
 
+Status EdgeIter::forEachChunk(
+    const std::function<Status(const AdjListSpan&)>& func,
+    IdType prefetch_depth) {
+  AdjListArrowChunkReader reader(adj_list_reader_);
+  reader.SetPrefetchDepth(prefetch_depth);
+  return scanChunks(&reader, chunk_begin_, chunk_end_, 0, func);
+}
+
+Status EdgeIter::parallelForEachChunk(
+    const std::function<Status(const AdjListSpan&)>& func,
+    const std::vector<IdType>& edge_nums, int num_threads) {
+  IdType chunk_num = chunk_end_ - chunk_begin_;
+  if (chunk_num <= 0) {
+    return Status::OK();
+  }
+  // the offset of the first edge of each edge chunk among the edges iterated
+  std::vector<IdType> offsets(chunk_num + 1, 0);
+  for (IdType i = 0; i < chunk_num; ++i) {
+    IdType vertex_chunk_index, chunk_index;
+    std::tie(vertex_chunk_index, chunk_index) =
+        meta_->index_converter->GlobalChunkIndexToIndexPair(chunk_begin_ + i);
+    IdType edge_num = 0;
+    if (vertex_chunk_index < static_cast<IdType>(edge_nums.size())) {
+      edge_num = edge_nums[vertex_chunk_index] - chunk_index * chunk_size_;
+      edge_num = std::max<IdType>(0, std::min(edge_num, chunk_size_));
+    }
+    offsets[i + 1] = offsets[i] + edge_num;
+  }
+
+  if (num_threads <= 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  num_threads = static_cast<int>(std::min<IdType>(num_threads, chunk_num));
+  // split the chunks into ranges of about the same number of edges, a few
+  // ranges per thread so that the idle threads can steal from the others
+  IdType range_num = std::min<IdType>(chunk_num, num_threads * 4);
+  std::vector<std::pair<IdType, IdType>> ranges;
+  IdType range_begin = 0;
+  for (IdType i = 1; i <= range_num && range_begin < chunk_num; ++i) {
+    IdType target = offsets.back() * i / range_num;
+    IdType range_end = range_begin + 1;
+    while (range_end < chunk_num && offsets[range_end] < target) {
+      ++range_end;
+    }
+    if (i == range_num) {
+      range_end = chunk_num;
+    }
+    ranges.emplace_back(range_begin, range_end);
+    range_begin = range_end;
+  }
+
+  // each worker takes the ranges from the front of its own queue, and from
+  // the back of the queues of the others once its queue is empty
+  struct RangeQueue {
+    std::mutex mutex;
+    std::deque<std::pair<IdType, IdType>> ranges;
+  };
+  std::vector<RangeQueue> queues(num_threads);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    queues[i * num_threads / ranges.size()].ranges.push_back(ranges[i]);
+  }
+  std::atomic<bool> failed(false);
+  std::mutex status_mutex;
+  Status status = Status::OK();
+  auto worker = [&](int index) {
+    // the reader of the worker, reused by all the ranges it scans
+    AdjListArrowChunkReader reader(adj_list_reader_);
+    while (!failed.load()) {
+      std::pair<IdType, IdType> range;
+      bool found = false;
+      for (int i = 0; i < num_threads && !found; ++i) {
+        auto& queue = queues[(index + i) % num_threads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.ranges.empty()) {
+          if (i == 0) {
+            range = queue.ranges.front();
+            queue.ranges.pop_front();
+          } else {
+            range = queue.ranges.back();
+            queue.ranges.pop_back();
+          }
+          found = true;
+        }
+      }
+      if (!found) {
+        return;
+      }
+      auto st = scanChunks(&reader, chunk_begin_ + range.first,
+                           chunk_begin_ + range.second, offsets[range.first],
+                           func);
+      if (!st.ok()) {
+        std::lock_guard<std::mutex> lock(status_mutex);
+        if (!failed.exchange(true)) {
+          status = std::move(st);
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker, i);
+  }
+  worker(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+}
+
+Status EdgeIter::scanChunks(
+    AdjListArrowChunkReader* reader, IdType begin, IdType end, IdType offset,
+    const std::function<Status(const AdjListSpan&)>& func) const {
+  AdjListSpan span;
+  span.offset = offset;
+  bool seek = true;
+  for (IdType i = begin; i < end; ++i) {
+    if (seek) {
+      // the vertex chunks without edge chunks are skipped by the converter
+      std::tie(span.vertex_chunk_index, span.chunk_index) =
+          meta_->index_converter->GlobalChunkIndexToIndexPair(i);
+      GAR_RETURN_NOT_OK(reader->seek_chunk_index(span.vertex_chunk_index));
+    }
+    GAR_RETURN_NOT_OK(reader->seek(span.chunk_index * chunk_size_));
+    GAR_ASSIGN_OR_RAISE(span.table, reader->GetChunk());
+    if (span.table->num_columns() < 2 ||
+        span.table->column(0)->type()->id() != arrow::Type::INT64 ||
+        span.table->column(1)->type()->id() != arrow::Type::INT64) {
+      return Status::TypeError("The adj list chunk must have int64 source "
+                               "and destination columns.");
+    }
+    if (span.table->column(0)->num_chunks() != 1 ||
+        span.table->column(1)->num_chunks() != 1) {
+      GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(span.table,
+                                           span.table->CombineChunks());
+    }
+    span.size = span.table->num_rows();
+    span.src = span.dst = nullptr;
+    if (span.size > 0) {
+      span.src = std::static_pointer_cast<arrow::Int64Array>(
+                     span.table->column(0)->chunk(0))
+                     ->raw_values();
+      span.dst = std::static_pointer_cast<arrow::Int64Array>(
+                     span.table->column(1)->chunk(0))
+                     ->raw_values();
+    }
+    GAR_RETURN_NOT_OK(func(span));
+    span.offset += span.size;
+    ++span.chunk_index;
+    // the next edge chunk is in the same vertex chunk if the reader does not
+    // reach the end of the vertex chunk
+    seek = !reader->next_chunk().ok();
+  }
+  return Status::OK();
+}
+
+Result<std::shared_ptr<arrow::Table>> EdgeIter::filter(
+    const arrow::compute::Expression& filter,
+    const std::vector<std::string>& property_names) const {
+  const auto& edge_info = meta_->edge_info;
+  GAR_ASSIGN_OR_RAISE(const auto& property_groups,
+                      edge_info.GetPropertyGroups(adj_list_type_));
+  GAR_ASSIGN_OR_RAISE(
+      auto scan,
+      FilterScan::Make(
+          property_groups, filter, property_names,
+          {arrow::field(GeneralParams::kSrcIndexCol, arrow::int64()),
+           arrow::field(GeneralParams::kDstIndexCol, arrow::int64())},
+          meta_->fs, meta_->path_prefix));
+  GAR_ASSIGN_OR_RAISE(auto adj_list_file_type,
+                      edge_info.GetFileType(adj_list_type_));
+  const std::vector<std::string> adj_list_columns = {
+      GeneralParams::kSrcIndexCol, GeneralParams::kDstIndexCol};
+  for (IdType i = chunk_begin_; i < chunk_end_; ++i) {
+    IdType vertex_chunk_index, chunk_index;
+    std::tie(vertex_chunk_index, chunk_index) =
+        meta_->index_converter->GlobalChunkIndexToIndexPair(i);
+    // the topology of the chunk, read once a row matches
+    std::shared_ptr<arrow::Table> adj_list_table;
+    auto read_adj_list = [&]() -> Status {
+      if (adj_list_table == nullptr) {
+        GAR_ASSIGN_OR_RAISE(auto path, edge_info.GetAdjListFilePath(
+                                           vertex_chunk_index, chunk_index,
+                                           adj_list_type_));
+        GAR_ASSIGN_OR_RAISE(
+            adj_list_table,
+            utils::ReadChunkTable(meta_->fs, meta_->path_prefix + path,
+                                  adj_list_file_type, adj_list_columns));
+      }
+      return Status::OK();
+    };
+    GAR_RETURN_NOT_OK(scan.ScanChunk(
+        [&](const PropertyGroup& pg) {
+          return edge_info.GetPropertyFilePath(pg, adj_list_type_,
+                                               vertex_chunk_index, chunk_index);
+        },
+        [&]() -> Result<int64_t> {
+          // a filter without properties, count the rows of the topology
+          GAR_RETURN_NOT_OK(read_adj_list());
+          return adj_list_table->num_rows();
+        },
+        [&](const std::vector<int64_t>& rows)
+            -> Result<arrow::ChunkedArrayVector> {
+          // materialize the topology of the matched rows only
+          GAR_RETURN_NOT_OK(read_adj_list());
+          arrow::ChunkedArrayVector columns;
+          for (const auto& name : adj_list_columns) {
+            GAR_ASSIGN_OR_RAISE(
+                auto column, TakeColumn(adj_list_table->GetColumnByName(name),
+                                        rows, arrow::int64()));
+            columns.push_back(column);
+          }
+          return columns;
+        }));
+  }
+  return scan.Finish();
+}
+
+Status EdgeIter::loadCursor(int reader_index, int column_index,
+                            const std::string& name,
+                            util::ColumnCursor* cursor) {
+  if (reader_index < 0 ||
+      reader_index >= static_cast<int>(property_readers_.size())) {
+    return Status::KeyError("The property " + name + " is not read.");
+  }
+  auto& reader = property_readers_[reader_index];
+  GAR_RETURN_NOT_OK(reader.seek(cur_offset_));
+  GAR_ASSIGN_OR_RAISE(auto chunk_table, reader.GetChunk());
+  GAR_RETURN_NOT_OK(util::LoadColumnCursor(chunk_table, cur_offset_,
+                                           column_index, name, cursor));
+  cursor->vertex_chunk_index = vertex_chunk_index_;
+  return Status::OK();
+}
+
+Result<NeighborList> NeighborList::load(AdjListArrowChunkReader* reader,
+                                        OffsetIndex* offset_index, IdType vid,
+                                        bool by_source) noexcept {
+  GAR_ASSIGN_OR_RAISE(auto range, offset_index->GetOffsetRange(vid));
+  NeighborList list;
+  if (range.first >= range.second) {
+    return list;
+  }
+  GAR_RETURN_NOT_OK(
+      reader->seek_chunk_index(vid / offset_index->GetVertexChunkSize()));
+  // the column of the neighbor ids
+  int column_index = by_source ? 1 : 0;
+  IdType pos = range.first;
+  while (pos < range.second) {
+    // the chunk from pos to the end of its edge chunk
+    GAR_RETURN_NOT_OK(reader->seek(pos));
+    GAR_ASSIGN_OR_RAISE(auto table, reader->GetChunk());
+    if (table->num_rows() == 0) {
+      return Status::Invalid("The adj list chunks do not match the offsets "
+                             "of the vertex " +
+                             std::to_string(vid) + ".");
+    }
+    auto column = table->column(column_index);
+    if (column->type()->id() != arrow::Type::INT64) {
+      return Status::TypeError("The adj list column must be int64.");
+    }
+    for (const auto& array : column->chunks()) {
+      if (pos >= range.second) {
+        break;
+      }
+      int64_t size = std::min<int64_t>(array->length(), range.second - pos);
+      if (size > 0) {
+        auto ids = std::static_pointer_cast<arrow::Int64Array>(array);
+        list.slices_.push_back({ids->raw_values(), size});
+        pos += size;
+      }
+    }
+    list.tables_.push_back(std::move(table));
+  }
+  list.size_ = range.second - range.first;
+  return list;
+}
+
+bool EdgeIter::chunkMayContain(IdType id, bool by_src) const noexcept {
+  const auto& zone_maps = adj_list_reader_.GetManifest()->GetZoneMaps();
+  if (global_chunk_index_ < 0 ||
+      global_chunk_index_ >= static_cast<IdType>(zone_maps.size())) {
+    return true;
+  }
+  const auto& zone_map = zone_maps[global_chunk_index_];
+  return by_src ? zone_map.MayContainSrc(id) : zone_map.MayContainDst(id);
+}
+
+void EdgeIter::skipChunk() {
+  if (global_chunk_index_ >= chunk_end_) {
+    cur_offset_ = offset_of_chunk_end_;
+    return;
+  }
+  auto index_pair = meta_->index_converter->GlobalChunkIndexToIndexPair(
+      ++global_chunk_index_);
+  vertex_chunk_index_ = index_pair.first;
+  cur_offset_ = index_pair.second * chunk_size_;
+  if (!is_end()) {
+    refresh();
+  }
+}
+
 bool EdgeIter::first_src(const EdgeIter& from, IdType id) {
   if (from.is_end())
     return false;
@@ -139,6 +894,10 @@ bool EdgeIter::first_src(const EdgeIter& from, IdType id) {
       this->refresh();
     }
     while (!this->is_end()) {
+      if (!chunkMayContain(id, true)) {
+        skipChunk();
+        continue;
+      }
       if (this->source() == id)
         return true;
       this->operator++();
@@ -149,7 +908,8 @@ bool EdgeIter::first_src(const EdgeIter& from, IdType id) {
   // unordered_by_source
   if (adj_list_type_ == AdjListType::unordered_by_source) {
     IdType expect_chunk_index =
-        index_converter_->IndexPairToGlobalChunkIndex(id / src_chunk_size_, 0);
+        meta_->index_converter->IndexPairToGlobalChunkIndex(
+            id / src_chunk_size_, 0);
     if (expect_chunk_index > chunk_end_)
       return false;
     if (from.global_chunk_index_ > chunk_end_ ||
@@ -179,35 +939,33 @@ bool EdgeIter::first_src(const EdgeIter& from, IdType id) {
     if (need_refresh)
       this->refresh();
     while (!this->is_end()) {
-      if (this->source() == id)
-        return true;
       if (vertex_chunk_index_ > id / src_chunk_size_)
         return false;
+      if (!chunkMayContain(id, true)) {
+        skipChunk();
+        continue;
+      }
+      if (this->source() == id)
+        return true;
       this->operator++();
     }
     return false;
   }
 
   // ordered_by_source
-  auto st = offset_reader_->seek(id);
-  if (!st.ok()) {
-    return false;
-  }
-  auto maybe_offset_chunk = offset_reader_->GetChunk();
-  if (!maybe_offset_chunk.status().ok()) {
+  auto maybe_range = meta_->offset_index->GetOffsetRange(id);
+  if (!maybe_range.status().ok()) {
     return false;
   }
-  auto offset_array =
-      std::dynamic_pointer_cast<arrow::Int64Array>(maybe_offset_chunk.value());
-  auto begin_offset = static_cast<IdType>(offset_array->Value(0));
-  auto end_offset = static_cast<IdType>(offset_array->Value(1));
+  auto begin_offset = maybe_range.value().first;
+  auto end_offset = maybe_range.value().second;
   if (begin_offset >= end_offset) {
     return false;
   }
-  auto vertex_chunk_index_of_id = offset_reader_->GetChunkIndex();
-  auto begin_global_index = index_converter_->IndexPairToGlobalChunkIndex(
+  auto vertex_chunk_index_of_id = id / src_chunk_size_;
+  auto begin_global_index = meta_->index_converter->IndexPairToGlobalChunkIndex(
       vertex_chunk_index_of_id, begin_offset / chunk_size_);
-  auto end_global_index = index_converter_->IndexPairToGlobalChunkIndex(
+  auto end_global_index = meta_->index_converter->IndexPairToGlobalChunkIndex(
       vertex_chunk_index_of_id, end_offset / chunk_size_);
   if (begin_global_index <= from.global_chunk_index_ &&
       from.global_chunk_index_ <= end_global_index) {
@@ -262,6 +1020,10 @@ bool EdgeIter::first_dst(const EdgeIter& from, IdType id) {
       this->refresh();
     }
     while (!this->is_end()) {
+      if (!chunkMayContain(id, false)) {
+        skipChunk();
+        continue;
+      }
       if (this->destination() == id)
         return true;
       this->operator++();
@@ -272,7 +1034,8 @@ bool EdgeIter::first_dst(const EdgeIter& from, IdType id) {
   // unordered_by_dest
   if (adj_list_type_ == AdjListType::unordered_by_dest) {
     IdType expect_chunk_index =
-        index_converter_->IndexPairToGlobalChunkIndex(id / dst_chunk_size_, 0);
+        meta_->index_converter->IndexPairToGlobalChunkIndex(
+            id / dst_chunk_size_, 0);
     if (expect_chunk_index > chunk_end_)
       return false;
     if (from.global_chunk_index_ > chunk_end_ ||
@@ -302,35 +1065,33 @@ bool EdgeIter::first_dst(const EdgeIter& from, IdType id) {
     if (need_refresh)
       this->refresh();
     while (!this->is_end()) {
-      if (this->destination() == id)
-        return true;
       if (vertex_chunk_index_ > id / dst_chunk_size_)
         return false;
+      if (!chunkMayContain(id, false)) {
+        skipChunk();
+        continue;
+      }
+      if (this->destination() == id)
+        return true;
       this->operator++();
     }
     return false;
   }
 
   // ordered_by_dest
-  auto st = offset_reader_->seek(id);
-  if (!st.ok()) {
+  auto maybe_range = meta_->offset_index->GetOffsetRange(id);
+  if (!maybe_range.status().ok()) {
     return false;
   }
-  auto maybe_offset_chunk = offset_reader_->GetChunk();
-  if (!maybe_offset_chunk.status().ok()) {
-    return false;
-  }
-  auto offset_array =
-      std::dynamic_pointer_cast<arrow::Int64Array>(maybe_offset_chunk.value());
-  auto begin_offset = static_cast<IdType>(offset_array->Value(0));
-  auto end_offset = static_cast<IdType>(offset_array->Value(1));
+  auto begin_offset = maybe_range.value().first;
+  auto end_offset = maybe_range.value().second;
   if (begin_offset >= end_offset) {
     return false;
   }
-  auto vertex_chunk_index_of_id = offset_reader_->GetChunkIndex();
-  auto begin_global_index = index_converter_->IndexPairToGlobalChunkIndex(
+  auto vertex_chunk_index_of_id = id / dst_chunk_size_;
+  auto begin_global_index = meta_->index_converter->IndexPairToGlobalChunkIndex(
       vertex_chunk_index_of_id, begin_offset / chunk_size_);
-  auto end_global_index = index_converter_->IndexPairToGlobalChunkIndex(
+  auto end_global_index = meta_->index_converter->IndexPairToGlobalChunkIndex(
       vertex_chunk_index_of_id, end_offset / chunk_size_);
   if (begin_global_index <= from.global_chunk_index_ &&
       from.global_chunk_index_ <= end_global_index) {
@@ -360,6 +1121,42 @@ bool EdgeIter::first_dst(const EdgeIter& from, IdType id) {
   }
 }
 
+Result<std::shared_ptr<arrow::Table>> VerticesCollection::Filter(
+    const arrow::compute::Expression& filter,
+    const std::vector<std::string>& property_names) noexcept {
+  std::string base_dir;
+  GAR_ASSIGN_OR_RAISE(auto fs, FileSystemFromUriOrPath(prefix_, &base_dir));
+  GAR_ASSIGN_OR_RAISE(
+      auto scan,
+      FilterScan::Make(
+          vertex_info_.GetPropertyGroups(), filter, property_names,
+          {arrow::field(GeneralParams::kVertexIndexCol, arrow::int64())}, fs,
+          base_dir));
+  IdType chunk_size = vertex_info_.GetChunkSize();
+  IdType chunk_num = (vertex_num_ + chunk_size - 1) / chunk_size;
+  for (IdType chunk_index = 0; chunk_index < chunk_num; ++chunk_index) {
+    GAR_RETURN_NOT_OK(scan.ScanChunk(
+        [&](const PropertyGroup& pg) {
+          return vertex_info_.GetFilePath(pg, chunk_index);
+        },
+        [&]() -> Result<int64_t> {
+          return std::min(chunk_size, vertex_num_ - chunk_index * chunk_size);
+        },
+        [&](const std::vector<int64_t>& rows)
+            -> Result<arrow::ChunkedArrayVector> {
+          arrow::Int64Builder id_builder;
+          for (auto row : rows) {
+            RETURN_NOT_ARROW_OK(
+                id_builder.Append(chunk_index * chunk_size + row));
+          }
+          GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto ids, id_builder.Finish());
+          return arrow::ChunkedArrayVector{
+              std::make_shared<arrow::ChunkedArray>(ids)};
+        }));
+  }
+  return scan.Finish();
+}
+
 const AdjListType
     EdgesCollection<AdjListType::ordered_by_source>::adj_list_type_ =
         AdjListType::ordered_by_source;
@@ -23,6 +23,67 @@ limitations under the License.
 
 namespace GAR_NAMESPACE_INTERNAL {
 
+namespace {
+// load the writer options of a property group or an adj list, the options
+// not in the node are not set
+Result<WriterOptions> LoadWriterOptions(const YAML::Node& node) {
+  WriterOptions options;
+  if (!node) {
+    return options;
+  }
+  if (node["compression"]) {
+    options.compression = node["compression"].as<std::string>();
+  }
+  if (node["compression_level"]) {
+    options.compression_level = node["compression_level"].as<int>();
+  }
+  if (node["row_group_size"]) {
+    options.row_group_size = node["row_group_size"].as<int64_t>();
+  }
+  if (node["dictionary"]) {
+    options.dictionary = node["dictionary"].as<bool>();
+  }
+  if (node["page_size"]) {
+    options.page_size = node["page_size"].as<int64_t>();
+  }
+  if (node["statistics"]) {
+    options.statistics = node["statistics"].as<bool>();
+  }
+  if (node["page_index"]) {
+    options.page_index = node["page_index"].as<bool>();
+  }
+  GAR_RETURN_NOT_OK(options.Validate());
+  return options;
+}
+
+// dump the options that are set
+YAML::Node DumpWriterOptions(const WriterOptions& options) {
+  YAML::Node node;
+  if (!options.compression.empty()) {
+    node["compression"] = options.compression;
+  }
+  if (options.compression_level) {
+    node["compression_level"] = *options.compression_level;
+  }
+  if (options.row_group_size) {
+    node["row_group_size"] = *options.row_group_size;
+  }
+  if (options.dictionary) {
+    node["dictionary"] = *options.dictionary;
+  }
+  if (options.page_size) {
+    node["page_size"] = *options.page_size;
+  }
+  if (options.statistics) {
+    node["statistics"] = *options.statistics;
+  }
+  if (options.page_index) {
+    node["page_index"] = *options.page_index;
+  }
+  return node;
+}
+}  // namespace
+
 Result<VertexInfo> VertexInfo::Load(std::shared_ptr<Yaml> yaml) {
   if (yaml == nullptr) {
     return Status::YamlError("yaml is nullptr");
@@ -62,7 +123,9 @@ Result<VertexInfo> VertexInfo::Load(std::shared_ptr<Yaml> yaml) {
         property.is_primary = iit->operator[]("is_primary").as<bool>();
         property_vec.push_back(property);
       }
-      PropertyGroup pg(property_vec, file_type, pg_prefix);
+      GAR_ASSIGN_OR_RAISE(auto writer_options,
+                          LoadWriterOptions(it->operator[]("writer_options")));
+      PropertyGroup pg(property_vec, file_type, pg_prefix, writer_options);
       GAR_RETURN_NOT_OK(vertex_info.AddPropertyGroup(pg));
     }
   }
@@ -83,6 +146,9 @@ Result<std::string> VertexInfo::Dump() const noexcept {
       pg_node["prefix"] = pg.GetPrefix();
     }
     pg_node["file_type"] = FileTypeToString(pg.GetFileType());
+    if (!pg.GetWriterOptions().Empty()) {
+      pg_node["writer_options"] = DumpWriterOptions(pg.GetWriterOptions());
+    }
     for (auto& p : pg.GetProperties()) {
       YAML::Node p_node;
       p_node["name"] = p.name;
@@ -144,8 +210,10 @@ Result<EdgeInfo> EdgeInfo::Load(std::shared_ptr<Yaml> yaml) {
       if (it->operator[]("prefix")) {
         adj_list_prefix = it->operator[]("prefix").as<std::string>();
       }
-      GAR_RETURN_NOT_OK(
-          edge_info.AddAdjList(adj_list_type, file_type, adj_list_prefix));
+      GAR_ASSIGN_OR_RAISE(auto writer_options,
+                          LoadWriterOptions(it->operator[]("writer_options")));
+      GAR_RETURN_NOT_OK(edge_info.AddAdjList(adj_list_type, file_type,
+                                             adj_list_prefix, writer_options));
 
       auto property_groups = it->operator[]("property_groups");
       if (property_groups) {  // property_groups exist
@@ -168,7 +236,11 @@ Result<EdgeInfo> EdgeInfo::Load(std::shared_ptr<Yaml> yaml) {
             property.is_primary = p_it->operator[]("is_primary").as<bool>();
             property_vec.push_back(property);
           }
-          PropertyGroup pg(property_vec, file_type, pg_prefix);
+          GAR_ASSIGN_OR_RAISE(
+              auto pg_writer_options,
+              LoadWriterOptions(pg_it->operator[]("writer_options")));
+          PropertyGroup pg(property_vec, file_type, pg_prefix,
+                           pg_writer_options);
           GAR_RETURN_NOT_OK(edge_info.AddPropertyGroup(pg, adj_list_type));
         }
       }
@@ -199,12 +271,19 @@ Result<std::string> EdgeInfo::Dump() const noexcept {
     adj_list_node["prefix"] = adj_list2prefix_.at(adj_list_type);
     adj_list_node["file_type"] =
         FileTypeToString(adj_list2file_type_.at(adj_list_type));
+    const auto& writer_options = adj_list2writer_options_.at(adj_list_type);
+    if (!writer_options.Empty()) {
+      adj_list_node["writer_options"] = DumpWriterOptions(writer_options);
+    }
     for (const auto& pg : adj_list2property_groups_.at(adj_list_type)) {
       YAML::Node pg_node;
       if (!pg.GetPrefix().empty()) {
         pg_node["prefix"] = pg.GetPrefix();
       }
       pg_node["file_type"] = FileTypeToString(pg.GetFileType());
+      if (!pg.GetWriterOptions().Empty()) {
+        pg_node["writer_options"] = DumpWriterOptions(pg.GetWriterOptions());
+      }
       for (auto& p : pg.GetProperties()) {
         YAML::Node p_node;
         p_node["name"] = p.name;
@@ -0,0 +1,140 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "arrow/api.h"
+
+#include "gar/reader/offset_index.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+Result<std::shared_ptr<OffsetIndex>> OffsetIndex::Make(
+    const EdgeInfo& edge_info, AdjListType adj_list_type,
+    const std::string& prefix) noexcept {
+  std::string path_prefix;
+  GAR_ASSIGN_OR_RAISE(auto fs, FileSystemFromUriOrPath(prefix, &path_prefix));
+  return Make(edge_info, adj_list_type, fs, path_prefix);
+}
+
+Result<std::shared_ptr<OffsetIndex>> OffsetIndex::Make(
+    const EdgeInfo& edge_info, AdjListType adj_list_type,
+    std::shared_ptr<FileSystem> fs, const std::string& path_prefix) noexcept {
+  GAR_RETURN_NOT_OK(checkAdjListType(adj_list_type));
+  GAR_ASSIGN_OR_RAISE(auto dir_path,
+                      edge_info.GetOffsetPathPrefix(adj_list_type));
+  GAR_ASSIGN_OR_RAISE(auto vertex_chunk_num,
+                      fs->GetFileNumOfDir(path_prefix + dir_path));
+  return std::shared_ptr<OffsetIndex>(
+      new OffsetIndex(edge_info, adj_list_type, fs, path_prefix,
+                      static_cast<IdType>(vertex_chunk_num)));
+}
+
+Result<std::shared_ptr<OffsetIndex>> OffsetIndex::Make(
+    const EdgeInfo& edge_info, AdjListType adj_list_type,
+    std::shared_ptr<FileSystem> fs, const std::string& path_prefix,
+    const std::shared_ptr<ChunkManifest>& manifest) noexcept {
+  if (manifest == nullptr || manifest->IsListed()) {
+    return Make(edge_info, adj_list_type, fs, path_prefix);
+  }
+  GAR_RETURN_NOT_OK(checkAdjListType(adj_list_type));
+  return std::shared_ptr<OffsetIndex>(
+      new OffsetIndex(edge_info, adj_list_type, fs, path_prefix,
+                      manifest->GetVertexChunkNum()));
+}
+
+Status OffsetIndex::checkAdjListType(AdjListType adj_list_type) {
+  if (adj_list_type != AdjListType::ordered_by_source &&
+      adj_list_type != AdjListType::ordered_by_dest) {
+    return Status::Invalid("Invalid adj list type " +
+                           std::string(AdjListTypeToString(adj_list_type)) +
+                           " to construct OffsetIndex.");
+  }
+  return Status::OK();
+}
+
+OffsetIndex::OffsetIndex(const EdgeInfo& edge_info, AdjListType adj_list_type,
+                         std::shared_ptr<FileSystem> fs,
+                         const std::string& path_prefix,
+                         IdType vertex_chunk_num)
+    : edge_info_(edge_info),
+      adj_list_type_(adj_list_type),
+      fs_(fs),
+      path_prefix_(path_prefix),
+      vertex_chunk_num_(vertex_chunk_num),
+      chunks_(vertex_chunk_num),
+      loaded_(new std::atomic<bool>[vertex_chunk_num]),
+      mutexes_(new std::mutex[vertex_chunk_num]) {
+  vertex_chunk_size_ = adj_list_type == AdjListType::ordered_by_source
+                           ? edge_info.GetSrcChunkSize()
+                           : edge_info.GetDstChunkSize();
+  for (IdType i = 0; i < vertex_chunk_num; ++i) {
+    loaded_[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+Result<OffsetIndex::range_t> OffsetIndex::GetOffsetRange(IdType id) noexcept {
+  IdType vertex_chunk_index = id / vertex_chunk_size_;
+  if (id < 0 || vertex_chunk_index >= vertex_chunk_num_) {
+    return Status::KeyError("The id " + std::to_string(id) + " not exist.");
+  }
+  GAR_ASSIGN_OR_RAISE(auto offsets, getChunk(vertex_chunk_index));
+  size_t index = id % vertex_chunk_size_;
+  if (index + 1 >= offsets->size()) {
+    return Status::KeyError("The id " + std::to_string(id) + " not exist.");
+  }
+  return std::make_pair((*offsets)[index], (*offsets)[index + 1]);
+}
+
+Status OffsetIndex::LoadAll() noexcept {
+  for (IdType i = 0; i < vertex_chunk_num_; ++i) {
+    GAR_RETURN_NOT_OK(getChunk(i).status());
+  }
+  return Status::OK();
+}
+
+Result<const std::vector<IdType>*> OffsetIndex::getChunk(
+    IdType vertex_chunk_index) {
+  if (loaded_[vertex_chunk_index].load(std::memory_order_acquire)) {
+    return &chunks_[vertex_chunk_index];
+  }
+  std::lock_guard<std::mutex> lock(mutexes_[vertex_chunk_index]);
+  if (loaded_[vertex_chunk_index].load(std::memory_order_relaxed)) {
+    return &chunks_[vertex_chunk_index];
+  }
+  GAR_ASSIGN_OR_RAISE(
+      auto chunk_file_path,
+      edge_info_.GetAdjListOffsetFilePath(vertex_chunk_index, adj_list_type_));
+  GAR_ASSIGN_OR_RAISE(auto file_type, edge_info_.GetFileType(adj_list_type_));
+  // read the file directly rather than through the chunk cache, the offsets
+  // are kept by the index itself
+  GAR_ASSIGN_OR_RAISE(
+      auto table,
+      fs_->ReadFileToTable(path_prefix_ + chunk_file_path, file_type));
+  std::vector<IdType> offsets;
+  offsets.reserve(table->num_rows());
+  for (const auto& array : table->column(0)->chunks()) {
+    if (array->type()->id() != arrow::Type::INT64) {
+      return Status::Invalid("The offset column must be int64, but got " +
+                             array->type()->ToString());
+    }
+    auto int64_array = std::static_pointer_cast<arrow::Int64Array>(array);
+    offsets.insert(offsets.end(), int64_array->raw_values(),
+                   int64_array->raw_values() + int64_array->length());
+  }
+  chunks_[vertex_chunk_index] = std::move(offsets);
+  loaded_[vertex_chunk_index].store(true, std::memory_order_release);
+  return &chunks_[vertex_chunk_index];
+}
+
+}  // namespace GAR_NAMESPACE_INTERNAL
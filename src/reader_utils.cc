@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+
 #include "arrow/adapters/orc/adapter.h"
 #include "arrow/api.h"
 #include "arrow/csv/api.h"
@@ -21,12 +23,211 @@ limitations under the License.
 #include "parquet/arrow/reader.h"
 
 #include "gar/graph_info.h"
+#include "gar/utils/chunk_cache.h"
+#include "gar/utils/chunk_manifest.h"
 #include "gar/utils/filesystem.h"
 #include "gar/utils/reader_utils.h"
 
 namespace GAR_NAMESPACE_INTERNAL {
 
 namespace utils {
+
+Result<std::shared_ptr<arrow::Table>> ReadChunkTable(
+    const std::shared_ptr<FileSystem>& fs, const std::string& path,
+    FileType file_type, const std::vector<std::string>& columns) noexcept {
+  return ChunkCache::Global().GetOrLoad(path, columns, [&]() {
+    return fs->ReadFileToTable(path, file_type, columns);
+  });
+}
+
+namespace {
+// the cache keys of the row groups of a chunk file are the columns and a tag
+// that starts with '\x01', which does not start the names of the properties
+std::vector<std::string> GetRowGroupKey(const std::vector<std::string>& columns,
+                                        const std::string& tag) {
+  std::vector<std::string> key = columns;
+  key.push_back(std::string(1, '\x01') + tag);
+  return key;
+}
+}  // namespace
+
+Result<std::pair<std::shared_ptr<arrow::Table>, IdType>> ReadChunkTableFromRow(
+    const std::shared_ptr<FileSystem>& fs, const std::string& path,
+    FileType file_type, IdType row,
+    const std::vector<std::string>& columns) noexcept {
+  if (row <= 0 || file_type != FileType::PARQUET) {
+    GAR_ASSIGN_OR_RAISE(auto table,
+                        ReadChunkTable(fs, path, file_type, columns));
+    return std::make_pair(table, static_cast<IdType>(0));
+  }
+  auto& cache = ChunkCache::Global();
+  auto table = cache.Get(path, columns);
+  if (table != nullptr) {
+    return std::make_pair(table, static_cast<IdType>(0));
+  }
+  // the numbers of rows of the row groups, cached as a table of one column
+  GAR_ASSIGN_OR_RAISE(
+      auto row_num_table,
+      cache.GetOrLoad(
+          path, GetRowGroupKey({}, "row_groups"),
+          [&]() -> Result<std::shared_ptr<arrow::Table>> {
+            GAR_ASSIGN_OR_RAISE(auto row_nums,
+                                fs->GetRowGroupRowNums(path, file_type));
+            arrow::Int64Builder builder;
+            RETURN_NOT_ARROW_OK(builder.AppendValues(row_nums));
+            GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(auto array, builder.Finish());
+            return arrow::Table::Make(
+                arrow::schema({arrow::field("row_num", arrow::int64())}),
+                {array});
+          }));
+  auto row_nums = std::static_pointer_cast<arrow::Int64Array>(
+      row_num_table->column(0)->chunk(0));
+  // find the row group that contains the row
+  int num_row_groups = static_cast<int>(row_nums->length());
+  int first_row_group = 0;
+  IdType first_row = 0;
+  while (first_row_group < num_row_groups &&
+         first_row + row_nums->Value(first_row_group) <= row) {
+    first_row += row_nums->Value(first_row_group);
+    ++first_row_group;
+  }
+  if (first_row_group == 0 || first_row_group == num_row_groups) {
+    // the row is in the first row group or out of the file, read and cache
+    // the chunk as a whole
+    GAR_ASSIGN_OR_RAISE(table, ReadChunkTable(fs, path, file_type, columns));
+    return std::make_pair(table, static_cast<IdType>(0));
+  }
+  // each row group is decoded once and cached, so that the later seeks in the
+  // chunk only decode the row groups not read yet
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  std::vector<int> missing;
+  for (int i = first_row_group; i < num_row_groups; ++i) {
+    tables.push_back(
+        cache.Get(path, GetRowGroupKey(columns, std::to_string(i))));
+    if (tables.back() == nullptr) {
+      missing.push_back(i);
+    }
+  }
+  if (!missing.empty()) {
+    GAR_ASSIGN_OR_RAISE(
+        auto loaded, fs->ReadFileRowGroups(path, file_type, missing, columns));
+    for (size_t j = 0; j < missing.size(); ++j) {
+      GAR_ASSIGN_OR_RAISE(
+          tables[missing[j] - first_row_group],
+          cache.GetOrLoad(
+              path, GetRowGroupKey(columns, std::to_string(missing[j])),
+              [&]() {
+                return Result<std::shared_ptr<arrow::Table>>(loaded[j]);
+              }));
+    }
+  }
+  GAR_RETURN_ON_ARROW_ERROR_AND_ASSIGN(table, arrow::ConcatenateTables(tables));
+  return std::make_pair(table, first_row);
+}
+
+void PrefetchChunkTable(const std::shared_ptr<FileSystem>& fs,
+                        const std::string& path, FileType file_type,
+                        const std::vector<std::string>& columns) noexcept {
+  // the loader runs after the return, capture by value
+  ChunkCache::Global().Prefetch(path, columns, [=]() {
+    return fs->ReadFileToTable(path, file_type, columns);
+  });
+}
+
+std::vector<std::string> GetSelectedProperties(
+    const PropertyGroup& property_group,
+    const std::vector<std::string>& property_names) noexcept {
+  std::vector<std::string> selected;
+  for (const auto& property : property_group.GetProperties()) {
+    if (std::find(property_names.begin(), property_names.end(),
+                  property.name) != property_names.end()) {
+      selected.push_back(property.name);
+    }
+  }
+  return selected;
+}
+
+Result<PropertyPosition> GetPropertyPosition(
+    const std::vector<PropertyGroup>& property_groups,
+    const std::string& property,
+    const std::vector<std::string>& property_names) noexcept {
+  PropertyPosition position;
+  int group_index = 0, slot = 0;
+  for (const auto& pg : property_groups) {
+    std::vector<std::string> columns;
+    if (property_names.empty()) {
+      for (const auto& p : pg.GetProperties()) {
+        columns.push_back(p.name);
+      }
+    } else {
+      columns = GetSelectedProperties(pg, property_names);
+      if (columns.empty()) {
+        continue;  // the property group is not read
+      }
+    }
+    auto it = std::find(columns.begin(), columns.end(), property);
+    if (it != columns.end()) {
+      position.group_index = group_index;
+      position.column_index = static_cast<int>(it - columns.begin());
+      position.slot = slot + position.column_index;
+      return position;
+    }
+    ++group_index;
+    slot += static_cast<int>(columns.size());
+  }
+  return Status::KeyError("The property " + property + " is not read.");
+}
+
+Result<std::vector<IdType>> GetEdgeChunkNums(
+    const EdgeInfo& edge_info, const std::string& prefix,
+    AdjListType adj_list_type) noexcept {
+  std::string base_dir;
+  GAR_ASSIGN_OR_RAISE(auto fs, FileSystemFromUriOrPath(prefix, &base_dir));
+  GAR_ASSIGN_OR_RAISE(auto adj_list_path_prefix,
+                      edge_info.GetAdjListPathPrefix(adj_list_type));
+  GAR_ASSIGN_OR_RAISE(auto manifest,
+                      ChunkManifest::Make(fs, base_dir + adj_list_path_prefix));
+  return manifest->GetChunkNums();
+}
+
+Result<std::vector<IdType>> GetEdgeNums(const EdgeInfo& edge_info,
+                                        const std::string& prefix,
+                                        AdjListType adj_list_type) noexcept {
+  std::string base_dir;
+  GAR_ASSIGN_OR_RAISE(auto fs, FileSystemFromUriOrPath(prefix, &base_dir));
+  GAR_ASSIGN_OR_RAISE(auto adj_list_path_prefix,
+                      edge_info.GetAdjListPathPrefix(adj_list_type));
+  GAR_ASSIGN_OR_RAISE(auto manifest,
+                      ChunkManifest::Make(fs, base_dir + adj_list_path_prefix));
+  return GetEdgeNums(edge_info, fs, base_dir, adj_list_type, manifest);
+}
+
+Result<std::vector<IdType>> GetEdgeNums(
+    const EdgeInfo& edge_info, const std::shared_ptr<FileSystem>& fs,
+    const std::string& base_dir, AdjListType adj_list_type,
+    const std::shared_ptr<ChunkManifest>& manifest) noexcept {
+  if (manifest->HasStatistics()) {
+    return manifest->GetRowNums();
+  }
+  GAR_ASSIGN_OR_RAISE(auto chunk_nums, manifest->GetChunkNums());
+  // all the edge chunks but the last of a vertex chunk are full
+  GAR_ASSIGN_OR_RAISE(auto file_type, edge_info.GetFileType(adj_list_type));
+  std::vector<IdType> edge_nums(chunk_nums.size(), 0);
+  for (size_t i = 0; i < chunk_nums.size(); ++i) {
+    if (chunk_nums[i] == 0) {
+      continue;
+    }
+    GAR_ASSIGN_OR_RAISE(auto chunk_file_path,
+                        edge_info.GetAdjListFilePath(i, chunk_nums[i] - 1,
+                                                     adj_list_type));
+    GAR_ASSIGN_OR_RAISE(
+        auto row_num,
+        fs->GetRowNumOfFile(base_dir + chunk_file_path, file_type));
+    edge_nums[i] = (chunk_nums[i] - 1) * edge_info.GetChunkSize() + row_num;
+  }
+  return edge_nums;
+}
+
 /**
  * @brief parse the vertex id to related adj list offset
  *
@@ -60,7 +261,7 @@ Result<std::pair<IdType, IdType>> GetAdjListOffsetOfVertex(
   GAR_ASSIGN_OR_RAISE(auto fs, FileSystemFromUriOrPath(prefix, &out_prefix));
   GAR_ASSIGN_OR_RAISE(auto file_type, edge_info.GetFileType(adj_list_type));
   std::string path = out_prefix + offset_file_path;
-  GAR_ASSIGN_OR_RAISE(auto table, fs->ReadFileToTable(path, file_type));
+  GAR_ASSIGN_OR_RAISE(auto table, ReadChunkTable(fs, path, file_type));
   auto array = std::static_pointer_cast<arrow::Int64Array>(
       table->column(0)->Slice(offset_in_file, 2)->chunk(0));
   return std::make_pair(static_cast<IdType>(array->Value(0)),
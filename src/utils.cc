@@ -91,6 +91,30 @@ Result<const void*> GetArrowArrayData(
   }
 }
 
+Status LoadColumnCursor(std::shared_ptr<arrow::Table> const& chunk_table,
+                        int64_t offset, int column_index,
+                        const std::string& name, ColumnCursor* cursor) {
+  if (column_index < 0 || column_index >= chunk_table->num_columns() ||
+      chunk_table->schema()->field(column_index)->name() != name) {
+    column_index = chunk_table->schema()->GetFieldIndex(name);
+    if (column_index < 0) {
+      return Status::KeyError("The property " + name + " is not exist.");
+    }
+  }
+  auto column = chunk_table->column(column_index);
+  for (const auto& array : column->chunks()) {
+    if (array->length() > 0) {
+      GAR_ASSIGN_OR_RAISE(cursor->data, GetArrowArrayData(array));
+      cursor->array = array;
+      cursor->begin = offset;
+      cursor->end = offset + array->length();
+      return Status::OK();
+    }
+  }
+  return Status::KeyError("The row " + std::to_string(offset) +
+                          " is not exist.");
+}
+
 std::string ValueGetter<std::string>::Value(const void* data, int64_t offset) {
   return std::string(
       reinterpret_cast<const arrow::StringArray*>(data)->GetView(offset));
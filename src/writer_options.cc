@@ -0,0 +1,43 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "arrow/api.h"
+#include "arrow/util/compression.h"
+
+#include "gar/utils/writer_options.h"
+
+namespace GAR_NAMESPACE_INTERNAL {
+
+Status WriterOptions::Validate() const noexcept {
+  if (!compression.empty()) {
+    auto maybe_type = arrow::util::Codec::GetCompressionType(compression);
+    if (!maybe_type.ok()) {
+      return Status::Invalid("The compression codec " + compression +
+                             " is unknown.");
+    }
+    if (!arrow::util::Codec::IsAvailable(maybe_type.ValueOrDie())) {
+      return Status::Invalid("The compression codec " + compression +
+                             " is not built into Arrow.");
+    }
+  }
+#if !defined(ARROW_VERSION) || ARROW_VERSION < 12000000
+  if (page_index.value_or(false)) {
+    return Status::Invalid("The page index requires Arrow 12 or later.");
+  }
+#endif
+  return Status::OK();
+}
+
+}  // namespace GAR_NAMESPACE_INTERNAL
@@ -13,7 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include <cstdlib>
+#include <thread>
 
 #include "arrow/adapters/orc/adapter.h"
 #include "arrow/api.h"
@@ -26,6 +28,7 @@ limitations under the License.
 
 #include "./config.h"
 #include "gar/reader/arrow_chunk_reader.h"
+#include "gar/utils/chunk_cache.h"
 #include "gar/writer/arrow_chunk_writer.h"
 
 #define CATCH_CONFIG_MAIN
@@ -231,3 +234,281 @@ TEST_CASE("test_read_adj_list_offset_chunk_example") {
   REQUIRE(reader.next_chunk().IsOutOfRange());
   REQUIRE(reader.seek(1024).IsKeyError());
 }
+
+TEST_CASE("test_offset_index") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto maybe_graph_info = GAR_NAMESPACE::GraphInfo::Load(path);
+  REQUIRE(maybe_graph_info.status().ok());
+  auto graph_info = maybe_graph_info.value();
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto edge_info =
+      graph_info.GetEdgeInfo(src_label, edge_label, dst_label).value();
+
+  // only ordered adj lists have offsets
+  REQUIRE(GAR_NAMESPACE::OffsetIndex::Make(
+              edge_info, GAR_NAMESPACE::AdjListType::unordered_by_source,
+              graph_info.GetPrefix())
+              .status()
+              .IsInvalid());
+  auto maybe_index = GAR_NAMESPACE::OffsetIndex::Make(
+      edge_info, GAR_NAMESPACE::AdjListType::ordered_by_source,
+      graph_info.GetPrefix());
+  REQUIRE(maybe_index.status().ok());
+  auto index = maybe_index.value();
+  REQUIRE(index->GetVertexChunkNum() == 10);
+
+  // the ranges match the offset chunks
+  auto reader = GAR_NAMESPACE::ConstructAdjListOffsetArrowChunkReader(
+                    graph_info, src_label, edge_label, dst_label,
+                    GAR_NAMESPACE::AdjListType::ordered_by_source)
+                    .value();
+  for (GAR_NAMESPACE::IdType id : {0, 1, 99, 100, 555, 902}) {
+    REQUIRE(reader.seek(id).ok());
+    auto array = std::static_pointer_cast<arrow::Int64Array>(
+        reader.GetChunk().value());
+    auto maybe_range = index->GetOffsetRange(id);
+    REQUIRE(maybe_range.status().ok());
+    REQUIRE(maybe_range.value().first == array->Value(0));
+    REQUIRE(maybe_range.value().second == array->Value(1));
+  }
+  // the cold chunks are loaded concurrently by the lookups of other threads
+  auto concurrent_index =
+      GAR_NAMESPACE::OffsetIndex::Make(
+          edge_info, GAR_NAMESPACE::AdjListType::ordered_by_source,
+          graph_info.GetPrefix())
+          .value();
+  std::vector<std::thread> threads;
+  std::vector<int> matched(20, 0);
+  for (int t = 0; t < 20; ++t) {
+    threads.emplace_back([&, t]() {
+      GAR_NAMESPACE::IdType id = (t % 10) * 100 + t / 10;
+      auto range = concurrent_index->GetOffsetRange(id);
+      matched[t] = range.status().ok() &&
+                   range.value() == index->GetOffsetRange(id).value();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  REQUIRE(std::all_of(matched.begin(), matched.end(),
+                      [](int m) { return m == 1; }));
+
+  REQUIRE(index->LoadAll().ok());
+  REQUIRE(index->GetOffsetRange(1024).status().IsKeyError());
+  REQUIRE(index->GetOffsetRange(-1).status().IsKeyError());
+
+  // the number of vertex chunks is taken from a manifest file without listing
+  // the offset directory, which does not exist under the path prefix
+  std::string path_prefix;
+  auto fs = GAR_NAMESPACE::FileSystemFromUriOrPath(graph_info.GetPrefix(),
+                                                   &path_prefix)
+                .value();
+  auto manifest = std::make_shared<GAR_NAMESPACE::ChunkManifest>(
+      std::vector<GAR_NAMESPACE::IdType>(4, 1));
+  REQUIRE(!manifest->IsListed());
+  auto recorded = GAR_NAMESPACE::OffsetIndex::Make(
+      edge_info, GAR_NAMESPACE::AdjListType::ordered_by_source, fs,
+      path_prefix + "not_exist/", manifest);
+  REQUIRE(recorded.status().ok());
+  REQUIRE(recorded.value()->GetVertexChunkNum() == 4);
+  REQUIRE(GAR_NAMESPACE::OffsetIndex::Make(
+              edge_info, GAR_NAMESPACE::AdjListType::ordered_by_source, fs,
+              path_prefix + "not_exist/")
+              .has_error());
+}
+
+TEST_CASE("test_chunk_cache") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto maybe_graph_info = GAR_NAMESPACE::GraphInfo::Load(path);
+  REQUIRE(maybe_graph_info.status().ok());
+  auto graph_info = maybe_graph_info.value();
+  std::string label = "person", property_name = "id";
+  auto maybe_group = graph_info.GetVertexPropertyGroup(label, property_name);
+  REQUIRE(maybe_group.status().ok());
+  auto group = maybe_group.value();
+  auto maybe_reader = GAR_NAMESPACE::ConstructVertexPropertyArrowChunkReader(
+      graph_info, label, group);
+  REQUIRE(maybe_reader.status().ok());
+  auto reader = maybe_reader.value();
+
+  auto& cache = GAR_NAMESPACE::ChunkCache::Global();
+  cache.Clear();
+  cache.ResetStats();
+
+  // the first access of a chunk is a miss
+  REQUIRE(!reader.GetChunk().has_error());
+  REQUIRE(reader.seek(100).ok());
+  REQUIRE(!reader.GetChunk().has_error());
+  auto stats = cache.GetStats();
+  REQUIRE(stats.misses == 2);
+  REQUIRE(stats.hits == 0);
+  REQUIRE(stats.num_entries == 2);
+  REQUIRE(stats.size > 0);
+
+  // seeking back to a loaded chunk is served from the cache, also for other
+  // readers of the same chunk
+  REQUIRE(reader.seek(0).ok());
+  auto table = reader.GetChunk().value();
+  REQUIRE(table->num_rows() == 100);
+  auto other_reader = maybe_reader.value();
+  REQUIRE(!other_reader.GetChunk().has_error());
+  stats = cache.GetStats();
+  REQUIRE(stats.misses == 2);
+  REQUIRE(stats.hits == 2);
+
+  // a capacity of 0 disables the cache
+  cache.SetCapacity(0);
+  stats = cache.GetStats();
+  REQUIRE(stats.num_entries == 0);
+  REQUIRE(stats.evictions == 2);
+  REQUIRE(reader.seek(100).ok());
+  REQUIRE(!reader.GetChunk().has_error());
+  REQUIRE(cache.GetStats().num_entries == 0);
+  cache.SetCapacity(GAR_NAMESPACE::ChunkCache::kDefaultCapacity);
+  cache.ResetStats();
+}
+
+TEST_CASE("test_prefetch") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  std::string label = "person", property_name = "id";
+  auto group =
+      graph_info.GetVertexPropertyGroup(label, property_name).value();
+  auto maybe_reader = GAR_NAMESPACE::ConstructVertexPropertyArrowChunkReader(
+      graph_info, label, group);
+  REQUIRE(maybe_reader.status().ok());
+  auto reader = maybe_reader.value();
+  auto expect_reader = maybe_reader.value();
+
+  auto& cache = GAR_NAMESPACE::ChunkCache::Global();
+  cache.Clear();
+  cache.ResetStats();
+
+  // loading a chunk reads the next chunks ahead
+  reader.SetPrefetchDepth(2);
+  REQUIRE(!reader.GetChunk().has_error());
+  auto stats = cache.GetStats();
+  REQUIRE(stats.misses == 1);
+  REQUIRE(stats.prefetches == 2);
+
+  // the chunks read ahead are not read again, chunks already cached or being
+  // loaded are not read ahead again
+  REQUIRE(reader.next_chunk().ok());
+  auto table = reader.GetChunk().value();
+  stats = cache.GetStats();
+  REQUIRE(stats.misses == 1);
+  REQUIRE(stats.hits == 1);
+  REQUIRE(stats.prefetches == 3);
+  cache.SetCapacity(0);
+  REQUIRE(expect_reader.seek(100).ok());
+  REQUIRE(table->Equals(*expect_reader.GetChunk().value()));
+
+  // no read-ahead past the last chunk, or without cache capacity
+  cache.SetCapacity(GAR_NAMESPACE::ChunkCache::kDefaultCapacity);
+  cache.ResetStats();
+  REQUIRE(reader.seek((reader.GetChunkNum() - 1) * 100).ok());
+  REQUIRE(!reader.GetChunk().has_error());
+  REQUIRE(cache.GetStats().prefetches == 0);
+  cache.SetCapacity(0);
+  REQUIRE(reader.seek(0).ok());
+  REQUIRE(!reader.GetChunk().has_error());
+  REQUIRE(cache.GetStats().prefetches == 0);
+  cache.SetCapacity(GAR_NAMESPACE::ChunkCache::kDefaultCapacity);
+  cache.ResetStats();
+}
+
+TEST_CASE("test_row_group_seek") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  std::string label = "person", property_name = "id";
+  auto vertex_info = graph_info.GetVertexInfo(label).value();
+  auto group =
+      graph_info.GetVertexPropertyGroup(label, property_name).value();
+
+  // write a vertex chunk with row groups of 16 rows
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < 100; ++i) {
+    REQUIRE(builder.Append(i).ok());
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(property_name, arrow::int64())}),
+      {builder.Finish().ValueOrDie()});
+  std::string prefix = "/tmp/gar_row_group_test/";
+  GAR_NAMESPACE::VertexPropertyWriter writer(vertex_info, prefix);
+  writer.SetRowGroupSize(16);
+  REQUIRE(writer.GetRowGroupSize() == 16);
+  REQUIRE(writer.WriteChunk(table, group, 0).ok());
+
+  // only the row groups from the one that contains the row are read
+  std::string out_prefix;
+  auto fs = GAR_NAMESPACE::FileSystemFromUriOrPath(prefix, &out_prefix).value();
+  std::string chunk_path =
+      out_prefix + vertex_info.GetFilePath(group, 0).value();
+  auto chunk = fs->ReadFileToTableFromRow(
+                     chunk_path, GAR_NAMESPACE::FileType::PARQUET, 40)
+                   .value();
+  REQUIRE(chunk.second == 32);
+  REQUIRE(chunk.first->num_rows() == 68);
+  auto row_nums =
+      fs->GetRowGroupRowNums(chunk_path, GAR_NAMESPACE::FileType::PARQUET)
+          .value();
+  REQUIRE(row_nums.size() == 7);
+  REQUIRE(row_nums.back() == 4);
+  auto row_groups = fs->ReadFileRowGroups(chunk_path,
+                                          GAR_NAMESPACE::FileType::PARQUET,
+                                          {0, 6})
+                        .value();
+  REQUIRE(row_groups.size() == 2);
+  REQUIRE(row_groups[0]->num_rows() == 16);
+  REQUIRE(row_groups[1]->num_rows() == 4);
+
+  auto& cache = GAR_NAMESPACE::ChunkCache::Global();
+  cache.Clear();
+  GAR_NAMESPACE::VertexPropertyArrowChunkReader reader(vertex_info, group,
+                                                       prefix);
+  REQUIRE(reader.seek(40).ok());
+  auto result = reader.GetChunk();
+  REQUIRE(!result.has_error());
+  REQUIRE(result.value()->num_rows() == 60);
+  auto column = std::static_pointer_cast<arrow::Int64Array>(
+      result.value()->column(0)->chunk(0));
+  REQUIRE(column->Value(0) == 40);
+  auto range = reader.GetRange().value();
+  REQUIRE(range.first == 40);
+  REQUIRE(range.second == 100);
+  // the row group numbers and the row groups 2 to 6 are cached separately
+  REQUIRE(cache.GetStats().num_entries == 6);
+
+  // seeking into the row groups read decodes nothing
+  REQUIRE(reader.seek(50).ok());
+  result = reader.GetChunk();
+  REQUIRE(!result.has_error());
+  REQUIRE(result.value()->num_rows() == 50);
+  column = std::static_pointer_cast<arrow::Int64Array>(
+      result.value()->column(0)->chunk(0));
+  REQUIRE(column->Value(0) == 50);
+  GAR_NAMESPACE::VertexPropertyArrowChunkReader other_reader(vertex_info, group,
+                                                             prefix);
+  REQUIRE(other_reader.seek(70).ok());
+  auto hits = cache.GetStats().hits;
+  auto misses = cache.GetStats().misses;
+  REQUIRE(other_reader.GetChunk().value()->num_rows() == 30);
+  REQUIRE(cache.GetStats().misses == misses);
+  REQUIRE(cache.GetStats().hits > hits);
+  REQUIRE(cache.GetStats().num_entries == 6);
+
+  // seeking before the rows read reads the chunk again
+  REQUIRE(reader.seek(10).ok());
+  result = reader.GetChunk();
+  REQUIRE(!result.has_error());
+  REQUIRE(result.value()->num_rows() == 90);
+  column = std::static_pointer_cast<arrow::Int64Array>(
+      result.value()->column(0)->chunk(0));
+  REQUIRE(column->Value(0) == 10);
+  REQUIRE(cache.GetStats().num_entries == 7);
+  cache.Clear();
+}
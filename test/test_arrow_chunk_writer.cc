@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 */
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -26,9 +27,12 @@ limitations under the License.
 #include "arrow/util/uri.h"
 #include "parquet/arrow/reader.h"
 #include "parquet/arrow/writer.h"
+#include "parquet/file_reader.h"
+#include "parquet/metadata.h"
 
 #include "./config.h"
 #include "gar/graph_info.h"
+#include "gar/utils/filesystem.h"
 #include "gar/writer/arrow_chunk_writer.h"
 
 #define CATCH_CONFIG_MAIN
@@ -66,6 +70,9 @@ TEST_CASE("test_vertex_property_wrtier_from_file") {
   auto vertex_info = GAR_NAMESPACE::VertexInfo::Load(vertex_meta).value();
   REQUIRE(vertex_info.GetLabel() == "person");
   GAR_NAMESPACE::VertexPropertyWriter writer(vertex_info, "/tmp/");
+  // the reference chunks are written serially
+  writer.SetNumThreads(1);
+  REQUIRE(writer.GetNumThreads() == 1);
   REQUIRE(writer.WriteTable(table, 0).ok());
   REQUIRE(writer.WriteVerticesNum(table->num_rows()).ok());
 
@@ -73,6 +80,71 @@ TEST_CASE("test_vertex_property_wrtier_from_file") {
   auto num = input->Read(sizeof(GAR_NAMESPACE::IdType)).ValueOrDie();
   GAR_NAMESPACE::IdType* ptr = (GAR_NAMESPACE::IdType*) num->data();
   REQUIRE((*ptr) == table->num_rows());
+
+  // the chunks written on multiple threads are the same as written serially
+  auto gar_fs = GAR_NAMESPACE::FileSystemFromUriOrPath("/tmp/").value();
+  GAR_NAMESPACE::VertexPropertyWriter parallel_writer(vertex_info,
+                                                      "/tmp/parallel/");
+  parallel_writer.SetNumThreads(4);
+  REQUIRE(parallel_writer.GetNumThreads() == 4);
+  REQUIRE(parallel_writer.WriteTable(table, 0).ok());
+  int64_t chunk_num = (table->num_rows() + vertex_info.GetChunkSize() - 1) /
+                      vertex_info.GetChunkSize();
+  for (const auto& pg : vertex_info.GetPropertyGroups()) {
+    for (int64_t i = 0; i < chunk_num; ++i) {
+      auto suffix = vertex_info.GetFilePath(pg, i).value();
+      auto expected =
+          gar_fs->ReadFileToTable("/tmp/" + suffix, pg.GetFileType()).value();
+      auto written = gar_fs
+                         ->ReadFileToTable("/tmp/parallel/" + suffix,
+                                           pg.GetFileType())
+                         .value();
+      REQUIRE(written->Equals(*expected));
+    }
+  }
+
+  // the chunks are deleted if any of them fails
+  auto group = vertex_info.GetPropertyGroups().back();
+  int index = table->schema()->GetFieldIndex(
+      group.GetProperties().back().name);
+  auto missing = table->RemoveColumn(index).ValueOrDie();
+  GAR_NAMESPACE::VertexPropertyWriter failed_writer(vertex_info,
+                                                    "/tmp/failed/");
+  REQUIRE(failed_writer.WriteTable(missing, 0).IsInvalidOperation());
+  for (const auto& pg : vertex_info.GetPropertyGroups()) {
+    for (int64_t i = 0; i < chunk_num; ++i) {
+      auto suffix = vertex_info.GetFilePath(pg, i).value();
+      REQUIRE(gar_fs->GetFileSize("/tmp/failed/" + suffix).has_error());
+    }
+  }
+
+  // the chunks written from a stream of small batches are the same as
+  // written from the whole table
+  GAR_NAMESPACE::VertexStreamWriter stream_writer(vertex_info,
+                                                  "/tmp/stream/");
+  arrow::TableBatchReader batch_reader(*table);
+  batch_reader.set_chunksize(37);
+  REQUIRE(stream_writer.Write(&batch_reader).ok());
+  REQUIRE(stream_writer.GetVerticesNum() == table->num_rows());
+  REQUIRE(stream_writer.Finish().ok());
+  std::shared_ptr<arrow::RecordBatch> batch;
+  REQUIRE(arrow::TableBatchReader(*table).ReadNext(&batch).ok());
+  REQUIRE(stream_writer.Write(batch).IsInvalidOperation());
+  for (const auto& pg : vertex_info.GetPropertyGroups()) {
+    for (int64_t i = 0; i < chunk_num; ++i) {
+      auto suffix = vertex_info.GetFilePath(pg, i).value();
+      auto expected =
+          gar_fs->ReadFileToTable("/tmp/" + suffix, pg.GetFileType()).value();
+      auto written = gar_fs
+                         ->ReadFileToTable("/tmp/stream/" + suffix,
+                                           pg.GetFileType())
+                         .value();
+      REQUIRE(written->Equals(*expected));
+    }
+  }
+  auto stream_num = gar_fs->ReadFileToValue<GAR_NAMESPACE::IdType>(
+      "/tmp/stream/vertex/person/vertex_count");
+  REQUIRE(stream_num.value() == table->num_rows());
 }
 
 TEST_CASE("test_orc_and_parquet_reader") {
@@ -114,6 +186,42 @@ TEST_CASE("test_orc_and_parquet_reader") {
           table2->GetColumnByName("gender")->ToString());
 }
 
+TEST_CASE("test_writer_options_of_chunks") {
+  // write a vertex chunk of 100 rows in row groups of 16 rows with ZSTD
+  GAR_NAMESPACE::InfoVersion version(1);
+  GAR_NAMESPACE::Property p;
+  p.name = "id";
+  p.type = GAR_NAMESPACE::DataType(GAR_NAMESPACE::Type::INT64);
+  p.is_primary = true;
+  GAR_NAMESPACE::WriterOptions options;
+  options.compression = "zstd";
+  options.row_group_size = 16;
+  GAR_NAMESPACE::PropertyGroup pg({p}, GAR_NAMESPACE::FileType::PARQUET, "",
+                                  options);
+  GAR_NAMESPACE::VertexInfo vertex_info("person", 100, version);
+  REQUIRE(vertex_info.AddPropertyGroup(pg).ok());
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < 100; ++i) {
+    REQUIRE(builder.Append(i).ok());
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::int64())}),
+      {builder.Finish().ValueOrDie()});
+  GAR_NAMESPACE::VertexPropertyWriter writer(vertex_info, "/tmp/options/");
+  REQUIRE(writer.WriteTable(table, pg, 0).ok());
+
+  // the codec and the row groups are in the Parquet metadata
+  std::string path = "/tmp/options/" + vertex_info.GetFilePath(pg, 0).value();
+  auto file_reader = parquet::ParquetFileReader::OpenFile(path);
+  auto metadata = file_reader->metadata();
+  REQUIRE(metadata->num_rows() == 100);
+  REQUIRE(metadata->num_row_groups() == 7);
+  for (int i = 0; i < metadata->num_row_groups(); ++i) {
+    REQUIRE(metadata->RowGroup(i)->ColumnChunk(0)->compression() ==
+            arrow::Compression::ZSTD);
+  }
+}
+
 TEST_CASE("test_edge_chunk_writer") {
   arrow::Status st;
   arrow::MemoryPool* pool = arrow::default_memory_pool();
@@ -145,5 +253,144 @@ TEST_CASE("test_edge_chunk_writer") {
   auto edge_info = GAR_NAMESPACE::EdgeInfo::Load(edge_meta).value();
   GAR_NAMESPACE::EdgeChunkWriter writer(
       edge_info, "/tmp/", GAR_NAMESPACE::AdjListType::ordered_by_source);
+  // the reference chunks are written serially
+  writer.SetNumThreads(1);
+  REQUIRE(writer.GetNumThreads() == 1);
   REQUIRE(writer.SortAndWriteAdjListTable(table, 0, 0).ok());
+
+  // the chunks written on multiple threads are the same as written serially
+  auto adj_list_type = GAR_NAMESPACE::AdjListType::ordered_by_source;
+  auto file_type = edge_info.GetFileType(adj_list_type).value();
+  auto gar_fs = GAR_NAMESPACE::FileSystemFromUriOrPath("/tmp/").value();
+  GAR_NAMESPACE::EdgeChunkWriter parallel_writer(edge_info, "/tmp/parallel/",
+                                                 adj_list_type);
+  parallel_writer.SetNumThreads(4);
+  REQUIRE(parallel_writer.GetNumThreads() == 4);
+  REQUIRE(parallel_writer.SortAndWriteAdjListTable(table, 0, 0).ok());
+  std::vector<std::string> suffixes = {
+      edge_info.GetAdjListOffsetFilePath(0, adj_list_type).value()};
+  int64_t chunk_num = (table->num_rows() + edge_info.GetChunkSize() - 1) /
+                      edge_info.GetChunkSize();
+  for (int64_t i = 0; i < chunk_num; ++i) {
+    suffixes.push_back(
+        edge_info.GetAdjListFilePath(0, i, adj_list_type).value());
+  }
+  for (const auto& suffix : suffixes) {
+    auto expected = gar_fs->ReadFileToTable("/tmp/" + suffix, file_type);
+    auto written =
+        gar_fs->ReadFileToTable("/tmp/parallel/" + suffix, file_type);
+    REQUIRE(written.value()->Equals(*expected.value()));
+  }
+
+  // the chunks merged from the spilled sorted runs are the same as sorted in
+  // memory, from both a table and a stream
+  GAR_NAMESPACE::EdgeChunkWriter external_writer(edge_info, "/tmp/external/",
+                                                 adj_list_type);
+  std::string spill_dir = "/tmp/gar_spill/";
+  std::filesystem::create_directories(spill_dir);
+  external_writer.SetSortMemoryLimit(4 * 1024);
+  external_writer.SetSpillDirectory(spill_dir);
+  // the merged chunks are buffered and written a chunk per thread at a time
+  external_writer.SetNumThreads(4);
+  REQUIRE(external_writer.GetSortMemoryLimit() == 4 * 1024);
+  REQUIRE(external_writer.SortAndWriteAdjListTable(table, 0, 0).ok());
+  GAR_NAMESPACE::EdgeChunkWriter stream_writer(edge_info, "/tmp/stream/",
+                                               adj_list_type);
+  stream_writer.SetSortMemoryLimit(4 * 1024);
+  stream_writer.SetSpillDirectory(spill_dir);
+  arrow::TableBatchReader batch_reader(*table);
+  batch_reader.set_chunksize(100);
+  REQUIRE(stream_writer.SortAndWriteAdjListTable(&batch_reader, 0, 0).ok());
+  for (const auto& suffix : suffixes) {
+    auto expected = gar_fs->ReadFileToTable("/tmp/" + suffix, file_type);
+    for (const std::string dir : {"/tmp/external/", "/tmp/stream/"}) {
+      auto written = gar_fs->ReadFileToTable(dir + suffix, file_type);
+      REQUIRE(written.value()->Equals(*expected.value()));
+    }
+  }
+  // the spilled runs are removed after the merge
+  REQUIRE(std::filesystem::is_empty(spill_dir));
+
+  // the chunks are deleted if any of them fails, the table has no properties
+  GAR_NAMESPACE::EdgeChunkWriter failed_writer(edge_info, "/tmp/failed/",
+                                               adj_list_type);
+  REQUIRE(failed_writer.WriteTable(table, 0, 0).IsInvalidOperation());
+  for (const auto& suffix : suffixes) {
+    REQUIRE(gar_fs->GetFileSize("/tmp/failed/" + suffix).has_error());
+  }
+}
+
+TEST_CASE("test_edge_chunk_writer_merge_with_properties") {
+  // the edges of vertex chunk 0 with a property, in edge chunks of 64 rows
+  std::ifstream fp(TEST_DATA_DIR +
+                   "/ldbc_sample/parquet/person_knows_person.edge.yml");
+  std::string edge_meta((std::istreambuf_iterator<char>(fp)),
+                        std::istreambuf_iterator<char>());
+  edge_meta.replace(edge_meta.find("chunk_size: 1024"), 16, "chunk_size: 64");
+  auto edge_info = GAR_NAMESPACE::EdgeInfo::Load(
+                       GAR_NAMESPACE::Yaml::Load(edge_meta).value())
+                       .value();
+  auto adj_list_type = GAR_NAMESPACE::AdjListType::ordered_by_source;
+  auto file_type = edge_info.GetFileType(adj_list_type).value();
+  const auto& property_groups =
+      edge_info.GetPropertyGroups(adj_list_type).value();
+  REQUIRE(!property_groups.empty());
+  arrow::Int64Builder src_builder, dst_builder;
+  arrow::StringBuilder date_builder;
+  for (int64_t i = 0; i < 1000; ++i) {
+    int64_t src = (i * 37) % edge_info.GetSrcChunkSize();
+    int64_t dst = (i * 11) % 903;
+    REQUIRE(src_builder.Append(src).ok());
+    REQUIRE(dst_builder.Append(dst).ok());
+    REQUIRE(date_builder.Append("2010-01-" + std::to_string(i % 28 + 1)).ok());
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field(GAR_NAMESPACE::GeneralParams::kSrcIndexCol,
+                        arrow::int64()),
+           arrow::field(GAR_NAMESPACE::GeneralParams::kDstIndexCol,
+                        arrow::int64()),
+           arrow::field("creationDate", arrow::utf8())}),
+      {src_builder.Finish().ValueOrDie(), dst_builder.Finish().ValueOrDie(),
+       date_builder.Finish().ValueOrDie()});
+
+  // sorted in memory
+  GAR_NAMESPACE::EdgeChunkWriter writer(edge_info, "/tmp/merge_reference/",
+                                        adj_list_type);
+  REQUIRE(writer.SortAndWriteTable(table, 0, 0).ok());
+
+  // merged from the spilled sorted runs of a stream
+  std::string spill_dir = "/tmp/gar_merge_spill/";
+  std::filesystem::create_directories(spill_dir);
+  GAR_NAMESPACE::EdgeChunkWriter merge_writer(edge_info, "/tmp/merge/",
+                                              adj_list_type);
+  merge_writer.SetSortMemoryLimit(4 * 1024);
+  merge_writer.SetSpillDirectory(spill_dir);
+  merge_writer.SetNumThreads(2);
+  arrow::TableBatchReader batch_reader(*table);
+  batch_reader.set_chunksize(100);
+  REQUIRE(merge_writer.SortAndWriteTable(&batch_reader, 0, 0).ok());
+  REQUIRE(std::filesystem::is_empty(spill_dir));
+
+  // the adj list, offset and property chunks are the same
+  auto gar_fs = GAR_NAMESPACE::FileSystemFromUriOrPath("/tmp/").value();
+  std::vector<std::string> suffixes = {
+      edge_info.GetAdjListOffsetFilePath(0, adj_list_type).value()};
+  int64_t chunk_num = (table->num_rows() + edge_info.GetChunkSize() - 1) /
+                      edge_info.GetChunkSize();
+  REQUIRE(chunk_num > 1);
+  for (int64_t i = 0; i < chunk_num; ++i) {
+    suffixes.push_back(
+        edge_info.GetAdjListFilePath(0, i, adj_list_type).value());
+    for (const auto& pg : property_groups) {
+      suffixes.push_back(
+          edge_info.GetPropertyFilePath(pg, adj_list_type, 0, i).value());
+    }
+  }
+  for (const auto& suffix : suffixes) {
+    auto expected =
+        gar_fs->ReadFileToTable("/tmp/merge_reference/" + suffix, file_type);
+    auto written = gar_fs->ReadFileToTable("/tmp/merge/" + suffix, file_type);
+    REQUIRE(written.value()->Equals(*expected.value()));
+  }
 }
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include <time.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -29,7 +30,11 @@ limitations under the License.
 #include "parquet/arrow/writer.h"
 
 #include "./config.h"
+#include "gar/graph.h"
 #include "gar/graph_info.h"
+#include "gar/reader/arrow_chunk_reader.h"
+#include "gar/utils/chunk_manifest.h"
+#include "gar/utils/general_params.h"
 #include "gar/writer/arrow_chunk_writer.h"
 #include "gar/writer/edges_builder.h"
 #include "gar/writer/vertices_builder.h"
@@ -125,3 +130,238 @@ TEST_CASE("test_edges_builder") {
   std::cout << "Test edge builder" << std::endl;
   REQUIRE(builder.Dump().ok());
 }
+
+TEST_CASE("test_chunk_manifest") {
+  std::string edge_meta_file =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/" + "person_knows_person.edge.yml";
+  auto edge_meta = GAR_NAMESPACE::Yaml::LoadFile(edge_meta_file).value();
+  auto edge_info = GAR_NAMESPACE::EdgeInfo::Load(edge_meta).value();
+  std::string prefix = "/tmp/manifest/";
+  auto adj_list_type = GAR_NAMESPACE::AdjListType::ordered_by_dest;
+  GAR_NAMESPACE::builder::EdgesBuilder builder(edge_info, prefix,
+                                               adj_list_type, 903);
+  const int64_t edge_num = 3000;
+  for (int64_t i = 0; i < edge_num; i++) {
+    GAR_NAMESPACE::builder::Edge e(i % 903, (i * 5) % 903);
+    e.AddProperty("creationDate", std::string("2010-01-01"));
+    REQUIRE(builder.AddEdge(e).ok());
+  }
+  REQUIRE(builder.Dump().ok());
+
+  auto fs = GAR_NAMESPACE::FileSystemFromUriOrPath(prefix).value();
+  std::string dir_path =
+      prefix + edge_info.GetAdjListPathPrefix(adj_list_type).value();
+  auto file_type = edge_info.GetFileType(adj_list_type).value();
+  auto manifest = GAR_NAMESPACE::ChunkManifest::Make(fs, dir_path).value();
+  REQUIRE(manifest->HasStatistics());
+  REQUIRE(manifest->GetVertexChunkNum() == 10);
+  int64_t row_num = 0;
+  for (auto num : manifest->GetRowNums()) {
+    row_num += num;
+  }
+  REQUIRE(row_num == edge_num);
+  // the manifest agrees with the chunk files
+  auto listed =
+      GAR_NAMESPACE::ChunkManifest::Build(fs, dir_path, file_type).value();
+  REQUIRE(manifest->GetChunkNums().value() == listed->GetChunkNums().value());
+  REQUIRE(manifest->GetRowNums() == listed->GetRowNums());
+  REQUIRE(manifest->GetSizes() == listed->GetSizes());
+  for (const auto& pg : edge_info.GetPropertyGroups(adj_list_type).value()) {
+    auto pg_path_prefix =
+        edge_info.GetPropertyGroupPathPrefix(pg, adj_list_type).value();
+    std::string pg_dir_path = prefix + pg_path_prefix;
+    auto pg_manifest =
+        GAR_NAMESPACE::ChunkManifest::Make(fs, pg_dir_path).value();
+    REQUIRE(pg_manifest->HasStatistics());
+    REQUIRE(pg_manifest->GetRowNums() == manifest->GetRowNums());
+  }
+  // a manifest without the chunk numbers is rejected rather than taken as
+  // empty
+  std::string broken_dir_path = prefix + "broken/adj_list/";
+  REQUIRE(fs->WriteValueToFile(
+                std::string("row_nums: [1, 2]\n"),
+                GAR_NAMESPACE::ChunkManifest::GetPath(broken_dir_path))
+              .ok());
+  REQUIRE(GAR_NAMESPACE::ChunkManifest::Make(fs, broken_dir_path)
+              .status()
+              .IsYamlError());
+
+  // the readers walk the chunks recorded by the manifest
+  GAR_NAMESPACE::AdjListArrowChunkReader reader(edge_info, adj_list_type,
+                                                prefix);
+  row_num = 0;
+  while (true) {
+    auto result = reader.GetChunk();
+    REQUIRE(!result.has_error());
+    row_num += result.value()->num_rows();
+    auto st = reader.next_chunk();
+    if (st.IsOutOfRange()) {
+      break;
+    }
+  }
+  REQUIRE(row_num == edge_num);
+
+  // writing a chunk deletes the manifest of its directory, the readers list
+  // the chunks until the manifest is written again
+  auto chunk_num = manifest->GetChunkNum(0).value();
+  arrow::Int64Builder src_builder, dst_builder;
+  REQUIRE(src_builder.AppendValues({1, 2, 3}).ok());
+  REQUIRE(dst_builder.AppendValues({0, 0, 1}).ok());
+  auto extra_table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field(GAR_NAMESPACE::GeneralParams::kSrcIndexCol,
+                        arrow::int64()),
+           arrow::field(GAR_NAMESPACE::GeneralParams::kDstIndexCol,
+                        arrow::int64())}),
+      {src_builder.Finish().ValueOrDie(), dst_builder.Finish().ValueOrDie()});
+  GAR_NAMESPACE::EdgeChunkWriter writer(edge_info, prefix, adj_list_type);
+  REQUIRE(writer.WriteAdjListChunk(extra_table, 0, chunk_num).ok());
+  auto manifest_path = GAR_NAMESPACE::ChunkManifest::GetPath(dir_path);
+  REQUIRE(!fs->FileExists(manifest_path).value());
+  auto relisted = GAR_NAMESPACE::ChunkManifest::Make(fs, dir_path).value();
+  REQUIRE(!relisted->HasStatistics());
+  REQUIRE(relisted->GetChunkNum(0).value() == chunk_num + 1);
+  REQUIRE(writer.WriteManifest().ok());
+  REQUIRE(fs->FileExists(manifest_path).value());
+  auto rewritten = GAR_NAMESPACE::ChunkManifest::Make(fs, dir_path).value();
+  REQUIRE(rewritten->HasStatistics());
+  REQUIRE(rewritten->GetChunkNum(0).value() == chunk_num + 1);
+  REQUIRE(writer.WriteAdjListChunk(extra_table, 0, chunk_num).ok());
+  REQUIRE(!fs->FileExists(manifest_path).value());
+}
+
+TEST_CASE("test_zone_maps") {
+  std::string edge_meta_file =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/" + "person_knows_person.edge.yml";
+  auto edge_meta = GAR_NAMESPACE::Yaml::LoadFile(edge_meta_file).value();
+  auto edge_info = GAR_NAMESPACE::EdgeInfo::Load(edge_meta).value();
+  std::string prefix = "/tmp/zone_maps/";
+  auto adj_list_type = GAR_NAMESPACE::AdjListType::unordered_by_source;
+  GAR_NAMESPACE::builder::EdgesBuilder builder(edge_info, prefix,
+                                               adj_list_type, 903);
+  // the destinations are close to the sources, so that the zone maps of the
+  // destinations are narrow
+  const int64_t edge_num = 3000;
+  for (int64_t i = 0; i < edge_num; i++) {
+    int64_t src = i % 903;
+    GAR_NAMESPACE::builder::Edge e(src, std::min<int64_t>(902, src + i % 3));
+    e.AddProperty("creationDate", std::string("2010-01-01"));
+    REQUIRE(builder.AddEdge(e).ok());
+  }
+  REQUIRE(builder.Dump().ok());
+
+  // the zone maps agree with the chunks
+  auto fs = GAR_NAMESPACE::FileSystemFromUriOrPath(prefix).value();
+  std::string dir_path =
+      prefix + edge_info.GetAdjListPathPrefix(adj_list_type).value();
+  auto manifest = GAR_NAMESPACE::ChunkManifest::Make(fs, dir_path).value();
+  REQUIRE(manifest->HasZoneMaps());
+  const auto& zone_maps = manifest->GetZoneMaps();
+  GAR_NAMESPACE::AdjListArrowChunkReader reader(edge_info, adj_list_type,
+                                                prefix);
+  size_t chunk_index = 0;
+  while (true) {
+    auto table = reader.GetChunk().value();
+    REQUIRE(chunk_index < zone_maps.size());
+    const auto& zone_map = zone_maps[chunk_index++];
+    auto src = std::static_pointer_cast<arrow::Int64Array>(
+        table->GetColumnByName(GAR_NAMESPACE::GeneralParams::kSrcIndexCol)
+            ->chunk(0));
+    auto dst = std::static_pointer_cast<arrow::Int64Array>(
+        table->GetColumnByName(GAR_NAMESPACE::GeneralParams::kDstIndexCol)
+            ->chunk(0));
+    for (int64_t i = 0; i < table->num_rows(); ++i) {
+      REQUIRE(zone_map.MayContainSrc(src->Value(i)));
+      REQUIRE(zone_map.MayContainDst(dst->Value(i)));
+    }
+    if (reader.next_chunk().IsOutOfRange()) {
+      break;
+    }
+  }
+  REQUIRE(chunk_index == zone_maps.size());
+  REQUIRE(!zone_maps.front().MayContainDst(902));
+  // the zone maps collected at write time agree with the ones read back
+  auto file_type = edge_info.GetFileType(adj_list_type).value();
+  auto listed = GAR_NAMESPACE::ChunkManifest::Build(fs, dir_path, file_type,
+                                                    -1, true)
+                    .value();
+  REQUIRE(listed->GetZoneMaps().size() == zone_maps.size());
+  for (size_t i = 0; i < zone_maps.size(); ++i) {
+    const auto& expected = listed->GetZoneMaps()[i];
+    REQUIRE(zone_maps[i].src_min == expected.src_min);
+    REQUIRE(zone_maps[i].src_max == expected.src_max);
+    REQUIRE(zone_maps[i].dst_min == expected.dst_min);
+    REQUIRE(zone_maps[i].dst_max == expected.dst_max);
+  }
+
+  // the pruned lookups find the same edges as the full scan
+  GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::unordered_by_source>
+      edges(edge_info, prefix);
+  std::map<int64_t, int64_t> dst_count;
+  for (auto it = edges.begin(); it != edges.end(); ++it) {
+    ++dst_count[it.destination()];
+  }
+  for (int64_t id : {0, 1, 450, 901, 902}) {
+    int64_t count = 0;
+    auto it = edges.find_dst(id, edges.begin());
+    for (bool found = !it.is_end(); found; found = it.next_dst()) {
+      REQUIRE(it.destination() == id);
+      ++count;
+    }
+    REQUIRE(count == dst_count[id]);
+  }
+
+  // the lookups by the sorted id of the unordered adj lists jump to its
+  // vertex chunk, the lookups by the other id skip the chunks whose zone maps
+  // exclude it, so that the chunks of the other vertices are never read
+  auto dst_adj_list_type = GAR_NAMESPACE::AdjListType::unordered_by_dest;
+  if (!edge_info.ContainAdjList(dst_adj_list_type)) {
+    REQUIRE(edge_info
+                .AddAdjList(dst_adj_list_type,
+                            GAR_NAMESPACE::FileType::PARQUET)
+                .ok());
+  }
+  GAR_NAMESPACE::builder::EdgesBuilder dst_builder(edge_info, prefix,
+                                                   dst_adj_list_type, 903);
+  std::map<int64_t, int64_t> src_count;
+  for (int64_t i = 0; i < edge_num; i++) {
+    int64_t src = i % 903;
+    GAR_NAMESPACE::builder::Edge e(src, std::min<int64_t>(902, src + i % 3));
+    e.AddProperty("creationDate", std::string("2010-01-01"));
+    REQUIRE(dst_builder.AddEdge(e).ok());
+    ++src_count[src];
+  }
+  REQUIRE(dst_builder.Dump().ok());
+  GAR_NAMESPACE::EdgesCollection<GAR_NAMESPACE::AdjListType::unordered_by_dest>
+      dst_edges(edge_info, prefix);
+  auto src_begin = edges.begin();
+  auto dst_begin = dst_edges.begin();
+  for (auto type : {adj_list_type, dst_adj_list_type}) {
+    auto suffix = edge_info.GetAdjListFilePath(1, 0, type).value();
+    REQUIRE(fs->DeleteFile(prefix + suffix).ok());
+  }
+  for (int64_t id : {850, 901, 902}) {
+    int64_t count = 0;
+    auto it = edges.find_src(id, src_begin);
+    for (bool found = !it.is_end(); found; found = it.next_src()) {
+      REQUIRE(it.source() == id);
+      ++count;
+    }
+    REQUIRE(count == src_count[id]);
+    count = 0;
+    it = dst_edges.find_src(id, dst_begin);
+    for (bool found = !it.is_end(); found; found = it.next_src()) {
+      REQUIRE(it.source() == id);
+      ++count;
+    }
+    REQUIRE(count == src_count[id]);
+    count = 0;
+    it = dst_edges.find_dst(id, dst_begin);
+    for (bool found = !it.is_end(); found; found = it.next_dst()) {
+      REQUIRE(it.destination() == id);
+      ++count;
+    }
+    REQUIRE(count == dst_count[id]);
+  }
+}
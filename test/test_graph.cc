@@ -13,10 +13,27 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
 
+#include "arrow/api.h"
+#include "arrow/compute/api.h"
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 12000000
+#include "arrow/compute/expression.h"
+#else
+#include "arrow/compute/exec/expression.h"
+#endif
+
 #include "./config.h"
+#include "gar/csr.h"
+#include "gar/engine/bfs.h"
+#include "gar/engine/bsp_engine.h"
 #include "gar/graph.h"
+#include "gar/utils/general_params.h"
+#include "gar/writer/arrow_chunk_writer.h"
+#include "gar/writer/edges_builder.h"
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -85,3 +102,892 @@ TEST_CASE("test_edges_collection", "[Slow]") {
               << std::endl;
   }
 }
+
+TEST_CASE("test_element_views") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  auto vertices =
+      GAR_NAMESPACE::ConstructVerticesCollection(graph_info, "person").value();
+  for (auto it = vertices.begin(); it != vertices.end(); ++it) {
+    auto vertex = *it;
+    auto first_name = it.property<std::string>("firstName").value();
+    REQUIRE(vertex.property<std::string>("firstName").value() == first_name);
+    REQUIRE(vertex.property<std::string_view>("firstName").value() ==
+            first_name);
+    REQUIRE(vertex.property<int64_t>("id").value() ==
+            it.property<int64_t>("id").value());
+    REQUIRE(vertex.property<int32_t>("id").status().IsTypeError());
+    REQUIRE(vertex.property<int64_t>("not_exist").status().IsKeyError());
+  }
+
+  auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, "person", "knows", "person",
+      GAR_NAMESPACE::AdjListType::ordered_by_source, 0);
+  REQUIRE(!expect.has_error());
+  auto& edges = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value());
+  for (auto it = edges.begin(); it != edges.end(); ++it) {
+    auto edge = *it;
+    REQUIRE(edge.source() == it.source());
+    REQUIRE(edge.destination() == it.destination());
+    REQUIRE(edge.property<std::string_view>("creationDate").value() ==
+            it.property<std::string>("creationDate").value());
+    REQUIRE(edge.property<double>("creationDate").status().IsTypeError());
+  }
+
+  // the views stay at their elements after the iterators move or are gone
+  auto vertex_it = vertices.begin();
+  auto first_vertex = *vertex_it;
+  auto first_id = vertex_it.property<int64_t>("id").value();
+  ++vertex_it;
+  auto second_id = vertex_it.property<int64_t>("id").value();
+  REQUIRE(first_id != second_id);
+  REQUIRE(first_vertex.id() == 0);
+  REQUIRE(first_vertex.property<int64_t>("id").value() == first_id);
+  auto found_vertex = *vertices.find(1);
+  REQUIRE(found_vertex.property<int64_t>("id").value() == second_id);
+  auto edge_it = edges.begin();
+  auto first_edge = *edge_it;
+  auto first_dst = edge_it.destination();
+  auto first_date = edge_it.property<std::string>("creationDate").value();
+  for (size_t i = 0; i < 100; ++i) {
+    ++edge_it;
+  }
+  REQUIRE(first_edge.destination() == first_dst);
+  REQUIRE(first_edge.property<std::string>("creationDate").value() ==
+          first_date);
+}
+
+TEST_CASE("test_edge_collection_meta") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  auto edge_info = graph_info.GetEdgeInfo("person", "knows", "person").value();
+  auto adj_list_type = GAR_NAMESPACE::AdjListType::ordered_by_source;
+  auto maybe_meta = GAR_NAMESPACE::EdgeCollectionMeta::Make(
+      edge_info, adj_list_type, graph_info.GetPrefix());
+  REQUIRE(!maybe_meta.has_error());
+  std::shared_ptr<const GAR_NAMESPACE::EdgeCollectionMeta> meta =
+      maybe_meta.value();
+  REQUIRE(meta->property_manifests.size() ==
+          edge_info.GetPropertyGroups(adj_list_type).value().size());
+  REQUIRE(meta->offset_index != nullptr);
+  auto unordered_meta = GAR_NAMESPACE::EdgeCollectionMeta::Make(
+      edge_info, GAR_NAMESPACE::AdjListType::unordered_by_source,
+      graph_info.GetPrefix());
+  REQUIRE(!unordered_meta.has_error());
+  REQUIRE(unordered_meta.value()->offset_index == nullptr);
+  // the members given by the caller are kept instead of made again
+  auto given_meta = GAR_NAMESPACE::EdgeCollectionMeta::Make(
+      edge_info, adj_list_type, graph_info.GetPrefix(), meta->index_converter,
+      meta->offset_index);
+  REQUIRE(!given_meta.has_error());
+  REQUIRE(given_meta.value()->index_converter == meta->index_converter);
+  REQUIRE(given_meta.value()->offset_index == meta->offset_index);
+
+  // the iterators created from the shared metadata traverse the same edges
+  auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, "person", "knows", "person", adj_list_type);
+  REQUIRE(!expect.has_error());
+  auto& edges = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value());
+  auto chunk_num = meta->index_converter->GetChunkNum();
+  GAR_NAMESPACE::EdgeIter it(meta, 0, 0, 0, chunk_num, 0, 0);
+  GAR_NAMESPACE::EdgeIter end(meta, chunk_num, 0, 0, chunk_num, 0, 0);
+  size_t count = 0;
+  for (auto expect_it = edges.begin(); expect_it != edges.end();
+       ++expect_it, ++it, ++count) {
+    REQUIRE(it != end);
+    REQUIRE(it.source() == expect_it.source());
+    REQUIRE(it.destination() == expect_it.destination());
+    REQUIRE(it.property<std::string>("creationDate").value() ==
+            expect_it.property<std::string>("creationDate").value());
+  }
+  REQUIRE(it == end);
+  REQUIRE(count > 0);
+
+  // the copies share the metadata and keep their own positions
+  auto begin = edges.begin();
+  auto copy = begin;
+  ++copy;
+  REQUIRE(copy != begin);
+  REQUIRE(begin == edges.begin());
+  auto found = edges.find_src(begin.source(), begin);
+  REQUIRE(found == begin);
+}
+
+TEST_CASE("test_index_converter") {
+  // the vertex chunks without edge chunks are skipped
+  std::vector<GAR_NAMESPACE::IdType> edge_chunk_nums = {2, 0, 3, 1, 0, 0, 4};
+  auto chunk_nums = edge_chunk_nums;
+  GAR_NAMESPACE::util::IndexConverter converter(std::move(chunk_nums));
+  REQUIRE(converter.GetVertexChunkNum() == 7);
+  REQUIRE(converter.GetChunkNum() == 10);
+  GAR_NAMESPACE::IdType global_index = 0;
+  for (size_t i = 0; i < edge_chunk_nums.size(); ++i) {
+    for (GAR_NAMESPACE::IdType j = 0; j < edge_chunk_nums[i]; ++j) {
+      auto pair = converter.GlobalChunkIndexToIndexPair(global_index);
+      REQUIRE(pair.first == static_cast<GAR_NAMESPACE::IdType>(i));
+      REQUIRE(pair.second == j);
+      REQUIRE(converter.IndexPairToGlobalChunkIndex(i, j) == global_index);
+      REQUIRE(pair == GAR_NAMESPACE::util::GlobalChunkIndexToIndexPair(
+                          edge_chunk_nums, global_index));
+      ++global_index;
+    }
+  }
+  auto pair = converter.GlobalChunkIndexToIndexPair(10);
+  REQUIRE((pair.first == 0 && pair.second == 0));
+}
+
+TEST_CASE("test_edges_chunk_spans") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+
+  auto check = [](auto& edges) {
+    std::vector<GAR_NAMESPACE::IdType> src, dst;
+    auto end = edges.end();
+    for (auto it = edges.begin(); it != end; ++it) {
+      src.push_back(it.source());
+      dst.push_back(it.destination());
+    }
+    int64_t count = 0;
+    auto status =
+        edges.ForEachChunk([&](const GAR_NAMESPACE::AdjListSpan& span) {
+          REQUIRE(span.offset == count);
+          for (int64_t i = 0; i < span.size; ++i) {
+            REQUIRE(span.src[i] == src[span.offset + i]);
+            REQUIRE(span.dst[i] == dst[span.offset + i]);
+          }
+          count += span.size;
+          return GAR_NAMESPACE::Status::OK();
+        });
+    REQUIRE(status.ok());
+    REQUIRE(count == static_cast<int64_t>(src.size()));
+  };
+
+  auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_source);
+  REQUIRE(!expect.has_error());
+  check(std::get<GAR_NAMESPACE::EdgesCollection<
+            GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value()));
+  auto expect2 = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::unordered_by_dest, 1);
+  REQUIRE(!expect2.has_error());
+  check(std::get<GAR_NAMESPACE::EdgesCollection<
+            GAR_NAMESPACE::AdjListType::unordered_by_dest>>(expect2.value()));
+
+  // the iteration stops at the first error of the function
+  int chunks = 0;
+  auto status = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value())
+                    .ForEachChunk([&](const GAR_NAMESPACE::AdjListSpan&) {
+                      ++chunks;
+                      return GAR_NAMESPACE::Status::Invalid("stop");
+                    });
+  REQUIRE(status.IsInvalid());
+  REQUIRE(chunks == 1);
+}
+
+TEST_CASE("test_parallel_for_edges") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+
+  auto check = [](auto& edges, int num_threads) {
+    std::vector<GAR_NAMESPACE::IdType> src, dst;
+    auto status =
+        edges.ForEachChunk([&](const GAR_NAMESPACE::AdjListSpan& span) {
+          src.insert(src.end(), span.src, span.src + span.size);
+          dst.insert(dst.end(), span.dst, span.dst + span.size);
+          return GAR_NAMESPACE::Status::OK();
+        });
+    REQUIRE(status.ok());
+    // every edge is visited once, at its offset
+    std::vector<GAR_NAMESPACE::IdType> parallel_src(src.size(), -1);
+    std::vector<GAR_NAMESPACE::IdType> parallel_dst(dst.size(), -1);
+    std::atomic<int64_t> count(0);
+    status = GAR_NAMESPACE::ParallelForEdges(
+        edges,
+        [&](const GAR_NAMESPACE::AdjListSpan& span) {
+          if (span.offset + span.size > static_cast<int64_t>(src.size())) {
+            return GAR_NAMESPACE::Status::OutOfRange();
+          }
+          for (int64_t i = 0; i < span.size; ++i) {
+            parallel_src[span.offset + i] = span.src[i];
+            parallel_dst[span.offset + i] = span.dst[i];
+          }
+          count += span.size;
+          return GAR_NAMESPACE::Status::OK();
+        },
+        num_threads);
+    REQUIRE(status.ok());
+    REQUIRE(count == static_cast<int64_t>(src.size()));
+    REQUIRE(parallel_src == src);
+    REQUIRE(parallel_dst == dst);
+  };
+
+  auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_source);
+  REQUIRE(!expect.has_error());
+  auto& edges = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value());
+  check(edges, 4);
+  check(edges, 1);
+  auto expect2 = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::unordered_by_dest, 1);
+  REQUIRE(!expect2.has_error());
+  check(std::get<GAR_NAMESPACE::EdgesCollection<
+            GAR_NAMESPACE::AdjListType::unordered_by_dest>>(expect2.value()),
+        0);
+
+  // the scan stops at the first error
+  auto status = GAR_NAMESPACE::ParallelForEdges(
+      edges,
+      [](const GAR_NAMESPACE::AdjListSpan&) {
+        return GAR_NAMESPACE::Status::Invalid("stop");
+      },
+      4);
+  REQUIRE(status.IsInvalid());
+}
+
+TEST_CASE("test_load_csr") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+
+  auto check = [&](GAR_NAMESPACE::AdjListType adj_list_type,
+                   const GAR_NAMESPACE::CSROptions& options) {
+    std::vector<GAR_NAMESPACE::IdType> src, dst;
+    auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+        graph_info, src_label, edge_label, dst_label, adj_list_type);
+    REQUIRE(!expect.has_error());
+    auto status = std::visit(
+        [&](auto& edges) {
+          return edges.ForEachChunk(
+              [&](const GAR_NAMESPACE::AdjListSpan& span) {
+                src.insert(src.end(), span.src, span.src + span.size);
+                dst.insert(dst.end(), span.dst, span.dst + span.size);
+                return GAR_NAMESPACE::Status::OK();
+              });
+        },
+        expect.value());
+    REQUIRE(status.ok());
+
+    auto maybe_csr = GAR_NAMESPACE::LoadCSR(
+        graph_info, src_label, edge_label, dst_label, adj_list_type, options);
+    REQUIRE(!maybe_csr.has_error());
+    auto csr = maybe_csr.value();
+    REQUIRE(csr->GetEdgeNum() == static_cast<int64_t>(src.size()));
+    REQUIRE(csr->IsCompact() == options.compact_ids);
+    REQUIRE(csr->GetOffsets()[csr->GetVertexNum()] == csr->GetEdgeNum());
+    size_t i = 0;
+    for (auto it = csr->begin(); it != csr->end(); ++it, ++i) {
+      REQUIRE(it.source() == src[i]);
+      REQUIRE(it.destination() == dst[i]);
+    }
+    REQUIRE(i == src.size());
+
+    // the traversal methods match those of EdgeIter
+    auto it = csr->begin();
+    GAR_NAMESPACE::IdType id = src[src.size() / 2];
+    size_t count = 0;
+    for (bool found = it.first_src(csr->begin(), id); found;
+         found = it.next_src()) {
+      REQUIRE(it.source() == id);
+      ++count;
+    }
+    REQUIRE(count == static_cast<size_t>(std::count(src.begin(), src.end(),
+                                                    id)));
+  };
+
+  GAR_NAMESPACE::CSROptions options;
+  check(GAR_NAMESPACE::AdjListType::ordered_by_source, options);
+  check(GAR_NAMESPACE::AdjListType::ordered_by_dest, options);
+  options.compact_ids = false;
+  options.num_threads = 1;
+  check(GAR_NAMESPACE::AdjListType::ordered_by_source, options);
+  options.mmap_path = "/tmp/test_load_csr.bin";
+  check(GAR_NAMESPACE::AdjListType::ordered_by_dest, options);
+
+  // only the ordered adj lists can be loaded
+  auto maybe_csr = GAR_NAMESPACE::LoadCSR(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::unordered_by_source);
+  REQUIRE(maybe_csr.status().IsInvalid());
+}
+
+TEST_CASE("test_degrees") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  auto vertices =
+      GAR_NAMESPACE::ConstructVerticesCollection(graph_info, src_label)
+          .value();
+  auto vertex_num = vertices.size();
+
+  // the degrees counted from the edges
+  std::vector<int64_t> out_degrees(vertex_num, 0), in_degrees(vertex_num, 0);
+  auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_source);
+  REQUIRE(!expect.has_error());
+  auto& edges = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value());
+  auto status = edges.ForEachChunk([&](const GAR_NAMESPACE::AdjListSpan& span) {
+    for (int64_t i = 0; i < span.size; ++i) {
+      ++out_degrees[span.src[i]];
+      ++in_degrees[span.dst[i]];
+    }
+    return GAR_NAMESPACE::Status::OK();
+  });
+  REQUIRE(status.ok());
+
+  for (int num_threads : {0, 1}) {
+    auto maybe_out_degrees = GAR_NAMESPACE::GetOutDegrees(
+        graph_info, src_label, edge_label, dst_label, num_threads);
+    REQUIRE(!maybe_out_degrees.has_error());
+    auto out = std::static_pointer_cast<arrow::Int64Array>(
+        maybe_out_degrees.value());
+    REQUIRE(out->length() == static_cast<int64_t>(vertex_num));
+    REQUIRE(std::vector<int64_t>(out->raw_values(),
+                                 out->raw_values() + out->length()) ==
+            out_degrees);
+    auto maybe_in_degrees = GAR_NAMESPACE::GetInDegrees(
+        graph_info, src_label, edge_label, dst_label, num_threads);
+    REQUIRE(!maybe_in_degrees.has_error());
+    auto in = std::static_pointer_cast<arrow::Int64Array>(
+        maybe_in_degrees.value());
+    REQUIRE(std::vector<int64_t>(in->raw_values(),
+                                 in->raw_values() + in->length()) ==
+            in_degrees);
+  }
+}
+
+TEST_CASE("test_bsp_engine") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+
+  GAR_NAMESPACE::engine::BSPOptions options;
+  auto maybe_engine = GAR_NAMESPACE::engine::BSPEngine::Make(
+      graph_info, src_label, edge_label, dst_label, options);
+  REQUIRE(!maybe_engine.has_error());
+  auto engine = maybe_engine.value();
+  REQUIRE(engine->CanPush());
+  REQUIRE(engine->CanPull());
+  auto vertex_num = engine->GetVertexNum();
+
+  // the distances of a sequential bfs over the CSR
+  GAR_NAMESPACE::IdType root = 0;
+  std::vector<int32_t> expect(vertex_num, -1);
+  expect[root] = 0;
+  std::vector<GAR_NAMESPACE::IdType> queue = {root};
+  const auto& csr = *engine->GetOutEdges();
+  for (size_t i = 0; i < queue.size(); ++i) {
+    auto src = queue[i];
+    for (auto j = csr.GetOffsets()[src]; j < csr.GetOffsets()[src + 1]; ++j) {
+      auto dst = csr.GetNeighbor(j);
+      if (expect[dst] == -1) {
+        expect[dst] = expect[src] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+
+  auto bfs = [&](int mode) {
+    GAR_NAMESPACE::engine::VertexState<int32_t> state(vertex_num, -1);
+    state.Set(root, 0);
+    state.SetNext(root, 0);
+    GAR_NAMESPACE::engine::Frontier frontier(vertex_num);
+    frontier.Add(root);
+    while (!frontier.Empty()) {
+      auto update = [&](GAR_NAMESPACE::IdType src, GAR_NAMESPACE::IdType dst) {
+        return state.CompareAndSetNext(dst, -1, state.Get(src) + 1);
+      };
+      auto cond = [&](GAR_NAMESPACE::IdType dst) {
+        return state.GetNext(dst) == -1;
+      };
+      GAR_NAMESPACE::engine::Frontier next(vertex_num);
+      GAR_NAMESPACE::Status status;
+      if (mode == 0) {
+        status = engine->Push(frontier, update, cond, &next);
+      } else if (mode == 1) {
+        status = engine->Pull(frontier, update, cond, &next);
+      } else {
+        status = engine->EdgeMap(frontier, update, cond, &next);
+      }
+      REQUIRE(status.ok());
+      REQUIRE(engine
+                  ->ForEachVertex([&](GAR_NAMESPACE::IdType vid) {
+                    state.Set(vid, state.GetNext(vid));
+                  })
+                  .ok());
+      frontier = std::move(next);
+    }
+    return state.GetValues();
+  };
+  REQUIRE(bfs(0) == expect);
+  REQUIRE(bfs(1) == expect);
+  REQUIRE(bfs(2) == expect);
+
+  // a dense frontier is scanned by vertex chunk and listed on demand
+  auto full = GAR_NAMESPACE::engine::Frontier::Full(vertex_num);
+  REQUIRE(full.IsDense());
+  REQUIRE(full.Size() == vertex_num);
+  full.ToSparse();
+  REQUIRE(full.GetVertices().size() == static_cast<size_t>(vertex_num));
+
+  // write the results back as a new property
+  GAR_NAMESPACE::Property property = {
+      "bfs", GAR_NAMESPACE::DataType(GAR_NAMESPACE::Type::INT32), false};
+  GAR_NAMESPACE::PropertyGroup group({property},
+                                     GAR_NAMESPACE::FileType::PARQUET);
+  auto vertex_info =
+      graph_info.GetVertexInfo(src_label).value().Extend(group).value();
+  REQUIRE(GAR_NAMESPACE::engine::WriteVertexProperty(vertex_info, group,
+                                                     "/tmp/", expect)
+              .ok());
+  std::vector<int64_t> wrong_type(vertex_num, 0);
+  REQUIRE(GAR_NAMESPACE::engine::WriteVertexProperty(vertex_info, group,
+                                                     "/tmp/", wrong_type)
+              .IsTypeError());
+
+  // the engine runs on the edges between vertices of one label
+  REQUIRE(GAR_NAMESPACE::engine::BSPEngine::Make(graph_info, "person", "knows",
+                                                 "comment")
+              .status()
+              .IsInvalid());
+}
+
+TEST_CASE("test_direction_optimizing_bfs") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  auto engine = GAR_NAMESPACE::engine::BSPEngine::Make(graph_info, src_label,
+                                                       edge_label, dst_label)
+                    .value();
+  auto vertex_num = engine->GetVertexNum();
+
+  // the distances of a sequential bfs over the CSR
+  GAR_NAMESPACE::IdType root = 0;
+  std::vector<int32_t> expect(vertex_num, -1);
+  expect[root] = 0;
+  std::vector<GAR_NAMESPACE::IdType> queue = {root};
+  const auto& csr = *engine->GetOutEdges();
+  for (size_t i = 0; i < queue.size(); ++i) {
+    auto src = queue[i];
+    for (auto j = csr.GetOffsets()[src]; j < csr.GetOffsets()[src + 1]; ++j) {
+      auto dst = csr.GetNeighbor(j);
+      if (expect[dst] == -1) {
+        expect[dst] = expect[src] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+
+  GAR_NAMESPACE::engine::BFSOptions options;
+  auto maybe_distance = GAR_NAMESPACE::engine::BFS(*engine, root, options);
+  REQUIRE(!maybe_distance.has_error());
+  REQUIRE(maybe_distance.value() == expect);
+  // only top-down steps, and then only bottom-up steps
+  options.alpha = 0;
+  REQUIRE(GAR_NAMESPACE::engine::BFS(*engine, root, options).value() ==
+          expect);
+  options.alpha = 1e9;
+  options.beta = 1e9;
+  REQUIRE(GAR_NAMESPACE::engine::BFS(*engine, root, options).value() ==
+          expect);
+
+  REQUIRE(GAR_NAMESPACE::engine::BFS(*engine, vertex_num)
+              .status()
+              .IsOutOfRange());
+}
+
+TEST_CASE("test_neighbors") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  auto vertex_num =
+      GAR_NAMESPACE::ConstructVerticesCollection(graph_info, src_label)
+          .value()
+          .size();
+
+  // check the neighbors of each vertex, return if some of them span chunks
+  auto check = [&](auto& edges, bool by_source) {
+    // the neighbors collected from the edges
+    std::vector<std::vector<GAR_NAMESPACE::IdType>> expected(vertex_num);
+    auto status =
+        edges.ForEachChunk([&](const GAR_NAMESPACE::AdjListSpan& span) {
+          for (int64_t i = 0; i < span.size; ++i) {
+            if (by_source) {
+              expected[span.src[i]].push_back(span.dst[i]);
+            } else {
+              expected[span.dst[i]].push_back(span.src[i]);
+            }
+          }
+          return GAR_NAMESPACE::Status::OK();
+        });
+    REQUIRE(status.ok());
+
+    bool spans_chunks = false;
+    std::vector<GAR_NAMESPACE::IdType> vids;
+    for (size_t vid = 0; vid < vertex_num; ++vid) {
+      auto maybe_list = edges.Neighbors(vid);
+      REQUIRE(!maybe_list.has_error());
+      const auto& list = maybe_list.value();
+      REQUIRE(list.size() == static_cast<int64_t>(expected[vid].size()));
+      std::vector<GAR_NAMESPACE::IdType> ids(list.begin(), list.end());
+      REQUIRE(ids == expected[vid]);
+      if (!list.empty()) {
+        REQUIRE(list[list.size() - 1] == expected[vid].back());
+      }
+      spans_chunks = spans_chunks || list.slices().size() > 1;
+      if (vid % 3 == 0) {
+        vids.push_back(vid);
+      }
+    }
+
+    // the batch queries
+    auto maybe_lists = edges.Neighbors(vids);
+    REQUIRE(!maybe_lists.has_error());
+    REQUIRE(maybe_lists.value().size() == vids.size());
+    for (size_t i = 0; i < vids.size(); ++i) {
+      const auto& list = maybe_lists.value()[i];
+      REQUIRE(std::vector<GAR_NAMESPACE::IdType>(list.begin(), list.end()) ==
+              expected[vids[i]]);
+    }
+    REQUIRE(edges.Neighbors(vertex_num + 100).status().IsKeyError());
+    return spans_chunks;
+  };
+
+  auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_source);
+  REQUIRE(!expect.has_error());
+  check(std::get<GAR_NAMESPACE::EdgesCollection<
+            GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value()),
+        true);
+  auto expect2 = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_dest);
+  REQUIRE(!expect2.has_error());
+  check(std::get<GAR_NAMESPACE::EdgesCollection<
+            GAR_NAMESPACE::AdjListType::ordered_by_dest>>(expect2.value()),
+        false);
+
+  // the neighbors span the chunks of a small chunk size
+  std::ifstream fp(TEST_DATA_DIR +
+                   "/ldbc_sample/parquet/person_knows_person.edge.yml");
+  std::string edge_meta((std::istreambuf_iterator<char>(fp)),
+                        std::istreambuf_iterator<char>());
+  edge_meta.replace(edge_meta.find("chunk_size: 1024"), 16, "chunk_size: 16");
+  auto edge_info = GAR_NAMESPACE::EdgeInfo::Load(
+                       GAR_NAMESPACE::Yaml::Load(edge_meta).value())
+                       .value();
+  std::string prefix = "/tmp/neighbors/";
+  GAR_NAMESPACE::builder::EdgesBuilder builder(
+      edge_info, prefix, GAR_NAMESPACE::AdjListType::ordered_by_source,
+      vertex_num);
+  for (size_t i = 0; i < 3 * vertex_num; ++i) {
+    GAR_NAMESPACE::builder::Edge e(i % vertex_num, (i * 7) % vertex_num);
+    e.AddProperty("creationDate", std::string("2010-01-01"));
+    REQUIRE(builder.AddEdge(e).ok());
+  }
+  REQUIRE(builder.Dump().ok());
+  GAR_NAMESPACE::EdgesCollection<GAR_NAMESPACE::AdjListType::ordered_by_source>
+      edges(edge_info, prefix);
+  REQUIRE(check(edges, true));
+}
+
+TEST_CASE("test_property_projection") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+
+  // only the selected properties are read
+  std::string label = "person";
+  auto maybe_vertices = GAR_NAMESPACE::ConstructVerticesCollection(
+      graph_info, label, {"firstName"});
+  REQUIRE(!maybe_vertices.has_error());
+  auto& vertices = maybe_vertices.value();
+  auto all_vertices =
+      GAR_NAMESPACE::ConstructVerticesCollection(graph_info, label).value();
+  auto expect_it = all_vertices.begin();
+  for (auto it = vertices.begin(); it != vertices.end(); ++it, ++expect_it) {
+    REQUIRE(it.property<std::string>("firstName").value() ==
+            expect_it.property<std::string>("firstName").value());
+    REQUIRE(it.property<int64_t>("id").status().IsKeyError());
+    auto vertex = *it;
+    REQUIRE(vertex.property<std::string>("firstName").status().ok());
+    REQUIRE(vertex.property<int64_t>("id").status().IsKeyError());
+  }
+  REQUIRE(GAR_NAMESPACE::ConstructVerticesCollection(graph_info, label,
+                                                     {"not_exist"})
+              .status()
+              .IsKeyError());
+
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto maybe_edges = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_source, {"creationDate"});
+  REQUIRE(!maybe_edges.has_error());
+  auto& edges = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(maybe_edges.value());
+  auto it = edges.begin();
+  REQUIRE(it.property<std::string>("creationDate").status().ok());
+  REQUIRE(GAR_NAMESPACE::ConstructEdgesCollection(
+              graph_info, src_label, edge_label, dst_label,
+              GAR_NAMESPACE::AdjListType::ordered_by_source, {"not_exist"})
+              .status()
+              .IsKeyError());
+}
+
+TEST_CASE("test_property_handle") {
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+
+  std::string label = "person";
+  auto vertices =
+      GAR_NAMESPACE::ConstructVerticesCollection(graph_info, label).value();
+  auto id = vertices.GetPropertyHandle<int64_t>("id").value();
+  auto first_name =
+      vertices.GetPropertyHandle<std::string>("firstName").value();
+  for (auto it = vertices.begin(); it != vertices.end(); ++it) {
+    REQUIRE(it.get(id).value() == it.property<int64_t>("id").value());
+    REQUIRE(it.get(first_name).value() ==
+            it.property<std::string>("firstName").value());
+  }
+  // random access through the handles
+  auto it = vertices.find(vertices.size() - 1);
+  REQUIRE(it.get(id).value() == it.property<int64_t>("id").value());
+  it = vertices.find(0);
+  REQUIRE(it.get(id).value() == it.property<int64_t>("id").value());
+  REQUIRE(vertices.GetPropertyHandle<double>("id").status().IsTypeError());
+  REQUIRE(vertices.GetPropertyHandle<int64_t>("not_exist")
+              .status()
+              .IsKeyError());
+
+  // the handles are resolved against the projection of the collection
+  auto projected = GAR_NAMESPACE::ConstructVerticesCollection(
+                       graph_info, label, {"lastName"})
+                       .value();
+  auto last_name =
+      projected.GetPropertyHandle<std::string>("lastName").value();
+  auto expect_it = vertices.begin();
+  for (auto it = projected.begin(); it != projected.end(); ++it, ++expect_it) {
+    REQUIRE(it.get(last_name).value() ==
+            expect_it.property<std::string>("lastName").value());
+  }
+  REQUIRE(projected.GetPropertyHandle<int64_t>("id").status().IsKeyError());
+
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto maybe_edges = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_source);
+  REQUIRE(!maybe_edges.has_error());
+  auto& edges = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(maybe_edges.value());
+  auto creation_date =
+      edges.GetPropertyHandle<std::string>("creationDate").value();
+  auto end = edges.end();
+  for (auto it = edges.begin(); it != end; ++it) {
+    REQUIRE(it.get(creation_date).value() ==
+            it.property<std::string>("creationDate").value());
+  }
+  // the assigned iterator reads through the cursors of the source
+  auto it = edges.begin();
+  auto assigned = edges.begin();
+  REQUIRE(assigned.get(creation_date).has_value());
+  ++it;
+  assigned = it;
+  REQUIRE(assigned.get(creation_date).value() ==
+          it.property<std::string>("creationDate").value());
+}
+
+TEST_CASE("test_edges_filter") {
+  namespace cp = arrow::compute;
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  std::string src_label = "person", edge_label = "knows", dst_label = "person";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  auto expect = GAR_NAMESPACE::ConstructEdgesCollection(
+      graph_info, src_label, edge_label, dst_label,
+      GAR_NAMESPACE::AdjListType::ordered_by_source);
+  REQUIRE(!expect.has_error());
+  auto& edges = std::get<GAR_NAMESPACE::EdgesCollection<
+      GAR_NAMESPACE::AdjListType::ordered_by_source>>(expect.value());
+
+  // the expected results by iterating the edges
+  std::vector<std::string> dates;
+  for (auto it = edges.begin(); it != edges.end(); ++it) {
+    dates.push_back(it.property<std::string>("creationDate").value());
+  }
+  auto sorted_dates = dates;
+  std::sort(sorted_dates.begin(), sorted_dates.end());
+  std::string from = sorted_dates[sorted_dates.size() / 4];
+  std::string to = sorted_dates[sorted_dates.size() / 2];
+  std::vector<std::pair<GAR_NAMESPACE::IdType, GAR_NAMESPACE::IdType>>
+      expected_edges;
+  std::vector<std::string> expected_dates;
+  size_t i = 0;
+  for (auto it = edges.begin(); it != edges.end(); ++it, ++i) {
+    if (dates[i] >= from && dates[i] < to) {
+      expected_edges.emplace_back(it.source(), it.destination());
+      expected_dates.push_back(dates[i]);
+    }
+  }
+
+  // a time window on the creation date, with projection
+  auto window = cp::and_(
+      cp::greater_equal(cp::field_ref("creationDate"), cp::literal(from)),
+      cp::less(cp::field_ref("creationDate"), cp::literal(to)));
+  auto maybe_table = edges.Filter(window, {"creationDate"});
+  REQUIRE(maybe_table.status().ok());
+  auto table = maybe_table.value()->CombineChunks().ValueOrDie();
+  REQUIRE(table->num_rows() == static_cast<int64_t>(expected_edges.size()));
+  REQUIRE(table->num_columns() == 3);
+  REQUIRE(table->schema()->field(0)->name() ==
+          GAR_NAMESPACE::GeneralParams::kSrcIndexCol);
+  REQUIRE(table->schema()->field(1)->name() ==
+          GAR_NAMESPACE::GeneralParams::kDstIndexCol);
+  auto src =
+      std::static_pointer_cast<arrow::Int64Array>(table->column(0)->chunk(0));
+  auto dst =
+      std::static_pointer_cast<arrow::Int64Array>(table->column(1)->chunk(0));
+  auto date =
+      std::static_pointer_cast<arrow::StringArray>(table->column(2)->chunk(0));
+  for (int64_t j = 0; j < table->num_rows(); ++j) {
+    REQUIRE(src->Value(j) == expected_edges[j].first);
+    REQUIRE(dst->Value(j) == expected_edges[j].second);
+    REQUIRE(date->GetString(j) == expected_dates[j]);
+  }
+
+  // constant and invalid filters
+  maybe_table = edges.Filter(cp::literal(true));
+  REQUIRE(maybe_table.status().ok());
+  REQUIRE(maybe_table.value()->num_rows() ==
+          static_cast<int64_t>(dates.size()));
+  REQUIRE(maybe_table.value()->num_columns() == 2);
+  maybe_table = edges.Filter(cp::literal(false), {"creationDate"});
+  REQUIRE(maybe_table.status().ok());
+  REQUIRE(maybe_table.value()->num_rows() == 0);
+  REQUIRE(edges.Filter(cp::field_ref("creationDate")).has_error());
+  REQUIRE(edges.Filter(cp::equal(cp::field_ref("not_exist"), cp::literal(0)))
+              .has_error());
+}
+
+TEST_CASE("test_vertices_filter") {
+  namespace cp = arrow::compute;
+  std::string path =
+      TEST_DATA_DIR + "/ldbc_sample/parquet/ldbc_sample.graph.yml";
+  auto graph_info = GAR_NAMESPACE::GraphInfo::Load(path).value();
+  std::string label = "person";
+  auto vertices =
+      GAR_NAMESPACE::ConstructVerticesCollection(graph_info, label).value();
+
+  // the expected results by iterating the vertices
+  int64_t mid_id = vertices.begin().property<int64_t>("id").value();
+  std::vector<GAR_NAMESPACE::IdType> expected_ids, expected_female_ids;
+  std::vector<std::string> expected_names;
+  for (auto it = vertices.begin(); it != vertices.end(); ++it) {
+    if (it.id() == static_cast<GAR_NAMESPACE::IdType>(vertices.size() / 2)) {
+      mid_id = it.property<int64_t>("id").value();
+    }
+  }
+  for (auto it = vertices.begin(); it != vertices.end(); ++it) {
+    if (it.property<int64_t>("id").value() > mid_id) {
+      expected_ids.push_back(it.id());
+      expected_names.push_back(it.property<std::string>("firstName").value());
+      if (it.property<std::string>("gender").value() == "female") {
+        expected_female_ids.push_back(it.id());
+      }
+    }
+  }
+
+  // the filter on a single property group, with projection
+  auto maybe_table = vertices.Filter(
+      cp::greater(cp::field_ref("id"), cp::literal(mid_id)), {"firstName"});
+  REQUIRE(maybe_table.status().ok());
+  auto table = maybe_table.value();
+  REQUIRE(table->num_rows() == static_cast<int64_t>(expected_ids.size()));
+  REQUIRE(table->num_columns() == 2);
+  REQUIRE(table->schema()->field(0)->name() ==
+          GAR_NAMESPACE::GeneralParams::kVertexIndexCol);
+  table = table->CombineChunks().ValueOrDie();
+  auto ids =
+      std::static_pointer_cast<arrow::Int64Array>(table->column(0)->chunk(0));
+  auto names =
+      std::static_pointer_cast<arrow::StringArray>(table->column(1)->chunk(0));
+  for (int64_t i = 0; i < table->num_rows(); ++i) {
+    REQUIRE(ids->Value(i) == expected_ids[i]);
+    REQUIRE(names->GetString(i) == expected_names[i]);
+  }
+
+  // the filter on multiple property groups
+  maybe_table = vertices.Filter(
+      cp::and_(cp::greater(cp::field_ref("id"), cp::literal(mid_id)),
+               cp::equal(cp::field_ref("gender"), cp::literal("female"))));
+  REQUIRE(maybe_table.status().ok());
+  table = maybe_table.value()->CombineChunks().ValueOrDie();
+  REQUIRE(table->num_rows() ==
+          static_cast<int64_t>(expected_female_ids.size()));
+  REQUIRE(table->num_columns() == 1);
+  ids = std::static_pointer_cast<arrow::Int64Array>(table->column(0)->chunk(0));
+  for (int64_t i = 0; i < table->num_rows(); ++i) {
+    REQUIRE(ids->Value(i) == expected_female_ids[i]);
+  }
+
+  // constant and invalid filters
+  maybe_table = vertices.Filter(cp::literal(false), {"id"});
+  REQUIRE(maybe_table.status().ok());
+  REQUIRE(maybe_table.value()->num_rows() == 0);
+  REQUIRE(maybe_table.value()->num_columns() == 2);
+  REQUIRE(vertices.Filter(cp::field_ref("id")).has_error());
+  REQUIRE(vertices.Filter(cp::greater(cp::field_ref("not_exist"),
+                                      cp::literal(0)))
+              .has_error());
+  REQUIRE(vertices.Filter(cp::literal(true), {"not_exist"}).has_error());
+
+  // the row groups whose statistics do not match are not read
+  auto vertex_info = graph_info.GetVertexInfo(label).value();
+  auto group = graph_info.GetVertexPropertyGroup(label, "id").value();
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < 100; ++i) {
+    REQUIRE(builder.Append(i).ok());
+  }
+  auto id_table =
+      arrow::Table::Make(arrow::schema({arrow::field("id", arrow::int64())}),
+                         {builder.Finish().ValueOrDie()});
+  std::string prefix = "/tmp/gar_filter_test/";
+  GAR_NAMESPACE::VertexPropertyWriter writer(vertex_info, prefix);
+  writer.SetRowGroupSize(10);
+  REQUIRE(writer.WriteChunk(id_table, group, 0).ok());
+  std::string out_prefix;
+  auto fs = GAR_NAMESPACE::FileSystemFromUriOrPath(prefix, &out_prefix).value();
+  auto filter =
+      cp::and_(cp::greater_equal(cp::field_ref("id"), cp::literal(int64_t(35))),
+               cp::less(cp::field_ref("id"), cp::literal(int64_t(52))))
+          .Bind(*id_table->schema())
+          .ValueOrDie();
+  auto pieces = fs->ReadFileToTablesWithFilter(
+                      out_prefix + vertex_info.GetFilePath(group, 0).value(),
+                      GAR_NAMESPACE::FileType::PARQUET, filter)
+                    .value();
+  REQUIRE(pieces.size() == 1);
+  REQUIRE(pieces[0].first == 30);
+  REQUIRE(pieces[0].second->num_rows() == 30);
+}
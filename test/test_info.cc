@@ -18,6 +18,9 @@ limitations under the License.
 #include <filesystem>
 #include <iostream>
 
+#include "arrow/api.h"
+#include "arrow/util/compression.h"
+
 #include "./config.h"
 
 #include "gar/graph_info.h"
@@ -288,6 +291,96 @@ TEST_CASE("test_edge_info") {
   // TODO(@acezen): test is validated
 }
 
+TEST_CASE("test_writer_options") {
+  GAR_NAMESPACE::InfoVersion version(1);
+  GAR_NAMESPACE::Property p;
+  p.name = "id";
+  p.type = GAR_NAMESPACE::DataType(GAR_NAMESPACE::Type::INT64);
+  p.is_primary = true;
+  GAR_NAMESPACE::WriterOptions hot;
+  hot.compression = "uncompressed";
+  hot.row_group_size = 1024;
+  hot.statistics = true;
+  GAR_NAMESPACE::WriterOptions cold;
+  cold.compression = "zstd";
+  cold.compression_level = 19;
+  cold.dictionary = false;
+  cold.page_size = 1 << 20;
+  cold.page_index = false;
+  REQUIRE(GAR_NAMESPACE::WriterOptions().Empty());
+  REQUIRE(!hot.Empty());
+
+  // vertex info
+  GAR_NAMESPACE::VertexInfo v_info("person", 100, version);
+  GAR_NAMESPACE::PropertyGroup pg({p}, GAR_NAMESPACE::FileType::PARQUET, "",
+                                  hot);
+  REQUIRE(pg.GetWriterOptions() == hot);
+  REQUIRE(v_info.AddPropertyGroup(pg).ok());
+  auto v_dump = v_info.Dump();
+  REQUIRE(!v_dump.has_error());
+  auto v_yaml = GAR_NAMESPACE::Yaml::Load(v_dump.value()).value();
+  auto maybe_v_info = GAR_NAMESPACE::VertexInfo::Load(v_yaml);
+  REQUIRE(!maybe_v_info.has_error());
+  const auto& loaded_pg = maybe_v_info.value().GetPropertyGroup("id").value();
+  REQUIRE(loaded_pg.GetWriterOptions() == hot);
+  REQUIRE(!(loaded_pg == GAR_NAMESPACE::PropertyGroup(
+                             {p}, GAR_NAMESPACE::FileType::PARQUET, "", cold)));
+
+  // the options that Arrow can not write are rejected at loading
+  GAR_NAMESPACE::WriterOptions unavailable;
+  unavailable.compression = "lz4";  // not built into the bundled Arrow
+  if (!arrow::util::Codec::IsAvailable(arrow::Compression::LZ4_FRAME)) {
+    REQUIRE(unavailable.Validate().IsInvalid());
+    GAR_NAMESPACE::VertexInfo lz4_info("person", 100, version);
+    REQUIRE(lz4_info
+                .AddPropertyGroup(GAR_NAMESPACE::PropertyGroup(
+                    {p}, GAR_NAMESPACE::FileType::PARQUET, "", unavailable))
+                .ok());
+    auto lz4_yaml =
+        GAR_NAMESPACE::Yaml::Load(lz4_info.Dump().value()).value();
+    REQUIRE(GAR_NAMESPACE::VertexInfo::Load(lz4_yaml).status().IsInvalid());
+  }
+  GAR_NAMESPACE::WriterOptions unknown;
+  unknown.compression = "unknown";
+  REQUIRE(unknown.Validate().IsInvalid());
+  GAR_NAMESPACE::WriterOptions page_index;
+  page_index.page_index = true;
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 12000000
+  REQUIRE(page_index.Validate().ok());
+#else
+  REQUIRE(page_index.Validate().IsInvalid());
+#endif
+
+  // edge info
+  GAR_NAMESPACE::EdgeInfo edge_info("person", "knows", "person", 1024, 100,
+                                    100, true, version);
+  REQUIRE(edge_info
+              .AddAdjList(GAR_NAMESPACE::AdjListType::ordered_by_source,
+                          GAR_NAMESPACE::FileType::PARQUET, "", cold)
+              .ok());
+  REQUIRE(edge_info
+              .AddAdjList(GAR_NAMESPACE::AdjListType::ordered_by_dest,
+                          GAR_NAMESPACE::FileType::PARQUET)
+              .ok());
+  REQUIRE(edge_info
+              .GetWriterOptions(GAR_NAMESPACE::AdjListType::unordered_by_source)
+              .status()
+              .IsKeyError());
+  auto e_dump = edge_info.Dump();
+  REQUIRE(!e_dump.has_error());
+  auto e_yaml = GAR_NAMESPACE::Yaml::Load(e_dump.value()).value();
+  auto maybe_edge_info = GAR_NAMESPACE::EdgeInfo::Load(e_yaml);
+  REQUIRE(!maybe_edge_info.has_error());
+  const auto& loaded_edge_info = maybe_edge_info.value();
+  REQUIRE(loaded_edge_info
+              .GetWriterOptions(GAR_NAMESPACE::AdjListType::ordered_by_source)
+              .value() == cold);
+  REQUIRE(loaded_edge_info
+              .GetWriterOptions(GAR_NAMESPACE::AdjListType::ordered_by_dest)
+              .value()
+              .Empty());
+}
+
 TEST_CASE("test_info_version") {
   GAR_NAMESPACE::InfoVersion info_version(1);
   REQUIRE(info_version.version() == 1);